@@ -0,0 +1,139 @@
+// Copyright (c) 2021, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+import 'dart:collection';
+import 'dart:convert';
+
+import 'package:args/args.dart';
+import 'package:cronet/cronet.dart';
+
+import 'hdr_histogram.dart';
+import 'test_servers/loopback_server.dart';
+
+/// Latency of the callbacks of requests, from when the wrapper posts one to
+/// when the Dart side handles it, for a [CallbackBackend].
+///
+/// Measured with [RequestTrace], pairing the `post` and `dart-handled` events
+/// of each request in order. Requests run in batches small enough for the
+/// trace buffers to hold all of their events.
+class CallbackLatencyBenchmark {
+  final Uri url;
+  final CallbackBackend backend;
+  final int concurrency;
+  final Duration duration;
+
+  /// Latencies in nanoseconds.
+  final latency = HdrHistogram();
+  int callbacks = 0;
+  int requests = 0;
+
+  CallbackLatencyBenchmark(
+      this.url, this.backend, this.concurrency, this.duration);
+
+  Future<void> _fetch(HttpClient client) async {
+    final request = await client.getUrl(url);
+    final response = await request.close();
+    await for (final _ in response) {}
+  }
+
+  void _record(String trace) {
+    final events = ((jsonDecode(trace) as Map<String, dynamic>)['traceEvents']
+            as List<dynamic>)
+        .cast<Map<String, dynamic>>();
+    final posted = <String, Queue<num>>{};
+    for (final event in events) {
+      final id = event['id'] as String;
+      final ts = event['ts'] as num;
+      if (event['name'] == 'post') {
+        posted.putIfAbsent(id, () => Queue<num>()).add(ts);
+      } else if (event['name'] == 'dart-handled') {
+        final queue = posted[id];
+        // Posted before the trace was cleared.
+        if (queue == null || queue.isEmpty) continue;
+        latency.record(((ts - queue.removeFirst()) * 1000).round());
+        callbacks++;
+      }
+    }
+  }
+
+  Future<void> measure() async {
+    final client = HttpClient();
+    final previous = callbackBackend;
+    callbackBackend = backend;
+    // Warmup. Not measured.
+    await _fetch(client);
+    final clock = Stopwatch()..start();
+    while (clock.elapsed < duration) {
+      RequestTrace.clear();
+      RequestTrace.enabled = true;
+      await Future.wait([for (var i = 0; i < concurrency; i++) _fetch(client)]);
+      RequestTrace.enabled = false;
+      requests += concurrency;
+      _record(RequestTrace.export());
+    }
+    callbackBackend = previous;
+    client.close();
+  }
+
+  static String _microseconds(int nanoseconds) =>
+      (nanoseconds / 1000).toStringAsFixed(1);
+
+  Future<void> report() async {
+    await measure();
+    final values = [
+      for (final percentile in const [50.0, 90.0, 99.0, 99.9])
+        latency.valueAtPercentile(percentile),
+      latency.max,
+    ];
+    print('$runtimeType(url: $url, backend: $backend,'
+        ' concurrency: $concurrency, requests: $requests,'
+        ' callbacks: $callbacks)');
+    print('| Callback latency (us) | p50 | p90 | p99 | p99.9 | max |');
+    print('| :-------------------- | --: | --: | --: | ----: | --: |');
+    print('| ${backend.toString().split('.').last} |'
+        ' ${values.map(_microseconds).join(' | ')} |');
+  }
+}
+
+void main(List<String> args) async {
+  final parser = ArgParser();
+  parser
+    ..addOption('url',
+        abbr: 'u',
+        help: 'The server to ping for running this benchmark, which must serve'
+            ' a body of the length given by the size query parameter. Defaults'
+            ' to a loopback server started by the benchmark.')
+    ..addOption('size',
+        abbr: 's',
+        help: 'Response body size, in bytes.',
+        defaultsTo: '262144')
+    ..addOption('concurrency',
+        abbr: 'c',
+        help: 'Requests per batch.',
+        defaultsTo: '8')
+    ..addOption('time',
+        abbr: 't',
+        help: 'Second(s) to send requests for, per backend.',
+        defaultsTo: '5')
+    ..addFlag('help',
+        abbr: 'h', negatable: false, help: 'Print this usage information.');
+  final arguments = parser.parse(args);
+  if (arguments.wasParsed('help')) {
+    print(parser.usage);
+    return;
+  }
+  final server = arguments['url'] == null ? await LoopbackServer.start() : null;
+  final base = server?.url ?? Uri.parse(arguments['url'] as String);
+  final url = base.replace(queryParameters: {
+    ...base.queryParameters,
+    'size': arguments['size'] as String,
+  });
+  final concurrency = int.parse(arguments['concurrency'] as String);
+  final duration = Duration(seconds: int.parse(arguments['time'] as String));
+  for (final backend in CallbackBackend.values) {
+    await CallbackLatencyBenchmark(url, backend, concurrency, duration)
+        .report();
+  }
+  await server?.close();
+}
@@ -0,0 +1,108 @@
+// Copyright (c) 2021, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+import 'dart:io' as io;
+
+import 'package:args/args.dart';
+import 'package:cronet/cronet.dart';
+
+// Downloads a large object into a file, streaming the response into the file
+// from Dart, then with HttpClient.download using a growing number of ranges.
+abstract class DownloadBenchmark {
+  final String url;
+  final String path;
+  final int runs;
+
+  DownloadBenchmark(this.url, this.path, this.runs);
+
+  Future<int> run(HttpClient client);
+
+  // Average throughput over [runs] downloads, in MB/s.
+  Future<double> measure() async {
+    final client = HttpClient();
+    // Warmup. Not measured.
+    await run(client);
+    var bytes = 0;
+    final watch = Stopwatch()..start();
+    for (var i = 0; i < runs; i++) {
+      bytes += await run(client);
+    }
+    watch.stop();
+    client.close();
+    return bytes / watch.elapsedMicroseconds;
+  }
+
+  Future<void> report() async {
+    final throughput = await measure();
+    print('$this: ${throughput.toStringAsFixed(1)} MB/s');
+  }
+}
+
+class StreamedDownloadBenchmark extends DownloadBenchmark {
+  StreamedDownloadBenchmark(String url, String path, int runs)
+      : super(url, path, runs);
+
+  @override
+  Future<int> run(HttpClient client) async {
+    final request = await client.getUrl(Uri.parse(url));
+    final response = await request.close();
+    final sink = io.File(path).openWrite();
+    await sink.addStream(response);
+    await sink.close();
+    return io.File(path).lengthSync();
+  }
+
+  @override
+  String toString() => 'Single stream';
+}
+
+class RangedDownloadBenchmark extends DownloadBenchmark {
+  final int parallelism;
+
+  RangedDownloadBenchmark(String url, String path, int runs, this.parallelism)
+      : super(url, path, runs);
+
+  @override
+  Future<int> run(HttpClient client) async {
+    final result =
+        await client.download(Uri.parse(url), path, parallelism: parallelism);
+    return result.length;
+  }
+
+  @override
+  String toString() => 'Ranges: $parallelism';
+}
+
+void main(List<String> args) async {
+  final parser = ArgParser();
+  parser
+    ..addOption('url',
+        abbr: 'u',
+        help: 'Large object served with byte ranges to download.',
+        mandatory: true)
+    ..addOption('limit',
+        abbr: 'l',
+        help: 'Downloads with 1, 2, 4... up to 2^N ranges where N is provided '
+            'through this option.',
+        defaultsTo: '4')
+    ..addOption('runs',
+        abbr: 'r', help: 'Downloads measured per mode.', defaultsTo: '3')
+    ..addFlag('help',
+        abbr: 'h', negatable: false, help: 'Print this usage information.');
+  final arguments = parser.parse(args);
+  if (arguments.wasParsed('help')) {
+    print(parser.usage);
+    return;
+  }
+  final url = arguments['url'] as String;
+  final limit = 1 << int.parse(arguments['limit'] as String);
+  final runs = int.parse(arguments['runs'] as String);
+  final directory = io.Directory.systemTemp.createTempSync('download');
+  final path = '${directory.path}/object';
+  await StreamedDownloadBenchmark(url, path, runs).report();
+  for (var parallelism = 1; parallelism <= limit; parallelism *= 2) {
+    await RangedDownloadBenchmark(url, path, runs, parallelism).report();
+  }
+  directory.deleteSync(recursive: true);
+}
@@ -0,0 +1,71 @@
+// Copyright (c) 2021, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+import 'dart:ffi';
+
+import 'package:args/args.dart';
+import 'package:cronet/src/globals.dart';
+
+/// Cost of a call to a hot-path Cronet function through the generated
+/// bindings and through the leaf calls of `LeafBindings`.
+class FfiCallBenchmark {
+  final String name;
+  final void Function() call;
+  final int iterations;
+
+  FfiCallBenchmark(this.name, this.call, this.iterations);
+
+  double measure() {
+    // Warmup, also resolves the symbols of the generated bindings.
+    for (var i = 0; i < iterations ~/ 10; i++) {
+      call();
+    }
+    final clock = Stopwatch()..start();
+    for (var i = 0; i < iterations; i++) {
+      call();
+    }
+    return clock.elapsedMicroseconds * 1000 / iterations;
+  }
+
+  void report() {
+    print('| $name | ${measure().toStringAsFixed(1)} |');
+  }
+}
+
+void main(List<String> args) {
+  final parser = ArgParser();
+  parser
+    ..addOption('iterations',
+        abbr: 'n', help: 'Calls per function.', defaultsTo: '10000000')
+    ..addFlag('help',
+        abbr: 'h', negatable: false, help: 'Print this usage information.');
+  final arguments = parser.parse(args);
+  if (arguments.wasParsed('help')) {
+    print(parser.usage);
+    return;
+  }
+  final iterations = int.parse(arguments['iterations'] as String);
+  final buffer = cronet.Cronet_Buffer_Create();
+  cronet.Cronet_Buffer_InitWithAlloc(buffer, 32 * 1024);
+  var sink = 0;
+  final benchmarks = [
+    FfiCallBenchmark('Cronet_Buffer_GetSize',
+        () => sink += cronet.Cronet_Buffer_GetSize(buffer), iterations),
+    FfiCallBenchmark('Cronet_Buffer_GetSize leaf',
+        () => sink += leaf.bufferGetSize(buffer), iterations),
+    FfiCallBenchmark('Cronet_Buffer_GetData',
+        () => sink += cronet.Cronet_Buffer_GetData(buffer).address, iterations),
+    FfiCallBenchmark('Cronet_Buffer_GetData leaf',
+        () => sink += leaf.bufferGetData(buffer).address, iterations),
+  ];
+  print('FfiCallBenchmark(iterations: $iterations)');
+  print('| Call | ns/call |');
+  print('| :--- | ------: |');
+  for (final benchmark in benchmarks) {
+    benchmark.report();
+  }
+  cronet.Cronet_Buffer_Destroy(buffer);
+  // Keeps the calls from being optimized away.
+  if (sink == 0) print(sink);
+}
@@ -0,0 +1,142 @@
+// Copyright (c) 2021, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+import 'dart:typed_data';
+
+/// High dynamic range histogram of non-negative integers, such as latencies
+/// in microseconds.
+///
+/// Values are counted in buckets that keep [significantDigits] decimal digits
+/// of precision across the whole range up to [highestTrackableValue], with a
+/// fixed amount of memory and O(1) recording. The layout is the one of
+/// HdrHistogram: each bucket covers twice the range of the previous one with
+/// the same number of sub-buckets.
+class HdrHistogram {
+  /// Largest value that can be recorded. Larger ones are recorded as this.
+  final int highestTrackableValue;
+
+  /// Decimal digits of precision of the recorded values, from 1 to 5.
+  final int significantDigits;
+
+  late final int _subBucketHalfCountMagnitude;
+  late final int _subBucketHalfCount;
+  late final int _subBucketMask;
+  late final Int64List _counts;
+
+  int _count = 0;
+  int _min = 0;
+  int _max = 0;
+  int _sum = 0;
+
+  HdrHistogram(
+      {this.highestTrackableValue = 3600 * 1000 * 1000,
+      this.significantDigits = 3}) {
+    if (significantDigits < 1 || significantDigits > 5) {
+      throw RangeError.range(significantDigits, 1, 5, 'significantDigits');
+    }
+    var largestSingleUnitValue = 2;
+    for (var i = 0; i < significantDigits; i++) {
+      largestSingleUnitValue *= 10;
+    }
+    // Sub-buckets must resolve every unit up to 2 * 10^digits.
+    final subBucketCountMagnitude = (largestSingleUnitValue - 1).bitLength;
+    _subBucketHalfCountMagnitude = subBucketCountMagnitude - 1;
+    final subBucketCount = 1 << subBucketCountMagnitude;
+    _subBucketHalfCount = subBucketCount >> 1;
+    _subBucketMask = subBucketCount - 1;
+    var bucketCount = 1;
+    var smallestUntrackableValue = subBucketCount;
+    while (smallestUntrackableValue <= highestTrackableValue) {
+      smallestUntrackableValue <<= 1;
+      bucketCount++;
+    }
+    _counts = Int64List((bucketCount + 1) * _subBucketHalfCount);
+  }
+
+  /// Number of recorded values.
+  int get count => _count;
+
+  /// Smallest recorded value, 0 if none.
+  int get min => _min;
+
+  /// Largest recorded value, 0 if none.
+  int get max => _max;
+
+  /// Mean of the recorded values, 0 if none.
+  double get mean => _count == 0 ? 0 : _sum / _count;
+
+  /// Records [value], clamped to the trackable range.
+  void record(int value) {
+    if (value < 0) value = 0;
+    if (value > highestTrackableValue) value = highestTrackableValue;
+    _counts[_indexOf(value)]++;
+    if (_count == 0 || value < _min) _min = value;
+    if (value > _max) _max = value;
+    _count++;
+    _sum += value;
+  }
+
+  /// Adds the values recorded in [other], which must have the same layout.
+  void add(HdrHistogram other) {
+    if (other._counts.length != _counts.length ||
+        other.significantDigits != significantDigits) {
+      throw ArgumentError.value(other, 'other', 'Different layout');
+    }
+    if (other._count == 0) return;
+    for (var i = 0; i < _counts.length; i++) {
+      _counts[i] += other._counts[i];
+    }
+    if (_count == 0 || other._min < _min) _min = other._min;
+    if (other._max > _max) _max = other._max;
+    _count += other._count;
+    _sum += other._sum;
+  }
+
+  /// Smallest value that [percentile] percent of the recorded values are at
+  /// or below, within the precision of the histogram. 0 if none.
+  int valueAtPercentile(double percentile) {
+    if (_count == 0) return 0;
+    if (percentile >= 100) return _max;
+    var target = (percentile / 100 * _count).ceil();
+    if (target < 1) target = 1;
+    var seen = 0;
+    for (var i = 0; i < _counts.length; i++) {
+      seen += _counts[i];
+      if (seen >= target) {
+        final value = _highestEquivalentValue(i);
+        return value > _max ? _max : value;
+      }
+    }
+    return _max;
+  }
+
+  /// Forgets every recorded value.
+  void reset() {
+    _counts.fillRange(0, _counts.length, 0);
+    _count = 0;
+    _min = 0;
+    _max = 0;
+    _sum = 0;
+  }
+
+  int _indexOf(int value) {
+    final bucketIndex =
+        (value | _subBucketMask).bitLength - (_subBucketHalfCountMagnitude + 1);
+    final subBucketIndex = value >> bucketIndex;
+    return ((bucketIndex + 1) << _subBucketHalfCountMagnitude) +
+        (subBucketIndex - _subBucketHalfCount);
+  }
+
+  // Largest value counted in the slot at [index].
+  int _highestEquivalentValue(int index) {
+    var bucketIndex = (index >> _subBucketHalfCountMagnitude) - 1;
+    var subBucketIndex =
+        (index & (_subBucketHalfCount - 1)) + _subBucketHalfCount;
+    if (bucketIndex < 0) {
+      subBucketIndex -= _subBucketHalfCount;
+      bucketIndex = 0;
+    }
+    return (subBucketIndex << bucketIndex) + (1 << bucketIndex) - 1;
+  }
+}
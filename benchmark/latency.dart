@@ -7,6 +7,9 @@ import 'dart:io' as io;
 import 'package:args/args.dart';
 import 'package:cronet/cronet.dart';
 
+import 'hdr_histogram.dart';
+import 'test_servers/loopback_server.dart';
+
 abstract class LatencyBenchmark {
   final String url;
 
@@ -119,13 +122,191 @@ class CronetLatencyBenchmark extends LatencyBenchmark {
   }
 }
 
+/// Latency of requests issued at a constant rate, whether or not the earlier
+/// ones completed.
+///
+/// Each of [senders] starts [rate] requests per second on a fixed schedule.
+/// Latencies are measured from when a request was due rather than from when
+/// it was actually sent, so that a stalled client doesn't hide the requests
+/// it failed to send in time (coordinated omission). They are split into the
+/// time to the response headers and the time to read the body.
+abstract class OpenLoopLatencyBenchmark {
+  final Uri url;
+  final int rate;
+  final int senders;
+  final Duration duration;
+
+  /// Latencies in microseconds: in full, to the response headers and for
+  /// reading the body.
+  final total = HdrHistogram();
+  final ttfb = HdrHistogram();
+  final body = HdrHistogram();
+  int errors = 0;
+
+  OpenLoopLatencyBenchmark(this.url, this.rate, this.senders, this.duration);
+
+  /// Sends a request to [url] and returns its response once the headers are
+  /// in.
+  Future<Stream<List<int>>> open(Uri url);
+  void setup();
+  void teardown();
+
+  Future<void> _fetch(Stopwatch clock, int due, {bool record = true}) async {
+    try {
+      final response = await open(url);
+      final headers = clock.elapsedMicroseconds;
+      await for (final _ in response) {}
+      final done = clock.elapsedMicroseconds;
+      if (!record) return;
+      ttfb.record(headers - due);
+      body.record(done - headers);
+      total.record(done - due);
+    } catch (e) {
+      errors++;
+    }
+  }
+
+  Future<void> measure() async {
+    setup();
+    // Warmup. Not measured.
+    final clock = Stopwatch()..start();
+    await _fetch(clock, 0, record: false);
+    final interval = 1000000 ~/ rate;
+    final requests = duration.inMicroseconds ~/ interval;
+    final pending = <Future<void>>[];
+    Future<void> send(int offset) async {
+      for (var i = 0; i < requests; i++) {
+        final due = i * interval + offset;
+        final wait = due - clock.elapsedMicroseconds;
+        if (wait > 0) await Future<void>.delayed(Duration(microseconds: wait));
+        pending.add(_fetch(clock, due));
+      }
+    }
+
+    clock.reset();
+    // The senders are spread evenly over the interval.
+    await Future.wait(
+        [for (var i = 0; i < senders; i++) send(interval * i ~/ senders)]);
+    await Future.wait(pending);
+    teardown();
+  }
+
+  static String _milliseconds(int microseconds) =>
+      (microseconds / 1000).toStringAsFixed(3);
+
+  static String _row(String name, HdrHistogram histogram) {
+    final values = [
+      for (final percentile in const [50.0, 90.0, 99.0, 99.9])
+        histogram.valueAtPercentile(percentile),
+      histogram.max,
+    ];
+    return '| $name | ${values.map(_milliseconds).join(' | ')} |';
+  }
+
+  Future<void> report() async {
+    await measure();
+    print('$runtimeType(url: $url, senders: $senders, rate: $rate/s each,'
+        ' requests: ${total.count}, errors: $errors)');
+    print('| Latency (ms) | p50 | p90 | p99 | p99.9 | max |');
+    print('| :----------- | --: | --: | --: | ----: | --: |');
+    print(_row('Total', total));
+    print(_row('TTFB', ttfb));
+    print(_row('Body', body));
+  }
+}
+
+class DartIOOpenLoopLatencyBenchmark extends OpenLoopLatencyBenchmark {
+  late io.HttpClient client;
+
+  DartIOOpenLoopLatencyBenchmark(
+      Uri url, int rate, int senders, Duration duration)
+      : super(url, rate, senders, duration);
+
+  @override
+  Future<Stream<List<int>>> open(Uri url) async {
+    final request = await client.getUrl(url);
+    return await request.close();
+  }
+
+  @override
+  void setup() {
+    client = io.HttpClient();
+  }
+
+  @override
+  void teardown() {
+    client.close();
+  }
+}
+
+class CronetOpenLoopLatencyBenchmark extends OpenLoopLatencyBenchmark {
+  late HttpClient client;
+
+  CronetOpenLoopLatencyBenchmark(
+      Uri url, int rate, int senders, Duration duration)
+      : super(url, rate, senders, duration);
+
+  @override
+  Future<Stream<List<int>>> open(Uri url) async {
+    final request = await client.getUrl(url);
+    return await request.close();
+  }
+
+  @override
+  void setup() {
+    client = HttpClient();
+  }
+
+  @override
+  void teardown() {
+    client.close();
+  }
+}
+
+List<int> _intList(String option) =>
+    option.split(',').map((value) => int.parse(value.trim())).toList();
+
+/// Runs the open-loop benchmarks for every combination of [sizes] and
+/// [concurrency], asking for body sizes with the `size` query parameter of
+/// the loopback server.
+Future<void> runOpenLoop(String url, int rate, List<int> concurrency,
+    List<int> sizes, Duration duration) async {
+  final base = Uri.parse(url);
+  for (final size in sizes) {
+    final sized = base.replace(
+        queryParameters: {...base.queryParameters, 'size': '$size'});
+    for (final senders in concurrency) {
+      await CronetOpenLoopLatencyBenchmark(sized, rate, senders, duration)
+          .report();
+      await DartIOOpenLoopLatencyBenchmark(sized, rate, senders, duration)
+          .report();
+    }
+  }
+}
+
 void main(List<String> args) async {
   final parser = ArgParser();
   parser
     ..addOption('url',
         abbr: 'u',
-        help: 'The server to ping for running this benchmark.',
-        defaultsTo: 'https://example.com')
+        help: 'The server to ping for running this benchmark. Defaults to a'
+            ' loopback server started by the benchmark.')
+    ..addOption('rate',
+        abbr: 'r',
+        help: 'Runs in open-loop mode instead, each sender starting this many'
+            ' requests per second, and reports latency percentiles.')
+    ..addOption('concurrency',
+        abbr: 'c',
+        help: 'Comma separated numbers of senders in open-loop mode.',
+        defaultsTo: '1,8,32')
+    ..addOption('sizes',
+        abbr: 's',
+        help: 'Comma separated response body sizes in open-loop mode.',
+        defaultsTo: '11,16384,1048576')
+    ..addOption('time',
+        abbr: 't',
+        help: 'Second(s) to send requests for, per open-loop run.',
+        defaultsTo: '5')
     ..addFlag('help',
         abbr: 'h', negatable: false, help: 'Print this usage information.');
   final arguments = parser.parse(args);
@@ -137,10 +318,26 @@ void main(List<String> args) async {
     print(parser.usage);
     throw ArgumentError();
   }
-  final url = arguments['url'] as String;
+  // Runs against a loopback server unless told otherwise, so that it needs no
+  // setup.
+  final server = arguments['url'] == null ? await LoopbackServer.start() : null;
+  final url = arguments['url'] as String? ?? server!.url.toString();
+  if (arguments['rate'] != null) {
+    final rate = int.parse(arguments['rate'] as String);
+    if (rate <= 0) throw ArgumentError.value(rate, 'rate');
+    await runOpenLoop(
+        url,
+        rate,
+        _intList(arguments['concurrency'] as String),
+        _intList(arguments['sizes'] as String),
+        Duration(seconds: int.parse(arguments['time'] as String)));
+    await server?.close();
+    return;
+  }
   // TODO: https://github.com/google/cronet.dart/issues/11
   await CronetLatencyBenchmark.main(url);
   // Used as an delemeter while parsing output in run_all script.
   print('*****');
   await DartIOLatencyBenchmark.main(url);
+  await server?.close();
 }
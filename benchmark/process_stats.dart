@@ -0,0 +1,62 @@
+// Copyright (c) 2021, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+import 'dart:io' as io;
+
+/// Resource usage of the current process. Read from procfs, so only known in
+/// full on Linux and Android.
+class ProcessStats {
+  /// User and system CPU time used so far, or null if unknown.
+  final Duration? cpuTime;
+
+  /// Largest resident set size since the start of the process or the last
+  /// [resetPeakRss], in bytes.
+  final int peakRss;
+
+  /// Threads of the process, native ones included, or null if unknown.
+  final int? threads;
+
+  const ProcessStats(this.cpuTime, this.peakRss, this.threads);
+
+  // Clock ticks per second of the CPU times in /proc/self/stat. USER_HZ is
+  // 100 on every architecture Linux runs Dart on.
+  static const _ticksPerSecond = 100;
+
+  static ProcessStats read() {
+    Duration? cpuTime;
+    int? peakRss;
+    int? threads;
+    try {
+      // Fields after the command name, which may contain spaces. utime and
+      // stime are the 14th and 15th fields, the 12th and 13th after it.
+      final stat = io.File('/proc/self/stat').readAsStringSync();
+      final fields = stat.substring(stat.lastIndexOf(')') + 2).split(' ');
+      final ticks = int.parse(fields[11]) + int.parse(fields[12]);
+      cpuTime = Duration(microseconds: ticks * 1000000 ~/ _ticksPerSecond);
+      for (final line in io.File('/proc/self/status').readAsLinesSync()) {
+        if (line.startsWith('VmHWM:')) {
+          peakRss = _kilobytes(line) * 1024;
+        } else if (line.startsWith('Threads:')) {
+          threads = int.parse(line.substring('Threads:'.length).trim());
+        }
+      }
+    } on io.FileSystemException {
+      // No procfs.
+    }
+    return ProcessStats(cpuTime, peakRss ?? io.ProcessInfo.maxRss, threads);
+  }
+
+  /// Starts tracking the peak resident set size over from the current one,
+  /// where the kernel allows it.
+  static void resetPeakRss() {
+    try {
+      io.File('/proc/self/clear_refs').writeAsStringSync('5');
+    } on io.FileSystemException {
+      // Not supported, the peak is then the one of the whole process.
+    }
+  }
+
+  static int _kilobytes(String line) =>
+      int.parse(line.substring(line.indexOf(':') + 1).trim().split(' ').first);
+}
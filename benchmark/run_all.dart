@@ -9,6 +9,7 @@ import 'dart:math';
 import 'package:args/args.dart';
 
 import 'latency.dart';
+import 'test_servers/loopback_server.dart';
 import 'throughput.dart';
 
 List<int> throughputParserHelper(String aotThroughputStdout) {
@@ -30,8 +31,8 @@ void main(List<String> args) async {
   parser
     ..addOption('url',
         abbr: 'u',
-        help: 'The server to ping for running this benchmark.',
-        defaultsTo: 'https://example.com')
+        help: 'The server to ping for running this benchmark. Defaults to a'
+            ' loopback server started by the benchmark.')
     ..addOption('limit',
         abbr: 'l',
         help: 'Limits the maximum number of parallel requests to 2^N where N'
@@ -41,6 +42,16 @@ void main(List<String> args) async {
         abbr: 't',
         help: 'Maximum second(s) the benchmark should wait for each request.',
         defaultsTo: '1')
+    ..addOption('json',
+        help: 'Also runs the AOT throughput matrix and writes its results to'
+            ' this file, for use as a baseline.')
+    ..addOption('baseline',
+        help: 'Also runs the AOT throughput matrix and flags regressions'
+            ' against these results of an earlier --json run.')
+    ..addOption('tolerance',
+        help: 'Percentage by which a metric of the matrix may get worse than'
+            ' the --baseline.',
+        defaultsTo: '10')
     ..addFlag('help',
         abbr: 'h', negatable: false, help: 'Print this usage information.');
   final arguments = parser.parse(args);
@@ -52,7 +63,10 @@ void main(List<String> args) async {
     print(parser.usage);
     throw ArgumentError();
   }
-  final url = arguments['url'] as String;
+  // Runs against a loopback server unless told otherwise, so that it needs no
+  // setup.
+  final server = arguments['url'] == null ? await LoopbackServer.start() : null;
+  final url = arguments['url'] as String? ?? server!.url.toString();
   final throughputPrallelLimit = int.parse(arguments['limit'] as String);
   final duration = Duration(seconds: int.parse(arguments['time'] as String));
 
@@ -127,4 +141,30 @@ void main(List<String> args) async {
   print('| AOT  | ${aotCronetThroughput[1]} (Parallel Requests: '
       ' ${aotCronetThroughput[0]})| ${aotDartIOThroughput[1]}'
       ' (Parallel Requests: ${aotDartIOThroughput[0]})|');
+
+  final json = arguments['json'] as String?;
+  final baseline = arguments['baseline'] as String?;
+  if (json != null || baseline != null) {
+    print('\nThroughput Matrix against: $url');
+    // In a process of its own, so that CPU time, RSS and threads are those
+    // of the matrix alone.
+    final matrixProc = await Process.start('benchmark/throughput.exe', [
+      '-u',
+      url,
+      '--matrix',
+      '-t',
+      duration.inSeconds.toString(),
+      if (json != null) ...['--json', json],
+      if (baseline != null) ...[
+        '--baseline',
+        baseline,
+        '--tolerance',
+        arguments['tolerance'] as String
+      ],
+    ]);
+    stderr.addStream(matrixProc.stderr);
+    await stdout.addStream(matrixProc.stdout);
+    exitCode = await matrixProc.exitCode;
+  }
+  await server?.close();
 }
@@ -0,0 +1,156 @@
+// Copyright (c) 2021, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+import 'dart:async';
+import 'dart:io' as io;
+import 'dart:isolate';
+import 'dart:typed_data';
+
+import 'package:args/args.dart';
+
+/// HTTP/1.1 server on the loopback interface, for running the benchmarks
+/// without any external setup or network.
+///
+/// The server runs in its own isolate, so serving doesn't compete with the
+/// client being measured for the event loop. Every path is served, the
+/// response is shaped by query parameters:
+///
+/// * `size`: length of the body in bytes, 11 by default.
+/// * `delay`: milliseconds to wait before the response starts.
+/// * `chunk`: sends the body with chunked transfer encoding, in chunks of
+///   this many bytes, instead of with a `Content-Length`.
+/// * `interval`: milliseconds to wait between two chunks.
+///
+/// For example `/?size=1048576&chunk=16384` serves 1 MiB in 64 chunks.
+class LoopbackServer {
+  /// URL of the root of the server.
+  final Uri url;
+
+  final Isolate _isolate;
+  final SendPort _control;
+
+  LoopbackServer._(this.url, this._isolate, this._control);
+
+  /// Starts a server on an ephemeral port, or on [port] if given.
+  static Future<LoopbackServer> start({int port = 0}) async {
+    final started = ReceivePort();
+    final isolate = await Isolate.spawn(_serve, [started.sendPort, port]);
+    final reply = await started.first as List<Object?>;
+    return LoopbackServer._(
+        Uri(scheme: 'http', host: '127.0.0.1', port: reply[0] as int),
+        isolate,
+        reply[1] as SendPort);
+  }
+
+  /// URL of a response shaped by the given parameters, see [LoopbackServer].
+  Uri shape({int? size, Duration? delay, int? chunk, Duration? interval}) =>
+      url.replace(queryParameters: {
+        if (size != null) 'size': '$size',
+        if (delay != null) 'delay': '${delay.inMilliseconds}',
+        if (chunk != null) 'chunk': '$chunk',
+        if (interval != null) 'interval': '${interval.inMilliseconds}',
+      });
+
+  /// Stops the server.
+  Future<void> close() async {
+    final stopped = ReceivePort();
+    _isolate.addOnExitListener(stopped.sendPort);
+    _control.send(null);
+    await stopped.first;
+    stopped.close();
+  }
+}
+
+// Bodies by size, filled with the same text so that responses compress the
+// way real pages do. Larger bodies are sent as repeated slices of a payload
+// of at most [_maxPayload] bytes.
+final _payloads = <int, Uint8List>{};
+const _maxPayload = 1 << 20;
+
+Uint8List _payload(int size) => _payloads.putIfAbsent(size, () {
+      const text = 'hello world';
+      final payload = Uint8List(size);
+      for (var i = 0; i < size; i++) {
+        payload[i] = text.codeUnitAt(i % text.length);
+      }
+      return payload;
+    });
+
+// A body of [size] bytes in slices of at most [slice] bytes.
+Iterable<Uint8List> _slices(int size, int slice) sync* {
+  final payload = _payload(slice < size ? slice : size);
+  for (var offset = 0; offset < size; offset += slice) {
+    final length = size - offset < slice ? size - offset : slice;
+    yield Uint8List.sublistView(payload, 0, length);
+  }
+}
+
+int? _intParameter(io.HttpRequest request, String name) {
+  final value = request.uri.queryParameters[name];
+  return value == null ? null : int.tryParse(value);
+}
+
+Future<void> _respond(io.HttpRequest request) async {
+  final size = _intParameter(request, 'size') ?? 11;
+  final delay = _intParameter(request, 'delay') ?? 0;
+  final chunk = _intParameter(request, 'chunk');
+  final interval = _intParameter(request, 'interval') ?? 0;
+  // The request body, if any, is drained before answering.
+  await request.drain<void>();
+  if (delay > 0) await Future<void>.delayed(Duration(milliseconds: delay));
+  final response = request.response;
+  if (chunk == null || chunk <= 0) {
+    response.contentLength = size;
+    await response.addStream(Stream.fromIterable(_slices(size, _maxPayload)));
+  } else {
+    // Every add goes out as a chunk of its own.
+    response.bufferOutput = false;
+    var first = true;
+    for (final slice in _slices(size, chunk)) {
+      if (!first && interval > 0) {
+        await Future<void>.delayed(Duration(milliseconds: interval));
+      }
+      first = false;
+      response.add(slice);
+      await response.flush();
+    }
+  }
+  await response.close();
+}
+
+Future<void> _serve(List<Object> args) async {
+  final started = args[0] as SendPort;
+  final server =
+      await io.HttpServer.bind(io.InternetAddress.loopbackIPv4, args[1] as int);
+  final control = ReceivePort();
+  control.listen((_) async {
+    control.close();
+    await server.close(force: true);
+  });
+  server.listen((request) {
+    _respond(request).catchError((Object _) {
+      // The client went away.
+    });
+  });
+  started.send([server.port, control.sendPort]);
+}
+
+void main(List<String> args) async {
+  final parser = ArgParser();
+  parser
+    ..addOption('port',
+        abbr: 'p', help: 'Port to listen on.', defaultsTo: '8080')
+    ..addFlag('help',
+        abbr: 'h', negatable: false, help: 'Print this usage information.');
+  final arguments = parser.parse(args);
+  if (arguments.wasParsed('help')) {
+    print(parser.usage);
+    return;
+  }
+  final server =
+      await LoopbackServer.start(port: int.parse(arguments['port'] as String));
+  print('Serving at ${server.url}');
+  await io.ProcessSignal.sigint.watch().first;
+  await server.close();
+}
@@ -9,6 +9,9 @@ import 'dart:math';
 import 'package:args/args.dart';
 import 'package:cronet/cronet.dart';
 
+import 'test_servers/loopback_server.dart';
+import 'throughput_matrix.dart';
+
 abstract class ThroughputBenchmark {
   final String url;
   final int parallelLimit;
@@ -167,8 +170,8 @@ void main(List<String> args) async {
   parser
     ..addOption('url',
         abbr: 'u',
-        help: 'The server to ping for running this benchmark.',
-        defaultsTo: 'https://example.com')
+        help: 'The server to ping for running this benchmark. Defaults to a'
+            ' loopback server started by the benchmark.')
     ..addOption('limit',
         abbr: 'l',
         help: 'Limits the maximum number of parallel requests to 2^N where N'
@@ -178,6 +181,29 @@ void main(List<String> args) async {
         abbr: 't',
         help: 'Maximum second(s) the benchmark should wait for each request.',
         defaultsTo: '1')
+    ..addFlag('matrix',
+        abbr: 'm',
+        negatable: false,
+        help: 'Measures every combination of --protocols, --sizes and'
+            ' --concurrency instead, for --time second(s) each.')
+    ..addOption('protocols',
+        help: 'Comma separated protocols of the matrix, out of h1, h2 and'
+            ' quic. h2 and quic need a --url served over TLS.',
+        defaultsTo: 'h1')
+    ..addOption('sizes',
+        help: 'Comma separated response body sizes of the matrix.',
+        defaultsTo: '1024,65536,1048576,67108864,1073741824')
+    ..addOption('concurrency',
+        help: 'Comma separated numbers of parallel requests of the matrix.',
+        defaultsTo: '1,8,64')
+    ..addOption('json',
+        help: 'File to write the results of the matrix to, as JSON.')
+    ..addOption('baseline',
+        help: 'JSON results of an earlier matrix run to flag regressions'
+            ' against.')
+    ..addOption('tolerance',
+        help: 'Percentage by which a metric may get worse than the baseline.',
+        defaultsTo: '10')
     ..addFlag('help',
         abbr: 'h', negatable: false, help: 'Print this usage information.');
   final arguments = parser.parse(args);
@@ -189,13 +215,36 @@ void main(List<String> args) async {
     print(parser.usage);
     throw ArgumentError();
   }
-  final url = arguments['url'] as String;
+  // Runs against a loopback server unless told otherwise, so that it needs no
+  // setup.
+  final server = arguments['url'] == null ? await LoopbackServer.start() : null;
+  final url = arguments['url'] as String? ?? server!.url.toString();
   final spawnThreshold =
       pow(2, int.parse(arguments['limit'] as String)).toInt();
   final duration = Duration(seconds: int.parse(arguments['time'] as String));
+  if (arguments['matrix'] as bool) {
+    List<int> ints(String option) => (arguments[option] as String)
+        .split(',')
+        .map((value) => int.parse(value.trim()))
+        .toList();
+    final matrix = ThroughputMatrix(
+        Uri.parse(url),
+        (arguments['protocols'] as String).split(','),
+        ints('sizes'),
+        ints('concurrency'),
+        duration);
+    await matrix.run();
+    saveAndCompare(matrix,
+        path: arguments['json'] as String?,
+        baselinePath: arguments['baseline'] as String?,
+        tolerance: double.parse(arguments['tolerance'] as String));
+    await server?.close();
+    return;
+  }
   // TODO: https://github.com/google/cronet.dart/issues/11
   await CronetThroughputBenchmark.main(url, spawnThreshold, duration);
   // Used as an delemeter while parsing output in run_all script.
   print('*****');
   await DartIOThroughputBenchmark.main(url, spawnThreshold, duration);
+  await server?.close();
 }
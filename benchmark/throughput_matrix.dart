@@ -0,0 +1,289 @@
+// Copyright (c) 2021, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+import 'dart:convert';
+import 'dart:io' as io;
+
+import 'package:cronet/cronet.dart';
+
+import 'process_stats.dart';
+
+/// Protocols of the matrix, by the name they are given on the command line.
+const protocols = {
+  'h1': HttpProtocol.http,
+  'h2': HttpProtocol.http2,
+  'quic': HttpProtocol.quic,
+};
+
+/// Version of the JSON written by [ThroughputMatrix.toJson].
+const _formatVersion = 1;
+
+/// Result of one cell of a [ThroughputMatrix].
+class ThroughputResult {
+  final String client;
+  final String protocol;
+  final int size;
+  final int concurrency;
+
+  /// Body bytes received during the run.
+  final int bytes;
+
+  /// Requests completed during the run.
+  final int requests;
+  final int errors;
+  final Duration elapsed;
+
+  /// CPU time of the whole process during the run, null if unknown.
+  final Duration? cpuTime;
+  final int peakRss;
+
+  /// Threads of the process at the end of the run, null if unknown.
+  final int? threads;
+
+  ThroughputResult(
+      this.client,
+      this.protocol,
+      this.size,
+      this.concurrency,
+      this.bytes,
+      this.requests,
+      this.errors,
+      this.elapsed,
+      this.cpuTime,
+      this.peakRss,
+      this.threads);
+
+  String get key => '$client/$protocol/$size/$concurrency';
+
+  double get megabytesPerSecond =>
+      bytes / 1e6 / (elapsed.inMicroseconds / 1e6);
+
+  double get requestsPerSecond => requests / (elapsed.inMicroseconds / 1e6);
+
+  Map<String, Object?> toJson() => {
+        'client': client,
+        'protocol': protocol,
+        'size': size,
+        'concurrency': concurrency,
+        'bytes': bytes,
+        'requests': requests,
+        'errors': errors,
+        'elapsed_ms': elapsed.inMilliseconds,
+        'megabytes_per_second': megabytesPerSecond,
+        'requests_per_second': requestsPerSecond,
+        'cpu_ms': cpuTime?.inMilliseconds,
+        'peak_rss_bytes': peakRss,
+        'threads': threads,
+      };
+
+  @override
+  String toString() => '$key: ${megabytesPerSecond.toStringAsFixed(1)} MB/s,'
+      ' ${requestsPerSecond.toStringAsFixed(1)} requests/s,'
+      ' cpu: ${cpuTime?.inMilliseconds ?? '-'} ms,'
+      ' peak rss: ${(peakRss / (1 << 20)).toStringAsFixed(1)} MiB,'
+      ' threads: ${threads ?? '-'}, errors: $errors';
+}
+
+/// Measures throughput for every combination of client, protocol, body size
+/// and concurrency against [url], which must serve a body of the length given
+/// by its `size` query parameter, as the loopback server does.
+///
+/// Each run keeps [concurrency] requests in flight for [duration], counting
+/// the body bytes and the requests that arrive in that time. dart:io only
+/// takes part for HTTP/1.1.
+class ThroughputMatrix {
+  final Uri url;
+  final List<String> protocolNames;
+  final List<int> sizes;
+  final List<int> concurrency;
+  final Duration duration;
+  final results = <ThroughputResult>[];
+
+  ThroughputMatrix(this.url, this.protocolNames, this.sizes, this.concurrency,
+      this.duration) {
+    for (final protocol in protocolNames) {
+      if (!protocols.containsKey(protocol)) {
+        throw ArgumentError.value(protocol, 'protocol');
+      }
+    }
+  }
+
+  Future<void> run() async {
+    for (final protocol in protocolNames) {
+      for (final size in sizes) {
+        for (final level in concurrency) {
+          results.add(await _runCronet(protocol, size, level));
+          print(results.last);
+          if (protocol == 'h1') {
+            results.add(await _runDartIO(size, level));
+            print(results.last);
+          }
+        }
+      }
+    }
+  }
+
+  Uri _sized(int size) =>
+      url.replace(queryParameters: {...url.queryParameters, 'size': '$size'});
+
+  Future<ThroughputResult> _runCronet(
+      String protocol, int size, int level) async {
+    final client = HttpClient(
+        protocol: protocols[protocol]!,
+        quicHints: protocol == 'quic'
+            ? [QuicHint(url.host, url.port, url.port)]
+            : const []);
+    try {
+      return await _measure('cronet', protocol, size, level, (url) async {
+        final request = await client.getUrl(url);
+        return await request.close();
+      });
+    } finally {
+      client.close();
+    }
+  }
+
+  Future<ThroughputResult> _runDartIO(int size, int level) async {
+    final client = io.HttpClient();
+    try {
+      return await _measure('dart:io', 'h1', size, level, (url) async {
+        final request = await client.getUrl(url);
+        return await request.close();
+      });
+    } finally {
+      client.close(force: true);
+    }
+  }
+
+  Future<ThroughputResult> _measure(String client, String protocol, int size,
+      int level, Future<Stream<List<int>>> Function(Uri) open) async {
+    final sized = _sized(size);
+    // Warmup. Not measured.
+    await for (final _ in await open(_sized(1))) {}
+    var bytes = 0;
+    var requests = 0;
+    var errors = 0;
+    final clock = Stopwatch();
+    bool inTime() => clock.elapsed < duration;
+    Future<void> worker() async {
+      while (inTime()) {
+        try {
+          final response = await open(sized);
+          var complete = true;
+          await for (final chunk in response) {
+            if (!inTime()) {
+              // Cancels the request.
+              complete = false;
+              break;
+            }
+            bytes += chunk.length;
+          }
+          if (complete && inTime()) requests++;
+        } catch (_) {
+          if (inTime()) errors++;
+        }
+      }
+    }
+
+    ProcessStats.resetPeakRss();
+    final before = ProcessStats.read();
+    clock.start();
+    final workers = [for (var i = 0; i < level; i++) worker()];
+    await Future<void>.delayed(duration);
+    final elapsed = clock.elapsed;
+    // Sampled while the requests are still running, for the threads.
+    final after = ProcessStats.read();
+    await Future.wait(workers);
+    final cpuTime = before.cpuTime == null || after.cpuTime == null
+        ? null
+        : after.cpuTime! - before.cpuTime!;
+    return ThroughputResult(client, protocol, size, level, bytes, requests,
+        errors, elapsed, cpuTime, after.peakRss, after.threads);
+  }
+
+  Map<String, Object?> toJson() => {
+        'version': _formatVersion,
+        'url': url.toString(),
+        'duration_ms': duration.inMilliseconds,
+        'results': [for (final result in results) result.toJson()],
+      };
+}
+
+/// Compares the results of [current] with those of [baseline], both as
+/// written by [ThroughputMatrix.toJson], and returns a description of each
+/// metric that got worse by more than [tolerance] percent.
+///
+/// Throughput regresses when it drops, CPU time per request and peak RSS
+/// when they grow. Cells missing from either side are skipped.
+List<String> findRegressions(
+    Map<String, Object?> baseline, Map<String, Object?> current,
+    {double tolerance = 10}) {
+  if (baseline['version'] != _formatVersion) {
+    throw FormatException('Unsupported baseline version', baseline['version']);
+  }
+  Map<String, Map<String, Object?>> byKey(Map<String, Object?> json) => {
+        for (final result in (json['results'] as List<Object?>)
+            .cast<Map<String, Object?>>())
+          '${result['client']}/${result['protocol']}/${result['size']}/'
+              '${result['concurrency']}': result,
+      };
+  final before = byKey(baseline);
+  final after = byKey(current);
+  final regressions = <String>[];
+  void check(String key, String metric, num? was, num? now,
+      {required bool higherIsBetter}) {
+    if (was == null || now == null || was == 0) return;
+    final change = (now - was) / was * 100;
+    final worse = higherIsBetter ? -change : change;
+    if (worse > tolerance) {
+      regressions.add('$key $metric: ${was.toStringAsFixed(2)} ->'
+          ' ${now.toStringAsFixed(2)} (${change.toStringAsFixed(1)}%)');
+    }
+  }
+
+  num? cpuPerRequest(Map<String, Object?> result) {
+    final cpu = result['cpu_ms'] as num?;
+    final requests = result['requests'] as num;
+    return cpu == null || requests == 0 ? null : cpu / requests;
+  }
+
+  for (final key in before.keys) {
+    final was = before[key]!;
+    final now = after[key];
+    if (now == null) continue;
+    check(key, 'MB/s', was['megabytes_per_second'] as num?,
+        now['megabytes_per_second'] as num?,
+        higherIsBetter: true);
+    check(key, 'requests/s', was['requests_per_second'] as num?,
+        now['requests_per_second'] as num?,
+        higherIsBetter: true);
+    check(key, 'CPU ms/request', cpuPerRequest(was), cpuPerRequest(now),
+        higherIsBetter: false);
+    check(key, 'peak RSS', was['peak_rss_bytes'] as num?,
+        now['peak_rss_bytes'] as num?,
+        higherIsBetter: false);
+  }
+  return regressions;
+}
+
+/// Writes [matrix] as JSON to [path], and compares it against the baseline
+/// at [baselinePath] if given. Sets a failing exit code on regressions.
+void saveAndCompare(ThroughputMatrix matrix,
+    {String? path, String? baselinePath, double tolerance = 10}) {
+  final json = matrix.toJson();
+  final encoded = const JsonEncoder.withIndent('  ').convert(json);
+  if (path != null) io.File(path).writeAsStringSync('$encoded\n');
+  if (baselinePath == null) return;
+  final baseline = jsonDecode(io.File(baselinePath).readAsStringSync())
+      as Map<String, Object?>;
+  final regressions = findRegressions(baseline, json, tolerance: tolerance);
+  if (regressions.isEmpty) {
+    print('No regressions against $baselinePath'
+        ' (tolerance: $tolerance%).');
+    return;
+  }
+  print('Regressions against $baselinePath (tolerance: $tolerance%):');
+  regressions.forEach(print);
+  io.exitCode = 1;
+}
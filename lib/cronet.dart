@@ -2,10 +2,21 @@
 // for details. All rights reserved. Use of this source code is governed by a
 // BSD-style license that can be found in the LICENSE file.
 
+export 'src/admission_queue.dart' hide AdmissionQueue;
+export 'src/callback_backend.dart';
 export 'src/enums.dart';
 export 'src/exceptions.dart';
+export 'src/hedging.dart' hide ResponseLatencies;
 export 'src/http_client.dart';
 export 'src/http_client_request.dart' hide HttpClientRequestImpl;
 export 'src/http_client_response.dart' hide HttpClientResponseImpl;
 export 'src/http_headers.dart' hide HttpHeadersImpl;
+export 'src/live_request.dart';
+export 'src/multipart.dart';
+export 'src/native_memory.dart';
 export 'src/quic_hint.dart';
+export 'src/range_download.dart' hide RangeDownload;
+export 'src/redirect_policy.dart';
+export 'src/request_trace.dart';
+export 'src/retry_policy.dart';
+export 'src/transfer_progress.dart';
@@ -0,0 +1,165 @@
+// Copyright (c) 2021, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+import 'dart:collection';
+
+import 'enums.dart';
+
+/// Snapshot of the admission queue of an [HttpClient].
+class AdmissionStats {
+  /// Requests running.
+  final int running;
+
+  /// Requests waiting for a slot.
+  final int queued;
+
+  /// Requests admitted so far, whether they had to wait or not, including the
+  /// duplicates sent for hedging.
+  final int admitted;
+
+  /// Requests admitted after waiting in the queue.
+  final int waited;
+
+  /// Average time queued requests waited for their slot.
+  final Duration averageWait;
+
+  /// Longest time a queued request waited for its slot.
+  final Duration maxWait;
+
+  const AdmissionStats(this.running, this.queued, this.admitted, this.waited,
+      this.averageWait, this.maxWait);
+
+  @override
+  String toString() => 'AdmissionStats(running: $running, queued: $queued, '
+      'admitted: $admitted, waited: $waited, averageWait: $averageWait, '
+      'maxWait: $maxWait)';
+}
+
+class _Waiter {
+  final Object key;
+  final String host;
+  final int priority;
+  final int sequence;
+  final void Function() onAdmitted;
+  final stopwatch = Stopwatch()..start();
+
+  _Waiter(this.key, this.host, this.priority, this.sequence, this.onAdmitted);
+}
+
+/// Limits the requests of an [HttpClient] running at once, in total and per
+/// host. Requests beyond the limits wait in a queue until a slot is released.
+///
+/// This is not a part of public api.
+class AdmissionQueue {
+  /// Requests allowed to run at once, or null for no limit.
+  final int? maxConcurrent;
+
+  /// Requests allowed to run at once per host, or null for no limit.
+  final int? maxConcurrentPerHost;
+
+  final AdmissionOrder order;
+
+  var _running = 0;
+  final _runningPerHost = <String, int>{};
+  // Waiting requests, by host, in the order they are admitted in.
+  final _queues = <String, SplayTreeSet<_Waiter>>{};
+  final _waiters = <Object, _Waiter>{};
+  var _sequence = 0;
+
+  var _admitted = 0;
+  var _waited = 0;
+  var _totalWait = Duration.zero;
+  var _maxWait = Duration.zero;
+
+  AdmissionQueue(this.maxConcurrent, this.maxConcurrentPerHost, this.order);
+
+  int _compare(_Waiter a, _Waiter b) {
+    if (order == AdmissionOrder.priority && a.priority != b.priority) {
+      return b.priority - a.priority;
+    }
+    return a.sequence - b.sequence;
+  }
+
+  bool _hasSlot(String host) =>
+      (maxConcurrent == null || _running < maxConcurrent!) &&
+      (maxConcurrentPerHost == null ||
+          (_runningPerHost[host] ?? 0) < maxConcurrentPerHost!);
+
+  /// Whether a request to [host] would be admitted right away.
+  bool hasFreeSlot(String host) => _queues[host] == null && _hasSlot(host);
+
+  /// Takes a slot for a request to [host], which must be free. See
+  /// [hasFreeSlot].
+  void take(String host) => _take(host);
+
+  void _take(String host) {
+    _running++;
+    _runningPerHost[host] = (_runningPerHost[host] ?? 0) + 1;
+    _admitted++;
+  }
+
+  /// Takes a slot for a request to [host] and returns true if one is free.
+  /// Otherwise queues the request as [key] and returns false, [onAdmitted] is
+  /// then called once a slot has been taken for it.
+  ///
+  /// [priority] is the index of the [RequestPriority] of the request.
+  bool admit(
+      Object key, String host, int priority, void Function() onAdmitted) {
+    // Requests don't overtake the ones already waiting for the same host.
+    if (hasFreeSlot(host)) {
+      _take(host);
+      return true;
+    }
+    final waiter = _Waiter(key, host, priority, _sequence++, onAdmitted);
+    _queues.putIfAbsent(host, () => SplayTreeSet(_compare)).add(waiter);
+    _waiters[key] = waiter;
+    return false;
+  }
+
+  /// Drops the request queued as [key]. Returns false if it isn't queued.
+  bool remove(Object key) {
+    final waiter = _waiters.remove(key);
+    if (waiter == null) return false;
+    final queue = _queues[waiter.host]!..remove(waiter);
+    if (queue.isEmpty) _queues.remove(waiter.host);
+    return true;
+  }
+
+  /// Releases the slot taken by a request to [host] and admits the requests
+  /// that fit in the freed slots.
+  void release(String host) {
+    _running--;
+    final running = _runningPerHost[host]! - 1;
+    if (running == 0) {
+      _runningPerHost.remove(host);
+    } else {
+      _runningPerHost[host] = running;
+    }
+    while (true) {
+      // First waiter of the hosts with a free slot.
+      _Waiter? next;
+      for (final entry in _queues.entries) {
+        if (!_hasSlot(entry.key)) continue;
+        final first = entry.value.first;
+        if (next == null || _compare(first, next) < 0) next = first;
+      }
+      if (next == null) return;
+      remove(next.key);
+      _take(next.host);
+      final wait = next.stopwatch.elapsed;
+      _waited++;
+      _totalWait += wait;
+      if (wait > _maxWait) _maxWait = wait;
+      next.onAdmitted();
+    }
+  }
+
+  AdmissionStats get stats => AdmissionStats(
+      _running,
+      _waiters.length,
+      _admitted,
+      _waited,
+      _waited == 0 ? Duration.zero : _totalWait ~/ _waited,
+      _maxWait);
+}
@@ -0,0 +1,32 @@
+// Copyright (c) 2021, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+import 'globals.dart';
+
+/// How the wrapper posts the callbacks of requests to Dart.
+///
+/// Callbacks are posted to a port of each request either way, as dart:ffi
+/// has no asynchronous callbacks in the supported SDKs. See
+/// https://github.com/dart-lang/sdk/issues/37022.
+enum CallbackBackend {
+  /// A single `Uint8List` per callback, holding the id of the callback and
+  /// its arguments. It is copied into the Dart heap, without a string, an
+  /// array nor a native allocation and its finalizer. The default.
+  compact,
+
+  /// An array per callback, holding the name of the callback and its
+  /// arguments as external typed data.
+  messages,
+}
+
+CallbackBackend _callbackBackend = CallbackBackend.compact;
+
+/// The [CallbackBackend] of every request of the process. Requests already
+/// running switch over with their next callback.
+CallbackBackend get callbackBackend => _callbackBackend;
+
+set callbackBackend(CallbackBackend backend) {
+  wrapper.SetCompactCallbacks(backend == CallbackBackend.compact ? 1 : 0);
+  _callbackBackend = backend;
+}
@@ -15,7 +15,7 @@ const tag = 'binaries-v0.0.4';
 const cronetBinaryUrl =
     'https://github.com/google/cronet.dart/releases/download/$tag/';
 const cronetVersion = "86.0.4240.198";
-const wrapperVersion = "2";
+const wrapperVersion = "3";
 
 const binaryStorageDir = '.dart_tool/cronet/';
 
@@ -149,6 +149,13 @@ DynamicLibrary loadWrapper() {
 }
 
 /// Loads `cronet` dynamic library depending on the platform.
+///
+/// The `CRONET_LIBRARY` environment variable, if set, names a library to load
+/// instead, such as the fake one the benchmarks measure the wrapper with.
 DynamicLibrary loadCronet() {
+  final override = Platform.environment['CRONET_LIBRARY'];
+  if (override != null && override.isNotEmpty) {
+    return DynamicLibrary.open(override);
+  }
   return loadDylib(getCronetName());
 }
@@ -16,6 +16,96 @@ enum HttpProtocol {
   http
 }
 
+/// Priority of a request relative to the other requests of an [HttpClient].
+///
+/// The order of the values must match `Cronet_UrlRequestParams_REQUEST_PRIORITY`.
+enum RequestPriority {
+  idle,
+  lowest,
+  low,
+  medium,
+  highest,
+}
+
+/// How the response body is split before being delivered.
+///
+/// Framing happens natively, every event of the response stream is then a
+/// single, UTF-8 validated record, without its line terminators.
+enum RecordFraming {
+  /// The body is delivered in chunks as they arrive.
+  none,
+
+  /// Every non empty line is a record, as in newline delimited JSON.
+  ndjson,
+
+  /// Every event of a `text/event-stream` is a record.
+  serverSentEvents,
+}
+
+/// Order in which the requests waiting for a slot of an [HttpClient] are
+/// started.
+enum AdmissionOrder {
+  /// In the order they were closed.
+  fifo,
+
+  /// Highest [RequestPriority] first, in the order they were closed within a
+  /// priority.
+  priority,
+}
+
+/// Content encoding the request body is compressed with.
+///
+/// The order of the values must match `COMPRESSION_*` of the wrapper.
+enum UploadCompression {
+  none,
+  gzip,
+  deflate,
+  zstd,
+}
+
+/// Load state of a request, as reported by [TransferProgress] and
+/// [LiveRequest].
+///
+/// The order of the values must match
+/// `Cronet_UrlRequestStatusListener_Status`.
+enum LoadState {
+  /// The request is done or hasn't started.
+  invalid,
+  idle,
+  waitingForStalledSocketPool,
+  waitingForAvailableSocket,
+  waitingForDelegate,
+  waitingForCache,
+  downloadingPacFile,
+  resolvingProxyForUrl,
+  resolvingHostInPacFile,
+  establishingProxyTunnel,
+  resolvingHost,
+  connecting,
+  sslHandshake,
+  sendingRequest,
+  waitingForResponse,
+  readingResponse,
+}
+
+/// Network error a request failed with.
+///
+/// The order of the values must match `Cronet_Error_ERROR_CODE`.
+enum NetworkError {
+  callback,
+  hostnameNotResolved,
+  internetDisconnected,
+  networkChanged,
+  timedOut,
+  connectionClosed,
+  connectionTimedOut,
+  connectionRefused,
+  connectionReset,
+  addressUnreachable,
+  quicProtocolFailed,
+  other,
+}
+
 /// Cronet Error Enum to Error String bindings.
 ///
 /// ISSUE: https://github.com/dart-lang/ffigen/issues/236
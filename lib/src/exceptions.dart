@@ -5,6 +5,7 @@
 import 'dart:io';
 
 import 'enums.dart';
+import 'redirect_policy.dart';
 
 class LoggingException implements Exception {
   const LoggingException();
@@ -29,6 +30,37 @@ class HttpException implements IOException {
   }
 }
 
+/// A redirect was refused by the [RedirectPolicy] of a request.
+class RedirectException extends HttpException {
+  /// Redirects followed before the refused one.
+  final List<RedirectInfo> redirects;
+
+  const RedirectException(String message, this.redirects, {Uri? uri})
+      : super(message, uri: uri);
+}
+
+/// A request failed because of a network error.
+class NetworkException extends HttpException {
+  final NetworkError error;
+
+  /// Cronet's internal error code, a net error code of Chromium.
+  final int internalErrorCode;
+
+  /// Whether Cronet deems the request can be retried right away.
+  final bool immediatelyRetryable;
+
+  /// Detailed QUIC error code, or 0 if the error isn't a QUIC one.
+  final int quicErrorCode;
+
+  /// Attempts made, retries included.
+  final int attempts;
+
+  const NetworkException(String message, this.error, this.internalErrorCode,
+      this.immediatelyRetryable, this.quicErrorCode, this.attempts,
+      {Uri? uri})
+      : super(message, uri: uri);
+}
+
 /// Errors from Cronet Native Library.
 class CronetNativeError implements Error {
   final int val;
@@ -9,6 +9,7 @@ import 'package:ffi/ffi.dart';
 
 import 'constants.dart';
 import 'dylib_handler.dart';
+import 'leaf_bindings.dart';
 import 'third_party/cronet/generated_bindings.dart';
 import 'wrapper/generated_bindings.dart';
 
@@ -46,6 +47,53 @@ Wrapper loadAndInitWrapper() {
       cronet.addresses.Cronet_Executor_Destroy.cast(),
       cronet.addresses.Cronet_Runnable_Run.cast(),
       cronet.addresses.Cronet_Runnable_Destroy.cast());
+  // Registers few cronet functions that are required by the wrapper for
+  // setting up and starting requests natively.
+  // Casting because of https://github.com/dart-lang/ffigen/issues/22
+  wrapper.InitCronetRequestApi(
+      cronet.addresses.Cronet_UrlRequest_Create.cast(),
+      cronet.addresses.Cronet_UrlRequest_Destroy.cast(),
+      cronet.addresses.Cronet_UrlRequest_InitWithParams.cast(),
+      cronet.addresses.Cronet_UrlRequest_Start.cast(),
+      cronet.addresses.Cronet_UrlRequestParams_http_method_set.cast(),
+      cronet.addresses.Cronet_UrlRequestParams_priority_set.cast(),
+      cronet.addresses.Cronet_UrlRequestParams_upload_data_provider_set.cast(),
+      cronet.addresses.Cronet_UrlRequestCallback_CreateWith.cast(),
+      cronet.addresses.Cronet_UploadDataProvider_CreateWith.cast(),
+      cronet.addresses.Cronet_UploadDataProvider_SetClientContext.cast(),
+      cronet.addresses.Cronet_HttpHeader_Create.cast(),
+      cronet.addresses.Cronet_HttpHeader_Destroy.cast(),
+      cronet.addresses.Cronet_HttpHeader_name_set.cast(),
+      cronet.addresses.Cronet_HttpHeader_value_set.cast(),
+      cronet.addresses.Cronet_UrlRequestParams_request_headers_add.cast(),
+      cronet.addresses.Cronet_UrlRequestParams_Create.cast(),
+      cronet.addresses.Cronet_UrlRequestParams_Destroy.cast(),
+      cronet.addresses.Cronet_UrlRequestCallback_Destroy.cast(),
+      cronet.addresses.Cronet_UrlRequestCallback_SetClientContext.cast(),
+      cronet.addresses.Cronet_UrlRequestCallback_GetClientContext.cast(),
+      cronet.addresses.Cronet_UploadDataProvider_Destroy.cast(),
+      cronet.addresses.Cronet_Buffer_Destroy.cast(),
+      cronet.addresses.Cronet_UrlRequest_Read.cast(),
+      cronet.addresses.Cronet_UrlRequest_FollowRedirect.cast(),
+      cronet.addresses.Cronet_UrlRequest_Cancel.cast(),
+      cronet.addresses.Cronet_UrlResponseInfo_all_headers_list_size.cast(),
+      cronet.addresses.Cronet_UrlResponseInfo_all_headers_list_at.cast(),
+      cronet.addresses.Cronet_HttpHeader_name_get.cast(),
+      cronet.addresses.Cronet_HttpHeader_value_get.cast(),
+      cronet.addresses.Cronet_Buffer_GetData.cast(),
+      cronet.addresses.Cronet_Error_error_code_get.cast(),
+      cronet.addresses.Cronet_Error_internal_error_code_get.cast(),
+      cronet.addresses.Cronet_Error_immediately_retryable_get.cast(),
+      cronet.addresses.Cronet_Error_quic_detailed_error_code_get.cast(),
+      cronet.addresses.Cronet_Buffer_GetSize.cast(),
+      cronet.addresses.Cronet_UploadDataSink_OnReadSucceeded.cast(),
+      cronet.addresses.Cronet_UploadDataSink_OnReadError.cast(),
+      cronet.addresses.Cronet_UploadDataSink_OnRewindSucceeded.cast(),
+      cronet.addresses.Cronet_UrlRequest_GetStatus.cast(),
+      cronet.addresses.Cronet_UrlRequestStatusListener_CreateWith.cast(),
+      cronet.addresses.Cronet_UrlRequestStatusListener_SetClientContext.cast(),
+      cronet.addresses.Cronet_UrlRequestStatusListener_GetClientContext.cast(),
+      cronet.addresses.Cronet_UrlRequestStatusListener_Destroy.cast());
   return wrapper;
 }
 
@@ -54,3 +102,8 @@ Cronet get cronet => _cronet;
 
 final _wrapper = loadAndInitWrapper();
 Wrapper get wrapper => _wrapper;
+
+final _leaf = LeafBindings(loadCronet(), loadWrapper());
+
+/// Leaf calls of the functions on the path of every chunk and callback.
+LeafBindings get leaf => _leaf;
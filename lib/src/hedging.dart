@@ -0,0 +1,98 @@
+// Copyright (c) 2021, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+import 'dart:math' as m;
+
+/// Duplicates a slow request to cut the tail latency of its response.
+///
+/// If the response of a hedged request hasn't started after [delay], the same
+/// request is sent again. Whichever response starts first is used, the other
+/// request is cancelled. Only `GET` and `HEAD` requests without a body are
+/// hedged, and only as long as the [HedgingBudget] allows.
+class HedgingPolicy {
+  /// Time to wait for the response before sending the duplicate.
+  ///
+  /// If null, the 95th percentile of the time responses from the same origin
+  /// took to start is used instead, once enough of them have been seen.
+  final Duration? delay;
+
+  /// Delay used while too few responses have been seen to derive one.
+  final Duration initialDelay;
+
+  const HedgingPolicy(
+      {this.delay, this.initialDelay = const Duration(milliseconds: 200)});
+
+  /// Delay after which a request to [uri] is duplicated.
+  ///
+  /// This is not a part of public api.
+  Duration delayFor(Uri uri) =>
+      delay ?? ResponseLatencies.p95(uri) ?? initialDelay;
+}
+
+/// Caps the extra load hedging puts on servers, across every [HttpClient].
+///
+/// Each request using a [HedgingPolicy] earns [ratio] of a hedge, up to
+/// [burst] hedges. Sending a duplicate costs a whole one, so no more than
+/// [ratio] extra requests are sent per hedged request on average.
+class HedgingBudget {
+  /// Duplicates allowed per request using a [HedgingPolicy].
+  static double ratio = 0.1;
+
+  /// Duplicates that can be saved up for a burst of slow responses.
+  static double burst = 10;
+
+  // Starts full.
+  static double _tokens = burst;
+
+  /// Accounts for a request using a [HedgingPolicy].
+  ///
+  /// This is not a part of public api.
+  static void deposit() {
+    _tokens = m.min(_tokens + ratio, burst);
+  }
+
+  /// Takes a duplicate out of the budget. Returns false if there is none
+  /// left.
+  ///
+  /// This is not a part of public api.
+  static bool withdraw() {
+    if (_tokens < 1) return false;
+    _tokens -= 1;
+    return true;
+  }
+}
+
+/// Time recent responses took to start, by origin.
+///
+/// This is not a part of public api.
+class ResponseLatencies {
+  static const _windowSize = 256;
+  static const _minSamples = 20;
+  static final _windows = <String, List<int>>{};
+  static final _next = <String, int>{};
+
+  static String _origin(Uri uri) => '${uri.scheme}://${uri.authority}';
+
+  /// Records that a response from [uri] started after [latency].
+  static void add(Uri uri, Duration latency) {
+    final origin = _origin(uri);
+    final window = _windows.putIfAbsent(origin, () => []);
+    if (window.length < _windowSize) {
+      window.add(latency.inMicroseconds);
+      return;
+    }
+    final next = _next[origin] ?? 0;
+    window[next] = latency.inMicroseconds;
+    _next[origin] = (next + 1) % _windowSize;
+  }
+
+  /// 95th percentile of the recent latencies of [uri]'s origin, or null if
+  /// too few responses have been seen.
+  static Duration? p95(Uri uri) {
+    final window = _windows[_origin(uri)];
+    if (window == null || window.length < _minSamples) return null;
+    final sorted = window.toList()..sort();
+    return Duration(microseconds: sorted[(sorted.length * 95) ~/ 100]);
+  }
+}
@@ -5,49 +5,137 @@
 import 'dart:async';
 import 'dart:developer';
 import 'dart:ffi';
+import 'dart:io' show FileSystemException, OSError;
 import 'dart:isolate';
 import 'dart:math' as m;
 import 'dart:typed_data';
 
 import 'package:ffi/ffi.dart';
 
+import 'enums.dart';
 import 'exceptions.dart';
 import 'globals.dart';
+import 'live_request.dart';
+import 'redirect_policy.dart';
+import 'request_trace.dart';
 import 'third_party/cronet/generated_bindings.dart';
+import 'transfer_progress.dart';
 import 'wrapper/generated_bindings.dart' as wrpr;
 
+// Callbacks by their id in compact messages. Must match kCallbackMethods in
+// wrapper_utils.cc.
+const _callbackMethods = [
+  'OnRedirectDenied',
+  'OnResponseStarted',
+  'OnReadCompleted',
+  'OnSucceeded',
+  'OnFailed',
+  'OnCanceled',
+  'OnRecordsRead',
+  'OnFramingError',
+  'OnSinkStarted',
+  'OnSinkProgress',
+  'OnSinkError',
+  'OnProgress',
+  'OnStuck',
+  'ReadFunc',
+  'RewindFunc',
+  'OnBodyError',
+];
+
 /// Deserializes the message sent by cronet and it's wrapper.
 class _CallbackRequestMessage {
   final String method;
-  final Uint8List data;
 
-  /// Constructs [method] and [data] from [message].
-  factory _CallbackRequestMessage.fromCppMessage(List<dynamic> message) {
+  /// Arguments of the callback.
+  final Uint64List args;
+
+  /// Bytes sent along with the message, if any. The whole response body for
+  /// requests aggregating it natively.
+  final Uint8List? body;
+
+  /// Constructs [method], [args] and [body] from [message], compact or not.
+  factory _CallbackRequestMessage.fromCppMessage(Object? message) {
+    if (message is Uint8List) return _CallbackRequestMessage._compact(message);
+    final parts = message as List<dynamic>;
+    if (parts[0] is Uint8List) {
+      return _CallbackRequestMessage._compact(
+          parts[0] as Uint8List, parts[1] as Uint8List);
+    }
+    return _CallbackRequestMessage._(
+        parts[0] as String,
+        (parts[1] as Uint8List).buffer.asUint64List(),
+        parts.length > 2 ? parts[2] as Uint8List : null);
+  }
+
+  /// The id of the callback followed by its arguments, 64 bits each.
+  factory _CallbackRequestMessage._compact(Uint8List message,
+      [Uint8List? body]) {
+    final words = message.buffer
+        .asUint64List(message.offsetInBytes, message.lengthInBytes ~/ 8);
     return _CallbackRequestMessage._(
-        message[0] as String, message[1] as Uint8List);
+        _callbackMethods[words[0]], Uint64List.sublistView(words, 1), body);
   }
 
-  _CallbackRequestMessage._(this.method, this.data);
+  _CallbackRequestMessage._(this.method, this.args, this.body);
 
   @override
   String toString() => 'CppRequest(method: $method)';
 }
 
+/// What the response of a request writing its body to a file says about the
+/// object.
+class SinkInfo {
+  final int statusCode;
+
+  /// Length of the whole object, or -1 if unknown.
+  final int length;
+
+  /// Strong entity tag or last modification date of the object, if any.
+  final String? validator;
+
+  const SinkInfo(this.statusCode, this.length, this.validator);
+}
+
 /// Handles every kind of callbacks that are invoked by messages and
 /// data that are sent by [NativePort] from native cronet library.
 class CallbackHandler {
   final ReceivePort receivePort;
-  final Pointer<wrpr.SampleExecutor> executor;
 
-  // These are a part of HttpClientRequest Public API.
-  bool followRedirects = true;
-  int maxRedirects = 5;
+  /// Redirects followed by the request. Filled in when the response starts.
+  final redirects = <RedirectInfo>[];
+
+  /// Deadlines of the request by TIMEOUT_* kind.
+  final timeouts = <int, Duration>{};
+
+  /// File the response body is written to natively, if any.
+  String? sinkPath;
+
+  /// Filled in when the response starts, if the body is written to a file.
+  SinkInfo? sinkInfo;
+
+  /// Called with the bytes written to the file so far.
+  void Function(int written)? onSinkProgress;
+
+  /// Called with the progress of the request, see
+  /// [HttpClientRequest.onProgress].
+  void Function(TransferProgress progress)? onProgress;
+
+  /// Called once the request made no progress for the stuck request
+  /// threshold of its client, see [HttpClient.onStuckRequest].
+  void Function(LiveRequest request)? onStuck;
 
   /// Stream controller to allow consumption of data like [HttpClientResponse].
   final _controller = StreamController<List<int>>();
 
+  // Completes with true once the response starts, or with false if the
+  // request ends without a response.
+  final _responseStarted = Completer<bool>();
+
+  var _done = false;
+
   /// Registers the [NativePort] to the cronet side.
-  CallbackHandler(this.executor, this.receivePort);
+  CallbackHandler(this.receivePort);
 
   /// [Stream] for [HttpClientResponse].
   Stream<List<int>> get stream {
@@ -57,16 +145,80 @@ class CallbackHandler {
   /// [Stream] controller for [HttpClientResponse].
   StreamController<List<int>> get controller => _controller;
 
+  /// Completes with true once the response starts, or with false if the
+  /// request ends without a response.
+  Future<bool> get responseStarted => _responseStarted.future;
+
+  /// Whether the request is done and released.
+  bool get done => _done;
+
+  void _onResponseStarted() {
+    if (!_responseStarted.isCompleted) _responseStarted.complete(true);
+  }
+
   // Clean up tasks for a request.
   //
-  // We need to call this then whenever we are done with the request.
+  // We need to call this then whenever we are done with the request. Releases
+  // the request along with every native allocation made for it.
   void cleanUpRequest(
-      Pointer<Cronet_UrlRequest> reqPtr, void Function() cleanUpClient) {
+      Pointer<wrpr.RequestContext> context, void Function() cleanUpClient) {
     receivePort.close();
-    wrapper.RemoveRequest(reqPtr.cast());
+    wrapper.RequestContextDestroy(context);
+    _done = true;
+    if (!_responseStarted.isCompleted) _responseStarted.complete(false);
     cleanUpClient();
   }
 
+  // Fails the response stream with [error] and releases the request.
+  void _fail(Pointer<wrpr.RequestContext> context,
+      void Function() cleanUpClient, Object error) {
+    cleanUpRequest(context, cleanUpClient);
+    _controller.addError(error);
+    _controller.close();
+  }
+
+  // Reads the [count] redirects the wrapper followed from [address].
+  static List<RedirectInfo> _readRedirects(int address, int count) {
+    final entries = Pointer<wrpr.RedirectEntry>.fromAddress(address);
+    return [
+      for (var i = 0; i < count; i++)
+        RedirectInfo(
+            entries.elementAt(i).ref.status_code,
+            Uri.parse(
+                entries.elementAt(i).ref.location.cast<Utf8>().toDartString()))
+    ];
+  }
+
+  // Splits the records packed by the wrapper into views of [block]: the
+  // number of records, the end offset of each of them and then the records.
+  static Iterable<Uint8List> _unpackRecords(Uint8List block) sync* {
+    final header = ByteData.sublistView(block);
+    final count = header.getUint32(0, Endian.host);
+    final recordsOffset = 4 * (count + 1);
+    var start = 0;
+    for (var i = 1; i <= count; i++) {
+      final end = header.getUint32(4 * i, Endian.host);
+      yield Uint8List.sublistView(
+          block, recordsOffset + start, recordsOffset + end);
+      start = end;
+    }
+  }
+
+  // Joins a length sent in two halves, arguments being pointer sized.
+  static int _int64(int low, int high) => (low | (high << 32)).toSigned(64);
+
+  static const _timeoutNames = {
+    wrpr.TIMEOUT_CONNECT: 'Connect',
+    wrpr.TIMEOUT_READ: 'Read',
+    wrpr.TIMEOUT_TOTAL: 'Request',
+  };
+
+  static const _redirectDeniedReasons = {
+    wrpr.REDIRECT_DENIED_CROSS_ORIGIN: 'cross origin',
+    wrpr.REDIRECT_DENIED_SCHEME: 'scheme not allowed',
+    wrpr.REDIRECT_DENIED_CREDENTIALS: 'credentials would leak cross origin',
+  };
+
   /// Checks status of an URL response.
   bool statusChecker(int respCode, Pointer<Utf8> status, int lBound, int uBound,
       void Function() callback) {
@@ -78,7 +230,7 @@ class CallbackHandler {
         final statusStr = status.toDartString();
         _controller.addError(
             HttpException(statusStr.isNotEmpty ? statusStr : '$respCode'));
-        malloc.free(status);
+        wrapper.FreeString(status.cast());
       }
       callback();
       return false;
@@ -90,60 +242,51 @@ class CallbackHandler {
   ///
   /// This also invokes the appropriate callbacks that are registered,
   /// according to the network events sent from cronet side.
-  void listen(Pointer<Cronet_UrlRequest> reqPtr, void Function() cleanUpClient,
-      Uint8List dataToUpload) {
+  void listen(Pointer<wrpr.RequestContext> context,
+      void Function() cleanUpClient, Uint8List dataToUpload) {
     // Registers the listener on the receivePort.
     //
     // The message parameter contains both the name of the event and
     // the data associated with it.
-    receivePort.listen((dynamic message) {
-      final reqMessage =
-          _CallbackRequestMessage.fromCppMessage(message as List);
-      final args = reqMessage.data.buffer.asUint64List();
+    final port = receivePort.sendPort.nativePort;
 
-      /// Count of how many bytes has been uploaded to the server.
-      int bytesSent = 0;
+    /// Count of how many bytes has been uploaded to the server.
+    var bytesSent = 0;
+    receivePort.listen((dynamic message) {
+      if (RequestTrace.enabled) leaf.traceDartHandled(port);
+      final reqMessage = _CallbackRequestMessage.fromCppMessage(message);
+      final args = reqMessage.args;
 
       switch (reqMessage.method) {
-        case 'OnRedirectReceived':
-          {
-            final newUrlPtr = Pointer.fromAddress(args[0]).cast<Utf8>();
-            log('New Location: '
-                '${newUrlPtr.toDartString()}');
-            malloc.free(newUrlPtr);
-            // If NOT a 3XX status code, throw Exception.
-            final status = statusChecker(args[1], Pointer.fromAddress(args[2]),
-                300, 399, () => cronet.Cronet_UrlRequest_Cancel(reqPtr));
-            if (!status) {
-              break;
-            }
-            if (followRedirects && maxRedirects > 0) {
-              final res = cronet.Cronet_UrlRequest_FollowRedirect(reqPtr);
-              if (res != Cronet_RESULT.Cronet_RESULT_SUCCESS) {
-                cleanUpRequest(reqPtr, cleanUpClient);
-                throw UrlRequestError(res);
-              }
-              maxRedirects--;
-            } else {
-              cronet.Cronet_UrlRequest_Cancel(reqPtr);
-            }
+        // The redirect policy refused a redirect. The request is cancelled
+        // natively right after.
+        case 'OnRedirectDenied':
+          {
+            final location =
+                Pointer.fromAddress(args[1]).cast<Utf8>().toDartString();
+            _controller.addError(RedirectException(
+                'Redirect to $location denied: '
+                '${_redirectDeniedReasons[args[0]]}',
+                _readRedirects(args[3], args[2]),
+                uri: Uri.parse(location)));
           }
           break;
 
         // When server has sent the initial response.
         case 'OnResponseStarted':
           {
+            redirects.addAll(_readRedirects(args[4], args[3]));
+            _onResponseStarted();
             // If NOT a 1XX or 2XX status code, throw Exception.
             final status = statusChecker(args[0], Pointer.fromAddress(args[2]),
-                100, 299, () => cronet.Cronet_UrlRequest_Cancel(reqPtr));
-            log('Response started');
+                100, 299, () => wrapper.RequestContextCancel(context));
             if (!status) {
               break;
             }
-            final res = cronet.Cronet_UrlRequest_Read(
-                reqPtr, Pointer.fromAddress(args[1]).cast<Cronet_Buffer>());
+            // The buffer at args[1] is owned by the request context.
+            final res = leaf.requestContextRead(context);
             if (res != Cronet_RESULT.Cronet_RESULT_SUCCESS) {
-              throw UrlRequestError(res);
+              _fail(context, cleanUpClient, UrlRequestError(res));
             }
           }
           break;
@@ -154,26 +297,22 @@ class CallbackHandler {
         // data received and no of bytes read.
         case 'OnReadCompleted':
           {
-            final request = Pointer<Cronet_UrlRequest>.fromAddress(args[0]);
             final buffer = Pointer<Cronet_Buffer>.fromAddress(args[2]);
             final bytesRead = args[3];
 
-            log('Recieved: $bytesRead');
             // If NOT a 1XX or 2XX status code, throw Exception.
             final status = statusChecker(args[1], Pointer.fromAddress(args[4]),
-                100, 299, () => cronet.Cronet_UrlRequest_Cancel(reqPtr));
+                100, 299, () => wrapper.RequestContextCancel(context));
             if (!status) {
               break;
             }
-            final data = cronet.Cronet_Buffer_GetData(buffer)
+            final data = leaf.bufferGetData(buffer)
                 .cast<Uint8>()
                 .asTypedList(bytesRead);
             _controller.sink.add(data.toList(growable: false));
-            final res = cronet.Cronet_UrlRequest_Read(request, buffer);
+            final res = leaf.requestContextRead(context);
             if (res != Cronet_RESULT.Cronet_RESULT_SUCCESS) {
-              cleanUpRequest(reqPtr, cleanUpClient);
-              _controller.addError(UrlRequestError(res));
-              _controller.close();
+              _fail(context, cleanUpClient, UrlRequestError(res));
             }
           }
           break;
@@ -182,59 +321,161 @@ class CallbackHandler {
           {
             final errorStrPtr = Pointer.fromAddress(args[0]).cast<Utf8>();
             final error = errorStrPtr.toDartString();
-            malloc.free(errorStrPtr);
-            cleanUpRequest(reqPtr, cleanUpClient);
-            _controller.addError(HttpException(error));
-            _controller.close();
-            cronet.Cronet_UrlRequest_Destroy(reqPtr);
+            wrapper.FreeString(errorStrPtr.cast());
+            _fail(
+                context,
+                cleanUpClient,
+                NetworkException(error, NetworkError.values[args[1]],
+                    args[2].toSigned(32), args[3] != 0,
+                    args[4].toSigned(32), args[5]));
           }
           break;
-        // When the request is cancelled, we will shut down everything.
+        // When the request is cancelled, we will shut down everything. A
+        // request cancelled natively because of a deadline fails instead.
         case 'OnCanceled':
           {
-            cleanUpRequest(reqPtr, cleanUpClient);
+            if (args.isNotEmpty && args[0] != 0) {
+              _fail(
+                  context,
+                  cleanUpClient,
+                  TimeoutException('${_timeoutNames[args[0]]} timed out',
+                      timeouts[args[0]]));
+              break;
+            }
+            cleanUpRequest(context, cleanUpClient);
             _controller.close();
-            cronet.Cronet_UrlRequest_Destroy(reqPtr);
+          }
+          break;
+        // Records framed natively out of the response body.
+        case 'OnRecordsRead':
+          {
+            _onResponseStarted();
+            _unpackRecords(reqMessage.body!).forEach(_controller.sink.add);
+          }
+          break;
+        // The response body couldn't be framed. The request is cancelled
+        // natively right after.
+        case 'OnFramingError':
+          {
+            _controller.addError(HttpException(
+                args[0] == wrpr.FRAMING_ERROR_INVALID_UTF8
+                    ? 'Invalid UTF-8 in a record'
+                    : 'Record too long'));
+          }
+          break;
+        // The body accumulated natively outgrew the memory available.
+        case 'OnBodyError':
+          {
+            _controller.addError(HttpException(
+                'Out of memory for a response body of ${args[0]} bytes'));
+          }
+          break;
+        // The response of a request writing its body to a file started.
+        case 'OnSinkStarted':
+          {
+            final validatorPtr = Pointer.fromAddress(args[3]).cast<Utf8>();
+            String? validator;
+            if (validatorPtr != nullptr) {
+              validator = validatorPtr.toDartString();
+              wrapper.FreeString(validatorPtr.cast());
+            }
+            sinkInfo = SinkInfo(args[0], _int64(args[1], args[2]), validator);
+            _onResponseStarted();
+          }
+          break;
+        case 'OnProgress':
+          {
+            onProgress?.call(TransferProgress(
+                LoadState.values[args[0]],
+                _int64(args[5], args[6]),
+                _int64(args[7], args[8]),
+                _int64(args[1], args[2]),
+                _int64(args[3], args[4])));
+          }
+          break;
+        // The watchdog of the client found the request stuck. The request
+        // keeps running.
+        case 'OnStuck':
+          {
+            final urlPtr = Pointer.fromAddress(args[0]).cast<Utf8>();
+            final url = urlPtr.toDartString();
+            wrapper.FreeString(urlPtr.cast());
+            onStuck?.call(LiveRequest(
+                Uri.parse(url),
+                Duration(milliseconds: _int64(args[1], args[2])),
+                Duration(milliseconds: _int64(args[3], args[4])),
+                _int64(args[5], args[6]),
+                _int64(args[7], args[8]),
+                args[9],
+                LoadState.values[args[10]],
+                true));
+          }
+          break;
+        case 'OnSinkProgress':
+          {
+            onSinkProgress?.call(_int64(args[0], args[1]));
+          }
+          break;
+        // The response body couldn't be written to the file. The request is
+        // cancelled natively right after.
+        case 'OnSinkError':
+          {
+            switch (args[0]) {
+              case wrpr.SINK_ERROR_IO:
+                _controller.addError(FileSystemException(
+                    'Writing the response body failed',
+                    sinkPath,
+                    OSError('', args[1])));
+                break;
+              case wrpr.SINK_ERROR_NOT_PARTIAL:
+                _controller
+                    .addError(const HttpException('Byte range not served'));
+                break;
+              default:
+                _controller.addError(
+                    const HttpException('Byte range longer than requested'));
+            }
           }
           break;
         // When the request is succesfully done, we will shut down everything.
         case 'OnSucceeded':
           {
-            cleanUpRequest(reqPtr, cleanUpClient);
+            if (args.length > 1) {
+              // The body was read natively, the redirects haven't been
+              // reported yet.
+              redirects.addAll(_readRedirects(args[2], args[1]));
+            }
+            _onResponseStarted();
+            final body = reqMessage.body;
+            if (body != null) {
+              // The body was aggregated natively, this is the only message of
+              // the response.
+              _controller.sink.add(body);
+            }
+            cleanUpRequest(context, cleanUpClient);
             _controller.close();
-            cronet.Cronet_UrlRequest_Destroy(reqPtr);
           }
           break;
         case 'ReadFunc':
           {
-            final size =
-                cronet.Cronet_Buffer_GetSize(Pointer.fromAddress(args[1]));
+            final size = leaf.bufferGetSize(Pointer.fromAddress(args[1]));
             final remainintBytes = dataToUpload.length - bytesSent;
             final chunkSize = m.min(size, remainintBytes);
-            final buff =
-                cronet.Cronet_Buffer_GetData(Pointer.fromAddress(args[1]))
-                    .cast<Uint8>();
-            int i = 0;
             // memcopy from our buffer to cronet buffer.
-            for (final byte in dataToUpload.getRange(bytesSent, chunkSize)) {
-              buff[i] = byte;
-              i++;
-            }
+            leaf
+                .bufferGetData(Pointer.fromAddress(args[1]))
+                .cast<Uint8>()
+                .asTypedList(chunkSize)
+                .setRange(0, chunkSize, dataToUpload, bytesSent);
             bytesSent += chunkSize;
-            cronet.Cronet_UploadDataSink_OnReadSucceeded(
-                Pointer.fromAddress(args[0]).cast(), chunkSize, false);
+            leaf.uploadDataSinkOnReadSucceeded(
+                Pointer.fromAddress(args[0]), chunkSize, 0);
             break;
           }
         case 'RewindFunc':
           {
             bytesSent = 0;
-            cronet.Cronet_UploadDataSink_OnRewindSucceeded(
-                Pointer.fromAddress(args[0]));
-            break;
-          }
-        case 'CloseFunc':
-          {
-            wrapper.UploadDataProviderDestroy(Pointer.fromAddress(args[0]));
+            leaf.uploadDataSinkOnRewindSucceeded(Pointer.fromAddress(args[0]));
             break;
           }
         default:
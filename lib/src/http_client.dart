@@ -7,12 +7,18 @@ import 'dart:ffi';
 
 import 'package:ffi/ffi.dart';
 
+import 'admission_queue.dart';
 import 'enums.dart';
 import 'exceptions.dart';
 import 'globals.dart';
 import 'http_client_request.dart';
+import 'http_client_response.dart';
+import 'live_request.dart';
 import 'quic_hint.dart';
+import 'range_download.dart';
+import 'retry_policy.dart';
 import 'third_party/cronet/generated_bindings.dart';
+import 'wrapper/generated_bindings.dart' as wrpr;
 
 /// A client that receives content, such as web pages,
 /// from a server using the HTTP, HTTPS, HTTP2, Quic etc. protocol.
@@ -39,10 +45,30 @@ class HttpClient {
   final String acceptLanguage;
   final List<QuicHint> quicHints;
 
-  final Pointer<Cronet_Engine> _cronetEngine;
-  // Keep all the request reference in a list so if the client is being
-  // explicitly closed, we can clean up the requests.
-  final _requests = List<HttpClientRequestImpl>.empty(growable: true);
+  /// Requests allowed to run at once. Null for no limit.
+  final int? maxConcurrentRequests;
+
+  /// Requests allowed to run at once per host. Null for no limit.
+  final int? maxConcurrentRequestsPerHost;
+
+  /// Order in which requests waiting for a slot are started.
+  final AdmissionOrder admissionOrder;
+
+  /// Time a running request may go without progress before it is reported
+  /// to [onStuckRequest]. Null doesn't watch for stuck requests.
+  final Duration? stuckRequestThreshold;
+
+  /// Called with a request once it made no progress for
+  /// [stuckRequestThreshold]. The request keeps running, it is up to the
+  /// callback to abort it.
+  final void Function(LiveRequest request)? onStuckRequest;
+
+  late final Pointer<Cronet_Engine> _cronetEngine;
+  // Null if the client doesn't limit concurrent requests.
+  final AdmissionQueue? _admission;
+  // Keep all the request references so if the client is being explicitly
+  // closed, we can clean up the requests.
+  final _requests = <HttpClientRequestImpl>{};
   var _stop = false;
 
   static const int defaultHttpPort = 80;
@@ -55,6 +81,14 @@ class HttpClient {
   /// enabled, then [quicHints] can be provided. [userAgent] and
   /// [acceptLanguage] can also be provided.
   ///
+  /// Closed requests beyond [maxConcurrentRequests] or
+  /// [maxConcurrentRequestsPerHost] wait in a queue until a running request
+  /// is done, and are started in [admissionOrder].
+  ///
+  /// If [stuckRequestThreshold] is set, the running requests are watched
+  /// natively and [onStuckRequest] is called for those that make no progress
+  /// for that long.
+  ///
   /// Throws [CronetNativeError] if [HttpClient] can't be created.
   HttpClient({
     this.userAgent = 'Dart/2.12',
@@ -62,7 +96,14 @@ class HttpClient {
     this.quicHints = const [],
     this.brotli = true,
     this.acceptLanguage = 'en_US',
-  }) : _cronetEngine = cronet.Cronet_Engine_Create() {
+    this.maxConcurrentRequests,
+    this.maxConcurrentRequestsPerHost,
+    this.admissionOrder = AdmissionOrder.fifo,
+    this.stuckRequestThreshold,
+    this.onStuckRequest,
+  })  : _cronetEngine = cronet.Cronet_Engine_Create(),
+        _admission = _admissionQueue(maxConcurrentRequests,
+            maxConcurrentRequestsPerHost, admissionOrder) {
     if (_cronetEngine == nullptr) throw Error();
     wrapper.RegisterHttpClient(this, _cronetEngine.cast());
     // Starting the engine with parameters.
@@ -110,6 +151,72 @@ class HttpClient {
       throw CronetNativeError(res);
     }
     cronet.Cronet_EngineParams_Destroy(engineParams);
+    _watchStuckRequests();
+  }
+
+  /// Initiates an [HttpClient] sending its requests through the engine of
+  /// another client, possibly of another isolate, handed over with
+  /// [shareEngine].
+  ///
+  /// The clients share their connections, QUIC sessions and settings, the
+  /// engine is shut down once every client using it is garbage collected.
+  /// Callbacks of the requests of this client are handled by the isolate
+  /// that created it. The other arguments are the same as for the default
+  /// constructor, a [stuckRequestThreshold] applies to every client of the
+  /// engine.
+  ///
+  /// Throws [StateError] if [engine], or a copy of it sent to another isolate,
+  /// was already used or released.
+  HttpClient.shared(
+    SharedEngine engine, {
+    this.maxConcurrentRequests,
+    this.maxConcurrentRequestsPerHost,
+    this.admissionOrder = AdmissionOrder.fifo,
+    this.stuckRequestThreshold,
+    this.onStuckRequest,
+  })  : userAgent = engine.userAgent,
+        protocol = engine.protocol,
+        quicHints = engine.quicHints,
+        brotli = engine.brotli,
+        acceptLanguage = engine.acceptLanguage,
+        _admission = _admissionQueue(maxConcurrentRequests,
+            maxConcurrentRequestsPerHost, admissionOrder) {
+    // Checked natively, copies of the handle sent to other isolates share
+    // its token.
+    final attached = wrapper.AttachSharedEngine(this, engine._token);
+    if (attached == nullptr) throw StateError('Shared engine already used');
+    _cronetEngine = attached.cast();
+    _watchStuckRequests();
+  }
+
+  static AdmissionQueue? _admissionQueue(int? maxConcurrentRequests,
+          int? maxConcurrentRequestsPerHost, AdmissionOrder admissionOrder) =>
+      maxConcurrentRequests == null && maxConcurrentRequestsPerHost == null
+          ? null
+          : AdmissionQueue(maxConcurrentRequests, maxConcurrentRequestsPerHost,
+              admissionOrder);
+
+  void _watchStuckRequests() {
+    final threshold = stuckRequestThreshold;
+    if (threshold != null) {
+      if (threshold <= Duration.zero) {
+        throw ArgumentError.value(threshold, 'stuckRequestThreshold',
+            'Stuck request threshold must be positive');
+      }
+      wrapper.SetStuckRequestThreshold(
+          _cronetEngine.cast(), threshold.inMilliseconds);
+    }
+  }
+
+  /// A handle to the engine of this client for [HttpClient.shared], which
+  /// can be sent to another isolate.
+  ///
+  /// Each handle keeps the engine alive until it is used by a client or
+  /// [SharedEngine.release]d, and can only be used once.
+  SharedEngine shareEngine() {
+    final token = wrapper.ShareEngine(_cronetEngine.cast());
+    return SharedEngine._(
+        token, userAgent, protocol, quicHints, brotli, acceptLanguage);
   }
 
   void _cleanUpRequests(HttpClientRequest hcr) {
@@ -131,9 +238,7 @@ class HttpClient {
       // during the traversal as cronet sends onCancel callbacks.
       final requests = _requests.toList();
       for (final request in requests) {
-        cronet.Cronet_UrlRequest_Cancel(request.requestPtr);
-        request.callbackHandler.controller
-            .addError(HttpException('HttpClient: Force Closed'));
+        request.abort(const HttpException('HttpClient: Force Closed'));
       }
     }
   }
@@ -158,12 +263,146 @@ class HttpClient {
       if (_stop) {
         throw Exception("Client is closed. Can't open new connections");
       }
-      _requests.add(
-          HttpClientRequestImpl(url, method, _cronetEngine, _cleanUpRequests));
-      return _requests.last;
+      final request = HttpClientRequestImpl(
+          url, method, _cronetEngine, _cleanUpRequests,
+          admission: _admission);
+      request.callbackHandler.onStuck = onStuckRequest;
+      _requests.add(request);
+      return request;
+    });
+  }
+
+  /// Closes all of the [requests] and starts them together.
+  ///
+  /// This is equivalent to calling [HttpClientRequest.close] on each of the
+  /// [requests], but all of them are set up and started with a single native
+  /// call, which is considerably cheaper when many requests are fired at once.
+  /// Responses are returned in the same order as [requests]. If a request
+  /// can't be started, its response emits an [UrlRequestError].
+  ///
+  /// Throws [ArgumentError] if any of the [requests] wasn't opened by this
+  /// client, and [StateError] if any of them was closed already.
+  Future<List<HttpClientResponse>> closeAll(
+      Iterable<HttpClientRequest> requests) {
+    return Future(() {
+      final impls = requests.cast<HttpClientRequestImpl>().toList();
+      if (impls.any((request) => !_requests.contains(request))) {
+        throw ArgumentError('Requests must be opened by this HttpClient.');
+      }
+      if (impls.any((request) => request.closed) ||
+          impls.toSet().length != impls.length) {
+        throw StateError('Requests must not be closed already nor listed twice.');
+      }
+      final responses = [
+        for (final request in impls)
+          HttpClientResponseImpl(request.callbackHandler.stream,
+              request.callbackHandler.redirects)
+      ];
+      for (var i = 0; i < impls.length; i++) {
+        impls[i].closedWith = Future.value(responses[i]);
+      }
+      // Requests that have to wait for a slot are started on their own once
+      // they get one.
+      final admitted = [
+        for (final request in impls)
+          if (request.admit((error) => _startQueued(request, error))) request
+      ];
+      final errors = HttpClientRequestImpl.startAll(_cronetEngine, admitted);
+      for (var i = 0; i < admitted.length; i++) {
+        final error = errors[i];
+        if (error != null) {
+          admitted[i].callbackHandler.controller
+            ..addError(error)
+            ..close();
+        }
+      }
+      return responses;
     });
   }
 
+  // Starts a request of [closeAll] that waited for a slot, or fails it with
+  // [error] if it was aborted meanwhile.
+  void _startQueued(HttpClientRequestImpl request, Object? error) {
+    error ??= HttpClientRequestImpl.startAll(_cronetEngine, [request]).single;
+    if (error != null) {
+      request.callbackHandler.controller
+        ..addError(error)
+        ..close();
+    }
+  }
+
+  /// Snapshot of the requests running and waiting for a slot. Only counts
+  /// requests if [maxConcurrentRequests] or [maxConcurrentRequestsPerHost] is
+  /// set.
+  AdmissionStats get admissionStats =>
+      _admission?.stats ??
+      const AdmissionStats(0, 0, 0, 0, Duration.zero, Duration.zero);
+
+  /// Snapshot of the requests of this client that have been started and
+  /// aren't done yet, taken natively in a single call.
+  ///
+  /// Requests waiting for a slot aren't started yet, see [admissionStats].
+  List<LiveRequest> get liveRequests {
+    return using((Arena arena) {
+      final count = arena<Int32>();
+      final snapshots =
+          wrapper.SnapshotRequests(_cronetEngine.cast(), count);
+      if (snapshots == nullptr) return const [];
+      try {
+        return [
+          for (var i = 0; i < count.value; i++)
+            _liveRequest(snapshots.elementAt(i).ref)
+        ];
+      } finally {
+        malloc.free(snapshots);
+      }
+    });
+  }
+
+  static LiveRequest _liveRequest(wrpr.RequestSnapshot snapshot) =>
+      LiveRequest(
+          Uri.parse(snapshot.url.cast<Utf8>().toDartString()),
+          Duration(milliseconds: snapshot.age_ms),
+          Duration(milliseconds: snapshot.idle_ms),
+          snapshot.bytes_sent,
+          snapshot.bytes_received,
+          snapshot.redirects,
+          // The status is shifted by one, INVALID is -1.
+          LoadState.values[snapshot.status + 1],
+          snapshot.stuck != 0);
+
+  /// Downloads [url] into the file at [path].
+  ///
+  /// If the server serves byte ranges, the object is split into up to
+  /// [parallelism] ranges of at least [minRangeSize] bytes, fetched by
+  /// concurrent requests. The body of each range is written natively at its
+  /// offset into the file, which is preallocated to the length of the object.
+  /// Otherwise the object is fetched in a single response.
+  ///
+  /// Progress of a ranged download is checkpointed into `<path>.download`. If
+  /// the download fails, downloading the same [url] into the same [path] again
+  /// resumes it, fetching only the missing bytes, unless the object has
+  /// changed meanwhile. The checkpoint is deleted once the download completes.
+  ///
+  /// Each request is retried according to [retryPolicy].
+  Future<DownloadResult> download(Uri url, String path,
+      {int parallelism = 4,
+      int minRangeSize = 1024 * 1024,
+      RetryPolicy? retryPolicy = const RetryPolicy()}) {
+    if (parallelism < 1) {
+      throw ArgumentError.value(parallelism, 'parallelism', 'Must be positive');
+    }
+    if (minRangeSize < 1) {
+      throw ArgumentError.value(
+          minRangeSize, 'minRangeSize', 'Must be positive');
+    }
+    return RangeDownload(openUrl, url, path,
+            parallelism: parallelism,
+            minRangeSize: minRangeSize,
+            retryPolicy: retryPolicy)
+        .run();
+  }
+
   /// Opens a request on the basis of [method], [host], [port] and [path] using
   /// GET, PUT, POST, HEAD, PATCH, DELETE or any other method.
   ///
@@ -269,3 +508,29 @@ class HttpClient {
           .cast<Utf8>()
           .toDartString();
 }
+
+/// The engine of an [HttpClient], handed to another isolate to create a
+/// client with [HttpClient.shared], see [HttpClient.shareEngine].
+class SharedEngine {
+  // Token of the reference to the engine held by the handle, taken over
+  // natively by the first client or release using it.
+  final int _token;
+  final String userAgent;
+  final HttpProtocol protocol;
+  final List<QuicHint> quicHints;
+  final bool brotli;
+  final String acceptLanguage;
+
+  SharedEngine._(this._token, this.userAgent, this.protocol, this.quicHints,
+      this.brotli, this.acceptLanguage);
+
+  /// Gives up the engine without creating a client with it.
+  ///
+  /// Throws [StateError] if this handle, or a copy of it sent to another
+  /// isolate, was already used or released.
+  void release() {
+    if (wrapper.ReleaseSharedEngine(_token) == 0) {
+      throw StateError('Shared engine already used');
+    }
+  }
+}
@@ -7,15 +7,25 @@ import 'dart:convert';
 import 'dart:ffi';
 import 'dart:io' as io;
 import 'dart:isolate';
+import 'dart:math' as m;
+import 'dart:typed_data';
 
 import 'package:ffi/ffi.dart';
 
+import 'admission_queue.dart';
+import 'enums.dart';
 import 'exceptions.dart';
 import 'globals.dart';
+import 'hedging.dart';
 import 'http_callback_handler.dart';
 import 'http_client_response.dart';
 import 'http_headers.dart';
+import 'multipart.dart';
+import 'redirect_policy.dart';
+import 'retry_policy.dart';
 import 'third_party/cronet/generated_bindings.dart';
+import 'transfer_progress.dart';
+import 'wrapper/generated_bindings.dart' as wrpr;
 
 /// HTTP request for a client connection.
 ///
@@ -60,15 +70,99 @@ abstract class HttpClientRequest implements io.IOSink {
   int get maxRedirects;
   set maxRedirects(int redirects);
 
+  /// Rules the redirects are checked against. Have no effect if
+  /// [followRedirects] is set to false.
+  RedirectPolicy get redirectPolicy;
+  set redirectPolicy(RedirectPolicy policy);
+
   /// The uri of the request.
   Uri get uri;
 
+  /// Priority of the request. Has no effect once the request is closed.
+  RequestPriority get priority;
+  set priority(RequestPriority priority);
+
+  /// How the response body is split into the events of the response. Has no
+  /// effect on [readAsBytes].
+  RecordFraming get framing;
+  set framing(RecordFraming framing);
+
+  /// Time to wait for the response headers, redirects included. Null waits
+  /// forever.
+  Duration? get connectTimeout;
+  set connectTimeout(Duration? timeout);
+
+  /// Time to wait for a chunk of the response body to arrive. Null waits
+  /// forever.
+  Duration? get readTimeout;
+  set readTimeout(Duration? timeout);
+
+  /// Time the whole request may take. Null waits forever.
+  Duration? get totalTimeout;
+  set totalTimeout(Duration? timeout);
+
+  /// Duplicates the request if its response is slow to start. Only `GET` and
+  /// `HEAD` requests without a body are hedged. Has no effect on requests
+  /// started with [HttpClient.closeAll].
+  ///
+  /// With hedging, [close] completes once the response has started.
+  HedgingPolicy? get hedging;
+  set hedging(HedgingPolicy? policy);
+
+  /// Retries the request if it fails with a transient network error. Only
+  /// idempotent requests without a body are retried, and only until their
+  /// response starts. Null never retries.
+  RetryPolicy? get retryPolicy;
+  set retryPolicy(RetryPolicy? policy);
+
+  /// Content encoding the request body is compressed with.
+  ///
+  /// Compression happens natively while the body is uploaded, the request
+  /// then carries a `Content-Encoding` header and is sent without a
+  /// `Content-Length`. Throws [UnsupportedError] if the encoding isn't
+  /// available in this build of the wrapper.
+  UploadCompression get uploadCompression;
+  set uploadCompression(UploadCompression compression);
+
+  /// Parts of the `multipart/form-data` body the request is sent with,
+  /// instead of the bytes written to it.
+  ///
+  /// Boundaries and part headers are generated natively and file parts are
+  /// read while they are uploaded, so memory use doesn't grow with the size of
+  /// the files. The `Content-Type` header is set along with a random
+  /// boundary. Multipart bodies aren't compressed. Throws [StateError] if
+  /// bytes have been written to the request.
+  List<MultipartPart>? get multipart;
+  set multipart(List<MultipartPart>? parts);
+
+  /// Called with the progress of the request every [progressInterval] while
+  /// it runs. Null reports no progress.
+  ///
+  /// Byte counts are kept natively and the load state is queried from Cronet
+  /// on a timer, so progress costs nothing per chunk of the body and also
+  /// covers bodies that never reach the Dart side, as with [readAsBytes].
+  void Function(TransferProgress progress)? get onProgress;
+  set onProgress(void Function(TransferProgress progress)? callback);
+
+  /// Time between two calls to [onProgress].
+  Duration get progressInterval;
+  set progressInterval(Duration interval);
+
   /// The [Encoding] used when writing strings.
   @override
   late Encoding encoding;
 
   /// Returns the client request headers.
   HttpHeaders get headers;
+
+  /// Closes the request and reads the whole response body.
+  ///
+  /// The body is accumulated natively and delivered in a single piece, which
+  /// is much cheaper than listening to the response returned by [close] for
+  /// small and medium sized bodies.
+  ///
+  /// Completes with an error if the request can't be initiated or fails.
+  Future<Uint8List> readAsBytes();
 }
 
 /// Implementation of [HttpClientRequest].
@@ -77,22 +171,107 @@ class HttpClientRequestImpl implements HttpClientRequest {
   final String _method;
   final Pointer<Cronet_Engine> _cronetEngine;
   final CallbackHandler _callbackHandler;
-  final Pointer<Cronet_UrlRequest> _request;
-  final _requestParams = cronet.Cronet_UrlRequestParams_Create();
-  late final HttpHeadersImpl _headers;
+  // Native context of the request. Cancels go through it, as a retry replaces
+  // the Cronet request.
+  Pointer<wrpr.RequestContext> _context = nullptr;
+  final _headers = HttpHeadersImpl();
   final _dataToUpload = io.BytesBuilder();
+  var _bytesToUpload = Uint8List(0);
+  // Whether the response body is accumulated natively, see [readAsBytes].
+  var _aggregateBody = false;
+  // File the response body is written to natively, see [writeTo].
+  String? _sinkPath;
+  var _sinkOffset = 0;
+  var _sinkLength = -1;
   bool isImmutable = false;
 
+  @override
+  RequestPriority priority = RequestPriority.medium;
+
+  @override
+  RecordFraming framing = RecordFraming.none;
+
+  /// Follow the redirects.
+  @override
+  bool followRedirects = true;
+
+  /// Maximum numbers of redirects to follow.
+  /// Have no effect if [followRedirects] is set to false.
+  @override
+  int maxRedirects = 5;
+
+  @override
+  RedirectPolicy redirectPolicy = const RedirectPolicy();
+
+  @override
+  Duration? connectTimeout;
+
+  @override
+  Duration? readTimeout;
+
+  @override
+  Duration? totalTimeout;
+
+  @override
+  HedgingPolicy? hedging;
+
+  @override
+  RetryPolicy? retryPolicy;
+
+  var _uploadCompression = UploadCompression.none;
+
+  @override
+  UploadCompression get uploadCompression => _uploadCompression;
+
+  @override
+  set uploadCompression(UploadCompression compression) {
+    if (compression != UploadCompression.none &&
+        wrapper.UploadCompressionSupported(compression.index) == 0) {
+      throw UnsupportedError(
+          '${_contentEncodings[compression]} is not available');
+    }
+    _uploadCompression = compression;
+  }
+
+  List<MultipartPart>? _multipart;
+
+  @override
+  void Function(TransferProgress progress)? onProgress;
+
+  @override
+  Duration progressInterval = const Duration(milliseconds: 100);
+
+  @override
+  List<MultipartPart>? get multipart => _multipart;
+
+  @override
+  set multipart(List<MultipartPart>? parts) {
+    if (isImmutable) throw StateError('Can not mutate the request body');
+    if (_dataToUpload.isNotEmpty) {
+      throw StateError('Bytes have been written to the request already');
+    }
+    _multipart = parts == null ? null : List.unmodifiable(parts);
+  }
+
+  // Duplicate sent by [hedging], if any.
+  HttpClientRequestImpl? _hedge;
+  // Requests of the hedging race not released yet. The client is only told
+  // once all of them are.
+  var _liveContenders = 1;
+  var _aborted = false;
+  // Response of the request once closed.
+  Future<HttpClientResponse>? _closed;
+
+  // Admission queue of the client, if it limits concurrent requests.
+  final AdmissionQueue? _admission;
+  // Called once the request is dequeued, see [admit].
+  void Function(Object? error)? _onAdmitted;
+
   /// Holds the function to clean up after the request is done (if nessesary).
   ///
   /// Implemented by: http_client.dart.
   final void Function(HttpClientRequest) _clientCleanup;
 
-  /// Pointer associated with [this] request.
-  ///
-  /// This is not a part of public api.
-  Pointer<Cronet_UrlRequest> get requestPtr => _request;
-
   /// [CallbackHandler] handling this request.
   ///
   /// This is not a part of public api.
@@ -105,81 +284,383 @@ class HttpClientRequestImpl implements HttpClientRequest {
   /// [HttpClient].
   HttpClientRequestImpl(
       this._uri, this._method, this._cronetEngine, this._clientCleanup,
-      {this.encoding = utf8})
-      : _callbackHandler =
-            CallbackHandler(wrapper.SampleExecutorCreate(), ReceivePort()),
-        _request = cronet.Cronet_UrlRequest_Create() {
-    _headers = HttpHeadersImpl(_requestParams);
-    // Register the native port to C side.
-    wrapper.RegisterCallbackHandler(
-        _callbackHandler.receivePort.sendPort.nativePort, _request.cast());
+      {this.encoding = utf8, AdmissionQueue? admission})
+      : _callbackHandler = CallbackHandler(ReceivePort()),
+        _admission = admission;
+
+  /// Takes a slot of the admission queue of the client. Returns true if the
+  /// request can be started right away. Otherwise it is queued and
+  /// [onAdmitted] is called once it can be started, or with an error if it
+  /// is aborted meanwhile.
+  ///
+  /// This is not a part of public api.
+  bool admit(void Function(Object? error) onAdmitted) {
+    final admission = _admission;
+    if (admission == null ||
+        admission.admit(
+            this, _uri.host, priority.index, () => onAdmitted(null))) {
+      return true;
+    }
+    _onAdmitted = onAdmitted;
+    return false;
   }
 
-  // Starts the request.
-  void _startRequest() {
-    if (_requestParams == nullptr) throw Error();
-    // TODO: ISSUE https://github.com/dart-lang/ffigen/issues/22
-    cronet.Cronet_UrlRequestParams_http_method_set(
-        _requestParams, _method.toNativeUtf8().cast<Int8>());
-    wrapper.InitSampleExecutor(_callbackHandler.executor);
-    final cronetCallbacks = cronet.Cronet_UrlRequestCallback_CreateWith(
-      wrapper.addresses.OnRedirectReceived.cast(),
-      wrapper.addresses.OnResponseStarted.cast(),
-      wrapper.addresses.OnReadCompleted.cast(),
-      wrapper.addresses.OnSucceeded.cast(),
-      wrapper.addresses.OnFailed.cast(),
-      wrapper.addresses.OnCanceled.cast(),
-    );
+  /// Starts [requests] on [engine] with a single call to the wrapper.
+  ///
+  /// Returns the error for each of the [requests] that couldn't be started, or
+  /// null if it has been started.
+  ///
+  /// This is not a part of public api.
+  static List<UrlRequestError?> startAll(
+      Pointer<Cronet_Engine> engine, List<HttpClientRequestImpl> requests) {
+    return using((Arena arena) {
+      final descriptors = arena<wrpr.RequestDescriptor>(requests.length);
+      for (var i = 0; i < requests.length; i++) {
+        requests[i]._describe(descriptors.elementAt(i).ref, arena);
+      }
+      wrapper.StartRequests(engine.cast(), descriptors, requests.length);
+      return [
+        for (var i = 0; i < requests.length; i++)
+          requests[i]._onStarted(descriptors.elementAt(i).ref)
+      ];
+    });
+  }
 
-    if (_dataToUpload.isNotEmpty) {
-      /// Data upload provider with registered callbacks (from cronet side).
-      final cronetUploadProvider = cronet.Cronet_UploadDataProvider_CreateWith(
-          wrapper.addresses.UploadDataProvider_GetLength.cast(),
-          wrapper.addresses.UploadDataProvider_Read.cast(),
-          wrapper.addresses.UploadDataProvider_Rewind.cast(),
-          wrapper.addresses.UploadDataProvider_CloseFunc.cast());
-
-      /// Data upload provider implementation (wrapper).
-      final wrapperUploadProvider = wrapper.UploadDataProviderCreate();
-      cronet.Cronet_UploadDataProvider_SetClientContext(
-          cronetUploadProvider, wrapperUploadProvider.cast());
-      wrapper.UploadDataProviderInit(
-          wrapperUploadProvider, _dataToUpload.length, _request.cast());
-      cronet.Cronet_UrlRequestParams_upload_data_provider_set(
-          _requestParams, cronetUploadProvider);
+  // Fills the [descriptor] the wrapper uses to set up and start the request.
+  //
+  // Strings and the header block are allocated with [allocator], they can be
+  // freed as soon as the request is started.
+  void _describe(wrpr.RequestDescriptor descriptor, Allocator allocator) {
+    _bytesToUpload = _dataToUpload.takeBytes();
+    final compressed = _uploadCompression != UploadCompression.none &&
+        _bytesToUpload.isNotEmpty;
+    if (compressed) {
+      _headers.set('Content-Encoding', _contentEncodings[_uploadCompression]!);
+      // Copied natively, the body is compressed without the Dart side.
+      final data = allocator<Uint8>(_bytesToUpload.length);
+      data.asTypedList(_bytesToUpload.length).setAll(0, _bytesToUpload);
+      descriptor
+        ..upload_compression = _uploadCompression.index
+        ..upload_data = data;
+    } else {
+      descriptor
+        ..upload_compression = wrpr.COMPRESSION_NONE
+        ..upload_data = nullptr;
+    }
+    final multipart = _multipart;
+    if (multipart != null && multipart.isNotEmpty) {
+      _describeMultipart(descriptor, multipart, allocator);
+    } else {
+      descriptor
+        ..multipart_parts = nullptr
+        ..num_multipart_parts = 0
+        ..multipart_boundary = nullptr;
+    }
+    _headers.isImmutable = isImmutable = true;
+    descriptor
+      ..port = _callbackHandler.receivePort.sendPort.nativePort
+      // TODO: ISSUE https://github.com/dart-lang/ffigen/issues/22
+      ..url = _uri.toString().toNativeUtf8(allocator: allocator).cast()
+      ..method = _method.toNativeUtf8(allocator: allocator).cast()
+      ..headers = _headers.pack(allocator)
+      ..num_headers = _headers.length
+      ..upload_length = _bytesToUpload.length
+      ..priority = priority.index
+      ..max_redirects = followRedirects ? maxRedirects : 0
+      ..redirect_flags = _redirectFlags()
+      ..aggregate_body = _aggregateBody ? 1 : 0
+      ..framing = framing.index
+      ..connect_timeout_ms =
+          _timeoutMillis(wrpr.TIMEOUT_CONNECT, connectTimeout)
+      ..read_timeout_ms = _timeoutMillis(wrpr.TIMEOUT_READ, readTimeout)
+      ..total_timeout_ms = _timeoutMillis(wrpr.TIMEOUT_TOTAL, totalTimeout)
+      ..progress_interval_ms = onProgress == null
+          ? 0
+          : m.max(1, m.min(progressInterval.inMilliseconds, 0x7fffffff));
+    _callbackHandler.onProgress = onProgress;
+    final retryPolicy = this.retryPolicy;
+    if (retryPolicy != null &&
+        _idempotentMethods.contains(_method) &&
+        _bytesToUpload.isEmpty) {
+      descriptor
+        ..max_attempts = retryPolicy.maxAttempts
+        ..retry_backoff_ms = retryPolicy.initialBackoff.inMilliseconds
+        ..retry_max_backoff_ms = retryPolicy.maxBackoff.inMilliseconds
+        ..retry_budget_percent = (retryPolicy.budgetRatio * 100).round();
+    } else {
+      descriptor.max_attempts = 1;
     }
+    final sinkPath = _sinkPath;
+    descriptor
+      ..sink_path = sinkPath == null
+          ? nullptr
+          : sinkPath.toNativeUtf8(allocator: allocator).cast()
+      ..sink_offset = _sinkOffset
+      ..sink_length = _sinkLength;
+  }
 
-    final res = cronet.Cronet_UrlRequest_InitWithParams(
-        _request,
-        _cronetEngine,
-        _uri.toString().toNativeUtf8().cast<Int8>(),
-        _requestParams,
-        cronetCallbacks,
-        wrapper.SampleExecutor_Cronet_ExecutorPtr_get(_callbackHandler.executor)
-            .cast());
-
-    if (res != Cronet_RESULT.Cronet_RESULT_SUCCESS) {
-      throw UrlRequestError(res);
+  void _describeMultipart(wrpr.RequestDescriptor descriptor,
+      List<MultipartPart> parts, Allocator allocator) {
+    Pointer<Int8> string(String? value) => value == null
+        ? nullptr
+        : value.toNativeUtf8(allocator: allocator).cast();
+    final boundary = _multipartBoundary();
+    _headers.set('Content-Type', 'multipart/form-data; boundary=$boundary');
+    final native = allocator<wrpr.MultipartPart>(parts.length);
+    for (var i = 0; i < parts.length; i++) {
+      final part = parts[i];
+      final bytes = part.bytes;
+      Pointer<Uint8> data = nullptr;
+      if (bytes != null) {
+        // Copied natively, the pointer only needs to outlive the start.
+        data = allocator<Uint8>(m.max(bytes.length, 1));
+        data.asTypedList(bytes.length).setAll(0, bytes);
+      }
+      native.elementAt(i).ref
+        ..name = string(part.name)
+        ..filename = string(part.filename)
+        ..content_type = string(part.contentType)
+        ..data = data
+        ..path = string(part.path)
+        ..offset = part.offset
+        ..length = bytes?.length ?? part.length ?? -1;
     }
+    descriptor
+      ..multipart_parts = native
+      ..num_multipart_parts = parts.length
+      ..multipart_boundary = string(boundary);
+  }
 
-    final res2 = cronet.Cronet_UrlRequest_Start(_request);
-    if (res2 != Cronet_RESULT.Cronet_RESULT_SUCCESS) {
-      throw UrlRequestError(res2);
+  static final _random = m.Random.secure();
+
+  // Random, so that it doesn't show up in the parts.
+  static String _multipartBoundary() {
+    const chars = 'abcdefghijklmnopqrstuvwxyz'
+        'ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789';
+    final suffix = List.generate(
+        32, (_) => chars.codeUnitAt(_random.nextInt(chars.length)));
+    return 'cronet-boundary-${String.fromCharCodes(suffix)}';
+  }
+
+  static const _contentEncodings = {
+    UploadCompression.gzip: 'gzip',
+    UploadCompression.deflate: 'deflate',
+    UploadCompression.zstd: 'zstd',
+  };
+
+  // Methods that can be sent again without changing their outcome.
+  static const _idempotentMethods = {
+    'GET',
+    'HEAD',
+    'OPTIONS',
+    'PUT',
+    'DELETE',
+    'TRACE'
+  };
+
+  // Milliseconds of the [timeout] of the given TIMEOUT_* kind, or 0 if there
+  // is none. Remembered for reporting the timeout.
+  int _timeoutMillis(int kind, Duration? timeout) {
+    if (timeout == null) return 0;
+    _callbackHandler.timeouts[kind] = timeout;
+    // Rounded up, a timeout never expires early.
+    final millis = (timeout.inMicroseconds + 999) ~/ 1000;
+    return m.max(1, m.min(millis, 0x7fffffff));
+  }
+
+  // Translates [redirectPolicy] to the REDIRECT_* flags of the wrapper.
+  int _redirectFlags() {
+    var flags = 0;
+    if (redirectPolicy.sameOriginOnly) flags |= wrpr.REDIRECT_SAME_ORIGIN_ONLY;
+    if (redirectPolicy.allowedSchemes.contains('http')) {
+      flags |= wrpr.REDIRECT_ALLOW_HTTP;
+    }
+    if (redirectPolicy.allowedSchemes.contains('https')) {
+      flags |= wrpr.REDIRECT_ALLOW_HTTPS;
     }
-    _callbackHandler.listen(
-        _request, () => _clientCleanup(this), _dataToUpload.takeBytes());
+    if (redirectPolicy.stripAuthOnCrossOrigin) {
+      flags |= wrpr.REDIRECT_STRIP_AUTH_CROSS_ORIGIN;
+    }
+    return flags;
+  }
+
+  // Reads back the outcome of starting the request from [descriptor].
+  UrlRequestError? _onStarted(wrpr.RequestDescriptor descriptor) {
+    if (descriptor.result != Cronet_RESULT.Cronet_RESULT_SUCCESS) {
+      _callbackHandler.receivePort.close();
+      _release();
+      return UrlRequestError(descriptor.result);
+    }
+    _context = descriptor.context;
+    _callbackHandler.listen(descriptor.context, _release, _bytesToUpload);
+    return null;
+  }
+
+  // Releases one of the requests of the hedging race.
+  void _release() {
+    if (--_liveContenders == 0) {
+      _admission?.release(_uri.host);
+      _clientCleanup(this);
+    }
+  }
+
+  /// Cancels the request, along with its duplicate if any, and fails its
+  /// response with [error].
+  ///
+  /// This is not a part of public api.
+  void abort(Object error) {
+    _aborted = true;
+    if (_admission?.remove(this) ?? false) {
+      _onAdmitted!(error);
+      return;
+    }
+    final hedge = _hedge;
+    for (final request in [this, if (hedge != null) hedge]) {
+      if (request._callbackHandler.done) continue;
+      if (request._context != nullptr) {
+        wrapper.RequestContextCancel(request._context);
+      }
+      request._callbackHandler.controller.addError(error);
+    }
+  }
+
+  /// Drops a request that was never closed from its client.
+  ///
+  /// This is not a part of public api.
+  void discard() {
+    _callbackHandler.receivePort.close();
+    _clientCleanup(this);
+  }
+
+  HttpClientResponse _response() => HttpClientResponseImpl(
+      _callbackHandler.stream, _callbackHandler.redirects);
+
+  // Sends a duplicate of this request once the response is late, and
+  // completes with the response starting first. The other request is
+  // cancelled.
+  //
+  // The duplicate takes a slot of the admission queue of its own, it isn't
+  // sent if none is free.
+  Future<HttpClientResponse> _race(HedgingPolicy policy) {
+    HedgingBudget.deposit();
+    final winner = Completer<HttpClientRequestImpl>();
+    final timer = Timer(policy.delayFor(_uri), () {
+      final admission = _admission;
+      if (winner.isCompleted ||
+          _aborted ||
+          _callbackHandler.done ||
+          !(admission?.hasFreeSlot(_uri.host) ?? true) ||
+          !HedgingBudget.withdraw()) {
+        return;
+      }
+      admission?.take(_uri.host);
+      final hedge = _duplicate();
+      _hedge = hedge;
+      _liveContenders++;
+      if (startAll(_cronetEngine, [hedge]).single != null) {
+        // Released already.
+        _hedge = null;
+        return;
+      }
+      _enter(hedge, winner);
+    });
+    _enter(this, winner);
+    return winner.future.then((request) {
+      timer.cancel();
+      final hedge = _hedge;
+      for (final loser in [this, if (hedge != null) hedge]) {
+        if (identical(loser, request)) continue;
+        if (!loser._callbackHandler.done) {
+          wrapper.RequestContextCancel(loser._context);
+        }
+        loser._callbackHandler.stream.listen(null, onError: (Object _) {});
+      }
+      return request._response();
+    });
+  }
+
+  // Enters [request] into the race for [winner].
+  void _enter(
+      HttpClientRequestImpl request, Completer<HttpClientRequestImpl> winner) {
+    final stopwatch = Stopwatch()..start();
+    request._callbackHandler.responseStarted.then((started) {
+      if (winner.isCompleted) return;
+      if (started) {
+        ResponseLatencies.add(_uri, stopwatch.elapsed);
+        winner.complete(request);
+        return;
+      }
+      // A request ending without a response only wins if nothing else is
+      // left running, its error is reported then.
+      final other = identical(request, this) ? _hedge : this;
+      if (other == null || other._callbackHandler.done) {
+        winner.complete(request);
+      }
+    });
+  }
+
+  // Copy of this request to be sent as its duplicate. It releases its slot of
+  // the admission queue when done.
+  HttpClientRequestImpl _duplicate() {
+    final hedge = HttpClientRequestImpl(
+        _uri, _method, _cronetEngine, (_) => _release(),
+        encoding: encoding, admission: _admission)
+      ..priority = priority
+      ..followRedirects = followRedirects
+      ..maxRedirects = maxRedirects
+      ..redirectPolicy = redirectPolicy
+      ..framing = framing
+      ..connectTimeout = connectTimeout
+      ..readTimeout = readTimeout
+      ..totalTimeout = totalTimeout
+      ..retryPolicy = retryPolicy
+      .._uploadCompression = _uploadCompression
+      .._multipart = _multipart
+      .._aggregateBody = _aggregateBody;
+    hedge._callbackHandler.onStuck = _callbackHandler.onStuck;
+    hedge._headers.setAll(_headers);
+    return hedge;
+  }
+
+  /// Whether [close] or [HttpClient.closeAll] was called on the request.
+  ///
+  /// This is not a part of public api.
+  bool get closed => _closed != null;
+
+  /// Marks the request as closed by [HttpClient.closeAll], [close] then
+  /// returns [response].
+  ///
+  /// This is not a part of public api.
+  set closedWith(Future<HttpClientResponse> response) {
+    assert(!closed);
+    _closed = response;
   }
 
   /// Closes the request for input.
   ///
   /// Returns [Future] of [HttpClientResponse] which can be listened to the
   /// server response. Throws [UrlRequestError] if request can't be initiated.
+  /// The request is only started once, later calls return the same future.
   @override
-  Future<HttpClientResponse> close() {
-    return Future(() {
-      _headers.isImmutable = isImmutable = true;
-      _startRequest();
-      return HttpClientResponseImpl(_callbackHandler.stream);
+  Future<HttpClientResponse> close() => _closed ??= _close();
+
+  Future<HttpClientResponse> _close() {
+    final admitted = Completer<void>();
+    if (admit((error) => error == null
+        ? admitted.complete()
+        : admitted.completeError(error))) {
+      admitted.complete();
+    }
+    return admitted.future.then((_) {
+      final error = startAll(_cronetEngine, [this]).single;
+      if (error != null) throw error;
+      final hedging = this.hedging;
+      if (hedging != null &&
+          (_method == 'GET' || _method == 'HEAD') &&
+          _bytesToUpload.isEmpty) {
+        return _race(hedging);
+      }
+      return _response();
     });
   }
 
@@ -191,21 +672,37 @@ class HttpClientRequestImpl implements HttpClientRequest {
   @override
   Future<HttpClientResponse> get done => close();
 
-  /// Follow the redirects.
-  @override
-  bool get followRedirects => _callbackHandler.followRedirects;
-  @override
-  set followRedirects(bool follow) {
-    _callbackHandler.followRedirects = follow;
+  /// Closes the request and writes the response body natively into the file
+  /// at [path], from [offset] on.
+  ///
+  /// If the request asks for a byte range, [length] is its length. The
+  /// request then fails unless the server answers with no more than that
+  /// range. [onProgress] is called with the bytes written so far, every
+  /// megabyte or so and once the body is complete.
+  ///
+  /// Completes with what the response says about the object.
+  ///
+  /// This is not a part of public api.
+  Future<SinkInfo> writeTo(String path, int offset,
+      {int? length, void Function(int written)? onProgress}) async {
+    _sinkPath = path;
+    _sinkOffset = offset;
+    _sinkLength = length ?? -1;
+    _callbackHandler
+      ..sinkPath = path
+      ..onSinkProgress = onProgress;
+    await (await close()).drain<void>();
+    final info = _callbackHandler.sinkInfo;
+    if (info == null) throw const HttpException('Request cancelled');
+    return info;
   }
 
-  /// Maximum numbers of redirects to follow.
-  /// Have no effect if [followRedirects] is set to false.
   @override
-  int get maxRedirects => _callbackHandler.maxRedirects;
-  @override
-  set maxRedirects(int redirects) {
-    _callbackHandler.maxRedirects = redirects;
+  Future<Uint8List> readAsBytes() async {
+    _aggregateBody = true;
+    final chunks = await (await close()).toList();
+    // Only a single chunk is emitted, unless the response failed early.
+    return chunks.isEmpty ? Uint8List(0) : chunks.single as Uint8List;
   }
 
   /// The uri of the request.
@@ -215,6 +712,9 @@ class HttpClientRequestImpl implements HttpClientRequest {
   @override
   void add(List<int> data) {
     if (isImmutable) throw StateError('Can not mutate the request body');
+    if (_multipart != null) {
+      throw StateError('The request is sent with a multipart body');
+    }
     _dataToUpload.add(data);
   }
 
@@ -4,13 +4,20 @@
 
 import 'dart:async';
 
+import 'redirect_policy.dart';
+
 /// Represents the server's response to a request.
 ///
 /// The body of a [HttpClientResponse] object is a [Stream] of data from the
 /// server.
 /// Listen to the body to handle the data and be notified when the entire body
 /// is received.
-abstract class HttpClientResponse extends Stream<List<int>> {}
+abstract class HttpClientResponse extends Stream<List<int>> {
+  /// Redirects followed to get to this response, in order.
+  ///
+  /// Filled in once the response headers are received.
+  List<RedirectInfo> get redirects;
+}
 
 /// Implementation of [HttpClientResponse].
 ///
@@ -18,7 +25,9 @@ abstract class HttpClientResponse extends Stream<List<int>> {}
 /// stream.
 class HttpClientResponseImpl extends HttpClientResponse {
   final Stream<List<int>> cbhStream;
-  HttpClientResponseImpl(this.cbhStream);
+  @override
+  final List<RedirectInfo> redirects;
+  HttpClientResponseImpl(this.cbhStream, this.redirects);
 
   @override
   StreamSubscription<List<int>> listen(void Function(List<int> event)? onData,
@@ -2,13 +2,9 @@
 // for details. All rights reserved. Use of this source code is governed by a
 // BSD-style license that can be found in the LICENSE file.
 
+import 'dart:convert';
 import 'dart:ffi';
 
-import 'package:ffi/ffi.dart';
-
-import 'globals.dart';
-import 'third_party/cronet/generated_bindings.dart';
-
 /// Headers for HTTP requests.
 ///
 /// In some situations, headers are immutable:
@@ -25,26 +21,71 @@ import 'third_party/cronet/generated_bindings.dart';
 /// ```
 abstract class HttpHeaders {
   /// Sets the header [name] to [value].
+  ///
+  /// Throws [ArgumentError] if [name] or [value] contains a NUL character.
   void set(String name, Object value);
 }
 
 /// Implementation of [HttpHeaders].
+///
+/// Headers are accumulated on the Dart side and handed to the wrapper as a
+/// single packed block when the request is started.
 class HttpHeadersImpl implements HttpHeaders {
-  final Pointer<Cronet_UrlRequestParams> _requestParams;
+  // Keyed by the lowercased header name.
+  final _headers = <String, MapEntry<List<int>, List<int>>>{};
   bool isImmutable = false;
 
-  HttpHeadersImpl(this._requestParams);
+  /// Number of headers.
+  int get length => _headers.length;
 
   @override
   void set(String name, Object value) {
     if (isImmutable) {
       throw StateError('Can not write headers in immutable state.');
     }
-    final header = cronet.Cronet_HttpHeader_Create();
-    cronet.Cronet_HttpHeader_name_set(header, name.toNativeUtf8().cast());
-    cronet.Cronet_HttpHeader_value_set(
-        header, value.toString().toNativeUtf8().cast());
-    cronet.Cronet_UrlRequestParams_request_headers_add(_requestParams, header);
-    cronet.Cronet_HttpHeader_Destroy(header);
+    final text = value.toString();
+    // NUL terminates the names and values of the packed block.
+    if (name.contains('\u0000')) {
+      throw ArgumentError.value(name, 'name', 'Must not contain NUL');
+    }
+    if (text.contains('\u0000')) {
+      throw ArgumentError.value(text, 'value', 'Must not contain NUL');
+    }
+    _headers[name.toLowerCase()] =
+        MapEntry(utf8.encode(name), utf8.encode(text));
+  }
+
+  /// Sets every header of [other].
+  ///
+  /// This is not a part of public api.
+  void setAll(HttpHeadersImpl other) {
+    if (isImmutable) {
+      throw StateError('Can not write headers in immutable state.');
+    }
+    _headers.addAll(other._headers);
+  }
+
+  /// Packs the headers as null terminated name and value pairs into a single
+  /// block allocated with [allocator].
+  ///
+  /// This is not a part of public api.
+  Pointer<Int8> pack(Allocator allocator) {
+    if (_headers.isEmpty) return nullptr;
+    var size = 0;
+    for (final header in _headers.values) {
+      size += header.key.length + header.value.length + 2;
+    }
+    final block = allocator<Uint8>(size);
+    final bytes = block.asTypedList(size);
+    var offset = 0;
+    for (final header in _headers.values) {
+      bytes.setAll(offset, header.key);
+      offset += header.key.length;
+      bytes[offset++] = 0;
+      bytes.setAll(offset, header.value);
+      offset += header.value.length;
+      bytes[offset++] = 0;
+    }
+    return block.cast();
   }
 }
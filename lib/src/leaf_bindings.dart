@@ -0,0 +1,54 @@
+// Copyright (c) 2021, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+import 'dart:ffi';
+
+import 'third_party/cronet/generated_bindings.dart';
+import 'wrapper/generated_bindings.dart' as wrpr;
+
+/// Bindings of the functions called for every chunk of a body or every
+/// callback, made as leaf calls and all resolved at once when created.
+///
+/// A leaf call skips the transition of the calling thread out of Dart and
+/// back, so the functions must neither call into Dart or the Dart API nor
+/// block for long. The generated bindings look symbols up on first use and
+/// make full transitions, ffigen can't generate leaf calls yet.
+class LeafBindings {
+  final Pointer<Void> Function(Pointer<Cronet_Buffer> self) bufferGetData;
+  final int Function(Pointer<Cronet_Buffer> self) bufferGetSize;
+  final void Function(
+          Pointer<Cronet_UploadDataSink> self, int bytesRead, int finalChunk)
+      uploadDataSinkOnReadSucceeded;
+  final void Function(Pointer<Cronet_UploadDataSink> self)
+      uploadDataSinkOnRewindSucceeded;
+  final int Function(Pointer<wrpr.RequestContext> self) requestContextRead;
+  final void Function(int port) traceDartHandled;
+
+  LeafBindings(DynamicLibrary cronet, DynamicLibrary wrapper)
+      : bufferGetData = cronet.lookupFunction<
+            Pointer<Void> Function(Pointer<Cronet_Buffer>),
+            Pointer<Void> Function(
+                Pointer<Cronet_Buffer>)>('Cronet_Buffer_GetData', isLeaf: true),
+        bufferGetSize = cronet.lookupFunction<
+            Uint64 Function(Pointer<Cronet_Buffer>),
+            int Function(
+                Pointer<Cronet_Buffer>)>('Cronet_Buffer_GetSize', isLeaf: true),
+        uploadDataSinkOnReadSucceeded = cronet.lookupFunction<
+                Void Function(Pointer<Cronet_UploadDataSink>, Uint64, Uint8),
+                void Function(Pointer<Cronet_UploadDataSink>, int, int)>(
+            'Cronet_UploadDataSink_OnReadSucceeded',
+            isLeaf: true),
+        uploadDataSinkOnRewindSucceeded = cronet.lookupFunction<
+                Void Function(Pointer<Cronet_UploadDataSink>),
+                void Function(Pointer<Cronet_UploadDataSink>)>(
+            'Cronet_UploadDataSink_OnRewindSucceeded',
+            isLeaf: true),
+        requestContextRead = wrapper.lookupFunction<
+                Int32 Function(Pointer<wrpr.RequestContext>),
+                int Function(Pointer<wrpr.RequestContext>)>(
+            'RequestContextRead',
+            isLeaf: true),
+        traceDartHandled = wrapper.lookupFunction<Void Function(Int64),
+            void Function(int)>('TraceDartHandled', isLeaf: true);
+}
@@ -0,0 +1,44 @@
+// Copyright (c) 2021, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+import 'enums.dart';
+
+/// A request of an [HttpClient] that has been started and isn't done yet, see
+/// [HttpClient.liveRequests].
+class LiveRequest {
+  /// URL the request was opened with.
+  final Uri url;
+
+  /// Time since the request was started.
+  final Duration age;
+
+  /// Time since the request last moved: transferred bytes, followed a
+  /// redirect or changed its [state].
+  final Duration idle;
+
+  /// Bytes of the request body handed to the network stack so far.
+  final int bytesSent;
+
+  /// Bytes of the response body received so far.
+  final int bytesReceived;
+
+  /// Redirects followed so far.
+  final int redirects;
+
+  /// What the request was last seen busy with. Only known while the client
+  /// watches for stuck requests, [LoadState.invalid] otherwise.
+  final LoadState state;
+
+  /// Whether the request made no progress for the stuck request threshold of
+  /// the client.
+  final bool stuck;
+
+  const LiveRequest(this.url, this.age, this.idle, this.bytesSent,
+      this.bytesReceived, this.redirects, this.state, this.stuck);
+
+  @override
+  String toString() => 'LiveRequest(url: $url, age: $age, idle: $idle, '
+      'bytesSent: $bytesSent, bytesReceived: $bytesReceived, '
+      'redirects: $redirects, state: $state, stuck: $stuck)';
+}
@@ -0,0 +1,70 @@
+// Copyright (c) 2021, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+import 'dart:convert';
+
+/// A part of a `multipart/form-data` request body, see
+/// [HttpClientRequest.multipart].
+class MultipartPart {
+  /// Name of the form field.
+  final String name;
+
+  /// File name the part is sent with, if any.
+  final String? filename;
+
+  /// `Content-Type` of the part, if any. Must not hold a line break.
+  final String? contentType;
+
+  /// Content of an in memory part. Null for a file part.
+  final List<int>? bytes;
+
+  /// File the content of a file part is read from. Null for an in memory part.
+  final String? path;
+
+  /// Offset in [path] the content starts at.
+  final int offset;
+
+  /// Bytes of [path] sent, or null to send the rest of the file.
+  final int? length;
+
+  /// A form field with a text [value], sent UTF-8 encoded.
+  MultipartPart.field(String name, String value)
+      : this.bytes(name, utf8.encode(value));
+
+  /// A part with [bytes] as its content.
+  MultipartPart.bytes(this.name, List<int> this.bytes,
+      {this.filename, this.contentType})
+      : path = null,
+        offset = 0,
+        length = null {
+    _checkContentType(contentType);
+  }
+
+  /// A part with the content of the file at [path], from [offset] and for
+  /// [length] bytes or up to its end.
+  ///
+  /// The file is read natively while the part is being uploaded, it is never
+  /// held in memory as a whole. Its length is determined when the request is
+  /// started and must not change until the request is done. [filename]
+  /// defaults to the last segment of [path].
+  MultipartPart.file(this.name, String this.path,
+      {String? filename, this.contentType, this.offset = 0, this.length})
+      : filename = filename ?? path.split(RegExp(r'[/\\]')).last,
+        bytes = null {
+    _checkContentType(contentType);
+    RangeError.checkNotNegative(offset, 'offset');
+    final length = this.length;
+    if (length != null) RangeError.checkNotNegative(length, 'length');
+  }
+
+  // A line break would let the content type add headers of its own to the
+  // part, or end it.
+  static void _checkContentType(String? contentType) {
+    if (contentType != null &&
+        (contentType.contains('\r') || contentType.contains('\n'))) {
+      throw ArgumentError.value(
+          contentType, 'contentType', 'Must not contain a line break');
+    }
+  }
+}
@@ -0,0 +1,119 @@
+// Copyright (c) 2021, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+import 'dart:ffi';
+import 'dart:isolate';
+
+import 'package:ffi/ffi.dart';
+
+import 'globals.dart';
+
+/// What the native memory held by the wrapper is used for.
+enum NativeMemoryCategory {
+  /// Buffers the response bodies are read into, 32 KiB per request.
+  cronetBuffers,
+
+  /// Arguments of the callbacks posted with `CallbackBackend.messages`,
+  /// until they are garbage collected.
+  callbackArguments,
+
+  /// Strings copied for Dart: status texts, error messages, validators and
+  /// URLs.
+  strings,
+
+  /// Providers of request bodies.
+  uploadDataProviders,
+
+  /// Executors running the callbacks of requests, one thread each.
+  executors,
+
+  /// Entries mapping requests to the ports their callbacks are posted to.
+  requestPorts,
+}
+
+/// Native memory of one [NativeMemoryCategory].
+class NativeMemoryUsage {
+  final int liveBytes;
+  final int peakBytes;
+  final int liveObjects;
+  final int peakObjects;
+
+  const NativeMemoryUsage(
+      this.liveBytes, this.peakBytes, this.liveObjects, this.peakObjects);
+
+  @override
+  String toString() => 'NativeMemoryUsage(liveBytes: $liveBytes, '
+      'peakBytes: $peakBytes, liveObjects: $liveObjects, '
+      'peakObjects: $peakObjects)';
+}
+
+/// Native memory held by the wrapper for all the clients of the process, as
+/// counted by the wrapper itself. Memory held by Cronet, such as its
+/// connection pools and caches, isn't included.
+class NativeMemoryStats {
+  final Map<NativeMemoryCategory, NativeMemoryUsage> categories;
+
+  /// Bytes held across the categories.
+  final int liveBytes;
+
+  /// Largest [liveBytes] so far.
+  final int peakBytes;
+
+  const NativeMemoryStats(this.categories, this.liveBytes, this.peakBytes);
+
+  /// Threads run by the executors.
+  int get executorThreads =>
+      categories[NativeMemoryCategory.executors]!.liveObjects;
+
+  // Values written by ReadMemoryStats.
+  static final _length = 4 * NativeMemoryCategory.values.length + 2;
+
+  static ReceivePort? _alertPort;
+
+  /// Reads the counters in a single native call.
+  static NativeMemoryStats read() {
+    final stats = malloc<Int64>(_length);
+    try {
+      wrapper.ReadMemoryStats(stats);
+      final categories = <NativeMemoryCategory, NativeMemoryUsage>{};
+      for (final category in NativeMemoryCategory.values) {
+        final i = 4 * category.index;
+        categories[category] = NativeMemoryUsage(
+            stats[i], stats[i + 1], stats[i + 2], stats[i + 3]);
+      }
+      return NativeMemoryStats(
+          categories, stats[_length - 2], stats[_length - 1]);
+    } finally {
+      malloc.free(stats);
+    }
+  }
+
+  /// Calls [onAlert] with [liveBytes] once they reach [thresholdBytes], and
+  /// again each time they do after going back below three quarters of it.
+  /// A null [onAlert] removes the alert.
+  ///
+  /// The check is made natively as memory is allocated. The alert keeps the
+  /// isolate alive until removed.
+  static void setAlert(
+      int thresholdBytes, void Function(int liveBytes)? onAlert) {
+    _alertPort?.close();
+    _alertPort = null;
+    if (onAlert == null) {
+      wrapper.SetMemoryAlert(0, 0);
+      return;
+    }
+    if (thresholdBytes <= 0) {
+      throw ArgumentError.value(
+          thresholdBytes, 'thresholdBytes', 'Must be positive');
+    }
+    final port = ReceivePort();
+    port.listen((dynamic liveBytes) => onAlert(liveBytes as int));
+    _alertPort = port;
+    wrapper.SetMemoryAlert(thresholdBytes, port.sendPort.nativePort);
+  }
+
+  @override
+  String toString() => 'NativeMemoryStats(liveBytes: $liveBytes, '
+      'peakBytes: $peakBytes, categories: $categories)';
+}
@@ -0,0 +1,287 @@
+// Copyright (c) 2021, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+import 'dart:async';
+import 'dart:convert';
+import 'dart:ffi';
+import 'dart:io' as io;
+import 'dart:math' as m;
+
+import 'package:ffi/ffi.dart';
+
+import 'exceptions.dart';
+import 'globals.dart';
+import 'http_callback_handler.dart';
+import 'http_client_request.dart';
+import 'retry_policy.dart';
+
+/// Outcome of [HttpClient.download].
+class DownloadResult {
+  /// Length of the downloaded object.
+  final int length;
+
+  /// Byte ranges the object was fetched in. 0 if the server doesn't serve
+  /// ranges, the object was then fetched in a single response.
+  final int ranges;
+
+  /// Bytes that were already downloaded by a previous, failed attempt.
+  final int resumed;
+
+  const DownloadResult(this.length, this.ranges, this.resumed);
+
+  @override
+  String toString() =>
+      'DownloadResult(length: $length, ranges: $ranges, resumed: $resumed)';
+}
+
+// A byte range of the object, [start] included and [end] excluded.
+class _Range {
+  final int start;
+  final int end;
+
+  // Bytes of the range in the file already.
+  int written;
+
+  _Range(this.start, this.end, this.written);
+
+  int get remaining => end - start - written;
+
+  List<int> toJson() => [start, end, written];
+}
+
+// Progress of a ranged download, saved next to the file so that the download
+// can be resumed.
+class _Checkpoint {
+  final String url;
+  final int length;
+  final String? validator;
+  final List<_Range> ranges;
+
+  _Checkpoint(this.url, this.length, this.validator, this.ranges);
+
+  int get written => ranges.fold(0, (sum, range) => sum + range.written);
+
+  static _Checkpoint? parse(String json) {
+    try {
+      final map = jsonDecode(json) as Map<String, dynamic>;
+      return _Checkpoint(
+          map['url'] as String,
+          map['length'] as int,
+          map['validator'] as String?,
+          [
+            for (final range in map['ranges'] as List<dynamic>)
+              _Range((range as List<dynamic>)[0] as int, range[1] as int,
+                  range[2] as int)
+          ]);
+    } on FormatException {
+      return null;
+    } on TypeError {
+      return null;
+    }
+  }
+
+  String toJson() => jsonEncode({
+        'url': url,
+        'length': length,
+        'validator': validator,
+        'ranges': [for (final range in ranges) range.toJson()],
+      });
+}
+
+/// Downloads an object into a file in concurrent byte ranges.
+///
+/// This is not a part of public api.
+class RangeDownload {
+  // How often the checkpoint is saved while ranges are running.
+  static const _checkpointInterval = Duration(seconds: 1);
+
+  final Future<HttpClientRequest> Function(String method, Uri url) _open;
+  final Uri url;
+  final String path;
+  final int parallelism;
+  final int minRangeSize;
+  final RetryPolicy? retryPolicy;
+
+  late final _checkpointFile = io.File('$path.download');
+  // Saves of the checkpoint, chained so that they don't overlap.
+  var _saving = Future<void>.value();
+  var _dirty = false;
+
+  RangeDownload(this._open, this.url, this.path,
+      {required this.parallelism,
+      required this.minRangeSize,
+      required this.retryPolicy});
+
+  Future<DownloadResult> run() async {
+    var checkpoint = await _loadCheckpoint();
+    var resumed = 0;
+    if (checkpoint == null) {
+      final info = await _probe();
+      if (info.statusCode != 206 || info.length <= 0) {
+        return _runSingle(info.length);
+      }
+      checkpoint = _Checkpoint(
+          url.toString(), info.length, info.validator, _split(info.length));
+      _preallocate(info.length);
+      await _save(checkpoint);
+    } else {
+      resumed = checkpoint.written;
+    }
+    await _runRanges(checkpoint);
+    await _saving;
+    await _checkpointFile.delete();
+    return DownloadResult(checkpoint.length, checkpoint.ranges.length, resumed);
+  }
+
+  // Checkpoint of a previous attempt at downloading [url] into [path], if the
+  // file it describes is still there.
+  Future<_Checkpoint?> _loadCheckpoint() async {
+    if (!await _checkpointFile.exists()) return null;
+    final checkpoint = _Checkpoint.parse(await _checkpointFile.readAsString());
+    final file = io.File(path);
+    if (checkpoint == null ||
+        checkpoint.url != url.toString() ||
+        !await file.exists() ||
+        await file.length() != checkpoint.length) {
+      return null;
+    }
+    return checkpoint;
+  }
+
+  Future<HttpClientRequestImpl> _request(String method) async {
+    final request = await _open(method, url) as HttpClientRequestImpl;
+    // Ranges are offsets into the encoded body, it must not be decoded.
+    request.headers.set('Accept-Encoding', 'identity');
+    request.retryPolicy = retryPolicy;
+    return request;
+  }
+
+  // Asks for the first byte of the object, which tells its length and whether
+  // it is served in ranges. A server that doesn't serve ranges answers with
+  // the whole object instead, which isn't written.
+  Future<SinkInfo> _probe() async {
+    final request = await _request('GET');
+    request.headers.set('Range', 'bytes=0-0');
+    try {
+      return await request.writeTo(path, 0, length: 1);
+    } on HttpException {
+      final info = request.callbackHandler.sinkInfo;
+      if (info == null || info.statusCode != 200) rethrow;
+      return info;
+    }
+  }
+
+  // Splits an object of [length] bytes into [parallelism] ranges of at least
+  // [minRangeSize] bytes.
+  List<_Range> _split(int length) {
+    final count = m.max(1, m.min(parallelism, length ~/ minRangeSize));
+    final size = (length + count - 1) ~/ count;
+    return [
+      for (var start = 0; start < length; start += size)
+        _Range(start, m.min(start + size, length), 0)
+    ];
+  }
+
+  void _preallocate(int length) {
+    final error = using((Arena arena) => wrapper.FileSinkPreallocate(
+        path.toNativeUtf8(allocator: arena).cast(), length));
+    if (error != 0) {
+      throw io.FileSystemException(
+          'Preallocating the file failed', path, io.OSError('', error));
+    }
+  }
+
+  // Fetches the object in a single response, for servers that don't serve
+  // ranges. Such a download can't be resumed.
+  Future<DownloadResult> _runSingle(int length) async {
+    _preallocate(m.max(length, 0));
+    final request = await _request('GET');
+    var written = 0;
+    await request.writeTo(path, 0, onProgress: (bytes) => written = bytes);
+    if (written != length) _preallocate(written);
+    return DownloadResult(written, 0, 0);
+  }
+
+  Future<void> _runRanges(_Checkpoint checkpoint) async {
+    final pending = [
+      for (final range in checkpoint.ranges)
+        if (range.remaining > 0) range
+    ];
+    final requests = <HttpClientRequestImpl>[];
+    Object? error;
+    StackTrace? stackTrace;
+    var discard = false;
+    final timer = Timer.periodic(_checkpointInterval, (_) {
+      if (_dirty) _save(checkpoint);
+    });
+    try {
+      await Future.wait(pending.map((range) async {
+        // Another range failed already.
+        if (error != null) return;
+        final request = await _request('GET');
+        if (error != null) {
+          request.discard();
+          return;
+        }
+        final start = range.start + range.written;
+        request.headers.set('Range', 'bytes=$start-${range.end - 1}');
+        final validator = checkpoint.validator;
+        if (validator != null) request.headers.set('If-Range', validator);
+        requests.add(request);
+        final written = range.written;
+        try {
+          final info = await request.writeTo(path, start,
+              length: range.end - start, onProgress: (bytes) {
+            range.written = written + bytes;
+            _dirty = true;
+          });
+          if (info.length != checkpoint.length) {
+            throw HttpException('$url changed during the download', uri: url);
+          }
+          if (range.remaining > 0) {
+            throw HttpException('Byte range ended early', uri: url);
+          }
+        } catch (e, s) {
+          // A full response instead of the range means the object changed.
+          final info = request.callbackHandler.sinkInfo;
+          if (info != null &&
+              (info.statusCode == 200 || info.length != checkpoint.length)) {
+            discard = true;
+          }
+          if (error == null) {
+            error = e;
+            stackTrace = s;
+            // The other ranges are stopped, they are resumed along with this
+            // one.
+            for (final other in requests) {
+              if (!identical(other, request)) other.abort(e);
+            }
+          }
+        }
+      }));
+    } finally {
+      timer.cancel();
+    }
+    if (error != null) {
+      if (discard) {
+        await _saving;
+        await _checkpointFile.delete();
+      } else {
+        await _save(checkpoint);
+      }
+      return Future.error(error!, stackTrace);
+    }
+  }
+
+  Future<void> _save(_Checkpoint checkpoint) {
+    _dirty = false;
+    final json = checkpoint.toJson();
+    // Replaced in one go, a crash never leaves half a checkpoint behind.
+    final temporary = io.File('${_checkpointFile.path}.tmp');
+    return _saving = _saving.then((_) async {
+      await temporary.writeAsString(json, flush: true);
+      await temporary.rename(_checkpointFile.path);
+    });
+  }
+}
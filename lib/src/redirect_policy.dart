@@ -0,0 +1,42 @@
+// Copyright (c) 2021, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+/// Rules the redirects of a request are checked against.
+///
+/// The policy is applied natively as each redirect is received, so following
+/// a redirect doesn't involve the Dart side. A redirect breaking the policy
+/// fails the response with a [RedirectException].
+class RedirectPolicy {
+  /// Only follow redirects that stay on the origin of the request.
+  final bool sameOriginOnly;
+
+  /// URL schemes redirects may lead to. Only `http` and `https` are supported.
+  final Set<String> allowedSchemes;
+
+  /// Don't let the credentials of a request leak to another origin.
+  ///
+  /// Cronet can't remove the headers of a redirected request, so a cross
+  /// origin redirect of a request with an `Authorization` or `Cookie` header
+  /// is refused instead of being followed without them.
+  final bool stripAuthOnCrossOrigin;
+
+  const RedirectPolicy(
+      {this.sameOriginOnly = false,
+      this.allowedSchemes = const {'http', 'https'},
+      this.stripAuthOnCrossOrigin = true});
+}
+
+/// A redirect followed by a request.
+class RedirectInfo {
+  /// Status code of the redirect response.
+  final int statusCode;
+
+  /// Location the request was redirected to.
+  final Uri location;
+
+  const RedirectInfo(this.statusCode, this.location);
+
+  @override
+  String toString() => 'RedirectInfo($statusCode, $location)';
+}
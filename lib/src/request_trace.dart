@@ -0,0 +1,51 @@
+// Copyright (c) 2021, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+import 'package:ffi/ffi.dart';
+
+import 'globals.dart';
+
+/// Records the lifecycle of every request natively, for chrome://tracing and
+/// Perfetto.
+///
+/// While [enabled], each request gets a track of its own, from its creation
+/// to its completion, with the start of each attempt, redirects, the start of
+/// the response, every chunk read, every callback posted to Dart and when
+/// Dart got to it. Events are kept in a ring buffer per native thread, the
+/// oldest ones are overwritten once it is full.
+///
+/// ```dart
+/// RequestTrace.enabled = true;
+/// // Make requests...
+/// File('trace.json').writeAsStringSync(RequestTrace.export());
+/// ```
+///
+/// Events are only recorded if the wrapper was built with `CRONET_TRACING`,
+/// which it is by default. While disabled, tracing costs next to nothing.
+class RequestTrace {
+  RequestTrace._();
+
+  static bool _enabled = false;
+
+  static bool get enabled => _enabled;
+
+  static set enabled(bool enabled) {
+    wrapper.SetTracingEnabled(enabled ? 1 : 0);
+    _enabled = enabled;
+  }
+
+  /// The events recorded since the start or the last [clear], as Chrome
+  /// trace event JSON.
+  static String export() {
+    final json = wrapper.ExportTrace().cast<Utf8>();
+    try {
+      return json.toDartString();
+    } finally {
+      malloc.free(json);
+    }
+  }
+
+  /// Leaves the events recorded so far out of later exports.
+  static void clear() => wrapper.ClearTrace();
+}
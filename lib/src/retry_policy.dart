@@ -0,0 +1,38 @@
+// Copyright (c) 2021, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+/// When a request failing with a transient network error is sent again.
+///
+/// Retries happen natively, the same request is started again on the same
+/// engine after a backoff, without involving the Dart side. Only idempotent
+/// requests without a body are retried, and only as long as their response
+/// hasn't started. The error of the last attempt is reported if they all
+/// fail.
+class RetryPolicy {
+  /// Attempts made in total, the first one included.
+  final int maxAttempts;
+
+  /// Backoff before the first retry, doubled for every further retry.
+  ///
+  /// The actual delay is picked at random between zero and the backoff, so
+  /// that requests failing together don't retry together. Errors Cronet deems
+  /// immediately retryable are retried without delay.
+  final Duration initialBackoff;
+
+  /// Upper bound of the backoff.
+  final Duration maxBackoff;
+
+  /// Share of a retry every request using the policy earns.
+  ///
+  /// Retries are taken from a budget shared by every request, which holds at
+  /// most 10 retries. Once it is spent, failures are reported right away, so
+  /// that retries can't multiply the load during an outage.
+  final double budgetRatio;
+
+  const RetryPolicy(
+      {this.maxAttempts = 3,
+      this.initialBackoff = const Duration(milliseconds: 100),
+      this.maxBackoff = const Duration(seconds: 5),
+      this.budgetRatio = 0.1});
+}
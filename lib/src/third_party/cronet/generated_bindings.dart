@@ -47,7 +47,7 @@ class Cronet {
   }
 
   late final _Cronet_Buffer_Destroy_ptr =
-      _lookup<ffi.NativeFunction<_c_Cronet_Buffer_Destroy>>(
+      _lookup<ffi.NativeFunction<Native_Cronet_Buffer_Destroy>>(
           'Cronet_Buffer_Destroy');
   late final _dart_Cronet_Buffer_Destroy _Cronet_Buffer_Destroy =
       _Cronet_Buffer_Destroy_ptr.asFunction<_dart_Cronet_Buffer_Destroy>();
@@ -132,7 +132,7 @@ class Cronet {
   }
 
   late final _Cronet_Buffer_GetSize_ptr =
-      _lookup<ffi.NativeFunction<_c_Cronet_Buffer_GetSize>>(
+      _lookup<ffi.NativeFunction<Native_Cronet_Buffer_GetSize>>(
           'Cronet_Buffer_GetSize');
   late final _dart_Cronet_Buffer_GetSize _Cronet_Buffer_GetSize =
       _Cronet_Buffer_GetSize_ptr.asFunction<_dart_Cronet_Buffer_GetSize>();
@@ -146,7 +146,7 @@ class Cronet {
   }
 
   late final _Cronet_Buffer_GetData_ptr =
-      _lookup<ffi.NativeFunction<_c_Cronet_Buffer_GetData>>(
+      _lookup<ffi.NativeFunction<Native_Cronet_Buffer_GetData>>(
           'Cronet_Buffer_GetData');
   late final _dart_Cronet_Buffer_GetData _Cronet_Buffer_GetData =
       _Cronet_Buffer_GetData_ptr.asFunction<_dart_Cronet_Buffer_GetData>();
@@ -651,7 +651,7 @@ class Cronet {
   }
 
   late final _Cronet_UrlRequestStatusListener_Destroy_ptr =
-      _lookup<ffi.NativeFunction<_c_Cronet_UrlRequestStatusListener_Destroy>>(
+      _lookup<ffi.NativeFunction<Native_Cronet_UrlRequestStatusListener_Destroy>>(
           'Cronet_UrlRequestStatusListener_Destroy');
   late final _dart_Cronet_UrlRequestStatusListener_Destroy
       _Cronet_UrlRequestStatusListener_Destroy =
@@ -670,7 +670,7 @@ class Cronet {
 
   late final _Cronet_UrlRequestStatusListener_SetClientContext_ptr = _lookup<
           ffi.NativeFunction<
-              _c_Cronet_UrlRequestStatusListener_SetClientContext>>(
+              Native_Cronet_UrlRequestStatusListener_SetClientContext>>(
       'Cronet_UrlRequestStatusListener_SetClientContext');
   late final _dart_Cronet_UrlRequestStatusListener_SetClientContext
       _Cronet_UrlRequestStatusListener_SetClientContext =
@@ -687,7 +687,7 @@ class Cronet {
 
   late final _Cronet_UrlRequestStatusListener_GetClientContext_ptr = _lookup<
           ffi.NativeFunction<
-              _c_Cronet_UrlRequestStatusListener_GetClientContext>>(
+              Native_Cronet_UrlRequestStatusListener_GetClientContext>>(
       'Cronet_UrlRequestStatusListener_GetClientContext');
   late final _dart_Cronet_UrlRequestStatusListener_GetClientContext
       _Cronet_UrlRequestStatusListener_GetClientContext =
@@ -724,7 +724,7 @@ class Cronet {
   }
 
   late final _Cronet_UrlRequestStatusListener_CreateWith_ptr = _lookup<
-          ffi.NativeFunction<_c_Cronet_UrlRequestStatusListener_CreateWith>>(
+          ffi.NativeFunction<Native_Cronet_UrlRequestStatusListener_CreateWith>>(
       'Cronet_UrlRequestStatusListener_CreateWith');
   late final _dart_Cronet_UrlRequestStatusListener_CreateWith
       _Cronet_UrlRequestStatusListener_CreateWith =
@@ -741,7 +741,7 @@ class Cronet {
   }
 
   late final _Cronet_UrlRequestCallback_Destroy_ptr =
-      _lookup<ffi.NativeFunction<_c_Cronet_UrlRequestCallback_Destroy>>(
+      _lookup<ffi.NativeFunction<Native_Cronet_UrlRequestCallback_Destroy>>(
           'Cronet_UrlRequestCallback_Destroy');
   late final _dart_Cronet_UrlRequestCallback_Destroy
       _Cronet_UrlRequestCallback_Destroy =
@@ -759,7 +759,7 @@ class Cronet {
   }
 
   late final _Cronet_UrlRequestCallback_SetClientContext_ptr = _lookup<
-          ffi.NativeFunction<_c_Cronet_UrlRequestCallback_SetClientContext>>(
+          ffi.NativeFunction<Native_Cronet_UrlRequestCallback_SetClientContext>>(
       'Cronet_UrlRequestCallback_SetClientContext');
   late final _dart_Cronet_UrlRequestCallback_SetClientContext
       _Cronet_UrlRequestCallback_SetClientContext =
@@ -775,7 +775,7 @@ class Cronet {
   }
 
   late final _Cronet_UrlRequestCallback_GetClientContext_ptr = _lookup<
-          ffi.NativeFunction<_c_Cronet_UrlRequestCallback_GetClientContext>>(
+          ffi.NativeFunction<Native_Cronet_UrlRequestCallback_GetClientContext>>(
       'Cronet_UrlRequestCallback_GetClientContext');
   late final _dart_Cronet_UrlRequestCallback_GetClientContext
       _Cronet_UrlRequestCallback_GetClientContext =
@@ -939,7 +939,7 @@ class Cronet {
   }
 
   late final _Cronet_UrlRequestCallback_CreateWith_ptr =
-      _lookup<ffi.NativeFunction<_c_Cronet_UrlRequestCallback_CreateWith>>(
+      _lookup<ffi.NativeFunction<Native_Cronet_UrlRequestCallback_CreateWith>>(
           'Cronet_UrlRequestCallback_CreateWith');
   late final _dart_Cronet_UrlRequestCallback_CreateWith
       _Cronet_UrlRequestCallback_CreateWith =
@@ -1020,7 +1020,7 @@ class Cronet {
   }
 
   late final _Cronet_UploadDataSink_OnReadSucceeded_ptr =
-      _lookup<ffi.NativeFunction<_c_Cronet_UploadDataSink_OnReadSucceeded>>(
+      _lookup<ffi.NativeFunction<Native_Cronet_UploadDataSink_OnReadSucceeded>>(
           'Cronet_UploadDataSink_OnReadSucceeded');
   late final _dart_Cronet_UploadDataSink_OnReadSucceeded
       _Cronet_UploadDataSink_OnReadSucceeded =
@@ -1038,7 +1038,7 @@ class Cronet {
   }
 
   late final _Cronet_UploadDataSink_OnReadError_ptr =
-      _lookup<ffi.NativeFunction<_c_Cronet_UploadDataSink_OnReadError>>(
+      _lookup<ffi.NativeFunction<Native_Cronet_UploadDataSink_OnReadError>>(
           'Cronet_UploadDataSink_OnReadError');
   late final _dart_Cronet_UploadDataSink_OnReadError
       _Cronet_UploadDataSink_OnReadError =
@@ -1054,7 +1054,7 @@ class Cronet {
   }
 
   late final _Cronet_UploadDataSink_OnRewindSucceeded_ptr =
-      _lookup<ffi.NativeFunction<_c_Cronet_UploadDataSink_OnRewindSucceeded>>(
+      _lookup<ffi.NativeFunction<Native_Cronet_UploadDataSink_OnRewindSucceeded>>(
           'Cronet_UploadDataSink_OnRewindSucceeded');
   late final _dart_Cronet_UploadDataSink_OnRewindSucceeded
       _Cronet_UploadDataSink_OnRewindSucceeded =
@@ -1114,7 +1114,7 @@ class Cronet {
   }
 
   late final _Cronet_UploadDataProvider_Destroy_ptr =
-      _lookup<ffi.NativeFunction<_c_Cronet_UploadDataProvider_Destroy>>(
+      _lookup<ffi.NativeFunction<Native_Cronet_UploadDataProvider_Destroy>>(
           'Cronet_UploadDataProvider_Destroy');
   late final _dart_Cronet_UploadDataProvider_Destroy
       _Cronet_UploadDataProvider_Destroy =
@@ -1132,7 +1132,7 @@ class Cronet {
   }
 
   late final _Cronet_UploadDataProvider_SetClientContext_ptr = _lookup<
-          ffi.NativeFunction<_c_Cronet_UploadDataProvider_SetClientContext>>(
+          ffi.NativeFunction<Native_Cronet_UploadDataProvider_SetClientContext>>(
       'Cronet_UploadDataProvider_SetClientContext');
   late final _dart_Cronet_UploadDataProvider_SetClientContext
       _Cronet_UploadDataProvider_SetClientContext =
@@ -1242,7 +1242,7 @@ class Cronet {
   }
 
   late final _Cronet_UploadDataProvider_CreateWith_ptr =
-      _lookup<ffi.NativeFunction<_c_Cronet_UploadDataProvider_CreateWith>>(
+      _lookup<ffi.NativeFunction<Native_Cronet_UploadDataProvider_CreateWith>>(
           'Cronet_UploadDataProvider_CreateWith');
   late final _dart_Cronet_UploadDataProvider_CreateWith
       _Cronet_UploadDataProvider_CreateWith =
@@ -1255,7 +1255,7 @@ class Cronet {
   }
 
   late final _Cronet_UrlRequest_Create_ptr =
-      _lookup<ffi.NativeFunction<_c_Cronet_UrlRequest_Create>>(
+      _lookup<ffi.NativeFunction<Native_Cronet_UrlRequest_Create>>(
           'Cronet_UrlRequest_Create');
   late final _dart_Cronet_UrlRequest_Create _Cronet_UrlRequest_Create =
       _Cronet_UrlRequest_Create_ptr.asFunction<
@@ -1270,7 +1270,7 @@ class Cronet {
   }
 
   late final _Cronet_UrlRequest_Destroy_ptr =
-      _lookup<ffi.NativeFunction<_c_Cronet_UrlRequest_Destroy>>(
+      _lookup<ffi.NativeFunction<Native_Cronet_UrlRequest_Destroy>>(
           'Cronet_UrlRequest_Destroy');
   late final _dart_Cronet_UrlRequest_Destroy _Cronet_UrlRequest_Destroy =
       _Cronet_UrlRequest_Destroy_ptr.asFunction<
@@ -1329,7 +1329,7 @@ class Cronet {
   }
 
   late final _Cronet_UrlRequest_InitWithParams_ptr =
-      _lookup<ffi.NativeFunction<_c_Cronet_UrlRequest_InitWithParams>>(
+      _lookup<ffi.NativeFunction<Native_Cronet_UrlRequest_InitWithParams>>(
           'Cronet_UrlRequest_InitWithParams');
   late final _dart_Cronet_UrlRequest_InitWithParams
       _Cronet_UrlRequest_InitWithParams = _Cronet_UrlRequest_InitWithParams_ptr
@@ -1344,7 +1344,7 @@ class Cronet {
   }
 
   late final _Cronet_UrlRequest_Start_ptr =
-      _lookup<ffi.NativeFunction<_c_Cronet_UrlRequest_Start>>(
+      _lookup<ffi.NativeFunction<Native_Cronet_UrlRequest_Start>>(
           'Cronet_UrlRequest_Start');
   late final _dart_Cronet_UrlRequest_Start _Cronet_UrlRequest_Start =
       _Cronet_UrlRequest_Start_ptr.asFunction<_dart_Cronet_UrlRequest_Start>();
@@ -1358,7 +1358,7 @@ class Cronet {
   }
 
   late final _Cronet_UrlRequest_FollowRedirect_ptr =
-      _lookup<ffi.NativeFunction<_c_Cronet_UrlRequest_FollowRedirect>>(
+      _lookup<ffi.NativeFunction<Native_Cronet_UrlRequest_FollowRedirect>>(
           'Cronet_UrlRequest_FollowRedirect');
   late final _dart_Cronet_UrlRequest_FollowRedirect
       _Cronet_UrlRequest_FollowRedirect = _Cronet_UrlRequest_FollowRedirect_ptr
@@ -1375,7 +1375,7 @@ class Cronet {
   }
 
   late final _Cronet_UrlRequest_Read_ptr =
-      _lookup<ffi.NativeFunction<_c_Cronet_UrlRequest_Read>>(
+      _lookup<ffi.NativeFunction<Native_Cronet_UrlRequest_Read>>(
           'Cronet_UrlRequest_Read');
   late final _dart_Cronet_UrlRequest_Read _Cronet_UrlRequest_Read =
       _Cronet_UrlRequest_Read_ptr.asFunction<_dart_Cronet_UrlRequest_Read>();
@@ -1389,7 +1389,7 @@ class Cronet {
   }
 
   late final _Cronet_UrlRequest_Cancel_ptr =
-      _lookup<ffi.NativeFunction<_c_Cronet_UrlRequest_Cancel>>(
+      _lookup<ffi.NativeFunction<Native_Cronet_UrlRequest_Cancel>>(
           'Cronet_UrlRequest_Cancel');
   late final _dart_Cronet_UrlRequest_Cancel _Cronet_UrlRequest_Cancel =
       _Cronet_UrlRequest_Cancel_ptr.asFunction<
@@ -1422,7 +1422,7 @@ class Cronet {
   }
 
   late final _Cronet_UrlRequest_GetStatus_ptr =
-      _lookup<ffi.NativeFunction<_c_Cronet_UrlRequest_GetStatus>>(
+      _lookup<ffi.NativeFunction<Native_Cronet_UrlRequest_GetStatus>>(
           'Cronet_UrlRequest_GetStatus');
   late final _dart_Cronet_UrlRequest_GetStatus _Cronet_UrlRequest_GetStatus =
       _Cronet_UrlRequest_GetStatus_ptr.asFunction<
@@ -1677,7 +1677,7 @@ class Cronet {
   }
 
   late final _Cronet_Error_error_code_get_ptr =
-      _lookup<ffi.NativeFunction<_c_Cronet_Error_error_code_get>>(
+      _lookup<ffi.NativeFunction<Native_Cronet_Error_error_code_get>>(
           'Cronet_Error_error_code_get');
   late final _dart_Cronet_Error_error_code_get _Cronet_Error_error_code_get =
       _Cronet_Error_error_code_get_ptr.asFunction<
@@ -1707,7 +1707,7 @@ class Cronet {
   }
 
   late final _Cronet_Error_internal_error_code_get_ptr =
-      _lookup<ffi.NativeFunction<_c_Cronet_Error_internal_error_code_get>>(
+      _lookup<ffi.NativeFunction<Native_Cronet_Error_internal_error_code_get>>(
           'Cronet_Error_internal_error_code_get');
   late final _dart_Cronet_Error_internal_error_code_get
       _Cronet_Error_internal_error_code_get =
@@ -1724,7 +1724,7 @@ class Cronet {
   }
 
   late final _Cronet_Error_immediately_retryable_get_ptr =
-      _lookup<ffi.NativeFunction<_c_Cronet_Error_immediately_retryable_get>>(
+      _lookup<ffi.NativeFunction<Native_Cronet_Error_immediately_retryable_get>>(
           'Cronet_Error_immediately_retryable_get');
   late final _dart_Cronet_Error_immediately_retryable_get
       _Cronet_Error_immediately_retryable_get =
@@ -1740,7 +1740,7 @@ class Cronet {
   }
 
   late final _Cronet_Error_quic_detailed_error_code_get_ptr =
-      _lookup<ffi.NativeFunction<_c_Cronet_Error_quic_detailed_error_code_get>>(
+      _lookup<ffi.NativeFunction<Native_Cronet_Error_quic_detailed_error_code_get>>(
           'Cronet_Error_quic_detailed_error_code_get');
   late final _dart_Cronet_Error_quic_detailed_error_code_get
       _Cronet_Error_quic_detailed_error_code_get =
@@ -2658,7 +2658,7 @@ class Cronet {
   }
 
   late final _Cronet_HttpHeader_Create_ptr =
-      _lookup<ffi.NativeFunction<_c_Cronet_HttpHeader_Create>>(
+      _lookup<ffi.NativeFunction<Native_Cronet_HttpHeader_Create>>(
           'Cronet_HttpHeader_Create');
   late final _dart_Cronet_HttpHeader_Create _Cronet_HttpHeader_Create =
       _Cronet_HttpHeader_Create_ptr.asFunction<
@@ -2673,7 +2673,7 @@ class Cronet {
   }
 
   late final _Cronet_HttpHeader_Destroy_ptr =
-      _lookup<ffi.NativeFunction<_c_Cronet_HttpHeader_Destroy>>(
+      _lookup<ffi.NativeFunction<Native_Cronet_HttpHeader_Destroy>>(
           'Cronet_HttpHeader_Destroy');
   late final _dart_Cronet_HttpHeader_Destroy _Cronet_HttpHeader_Destroy =
       _Cronet_HttpHeader_Destroy_ptr.asFunction<
@@ -2690,7 +2690,7 @@ class Cronet {
   }
 
   late final _Cronet_HttpHeader_name_set_ptr =
-      _lookup<ffi.NativeFunction<_c_Cronet_HttpHeader_name_set>>(
+      _lookup<ffi.NativeFunction<Native_Cronet_HttpHeader_name_set>>(
           'Cronet_HttpHeader_name_set');
   late final _dart_Cronet_HttpHeader_name_set _Cronet_HttpHeader_name_set =
       _Cronet_HttpHeader_name_set_ptr.asFunction<
@@ -2707,7 +2707,7 @@ class Cronet {
   }
 
   late final _Cronet_HttpHeader_value_set_ptr =
-      _lookup<ffi.NativeFunction<_c_Cronet_HttpHeader_value_set>>(
+      _lookup<ffi.NativeFunction<Native_Cronet_HttpHeader_value_set>>(
           'Cronet_HttpHeader_value_set');
   late final _dart_Cronet_HttpHeader_value_set _Cronet_HttpHeader_value_set =
       _Cronet_HttpHeader_value_set_ptr.asFunction<
@@ -2722,7 +2722,7 @@ class Cronet {
   }
 
   late final _Cronet_HttpHeader_name_get_ptr =
-      _lookup<ffi.NativeFunction<_c_Cronet_HttpHeader_name_get>>(
+      _lookup<ffi.NativeFunction<Native_Cronet_HttpHeader_name_get>>(
           'Cronet_HttpHeader_name_get');
   late final _dart_Cronet_HttpHeader_name_get _Cronet_HttpHeader_name_get =
       _Cronet_HttpHeader_name_get_ptr.asFunction<
@@ -2737,7 +2737,7 @@ class Cronet {
   }
 
   late final _Cronet_HttpHeader_value_get_ptr =
-      _lookup<ffi.NativeFunction<_c_Cronet_HttpHeader_value_get>>(
+      _lookup<ffi.NativeFunction<Native_Cronet_HttpHeader_value_get>>(
           'Cronet_HttpHeader_value_get');
   late final _dart_Cronet_HttpHeader_value_get _Cronet_HttpHeader_value_get =
       _Cronet_HttpHeader_value_get_ptr.asFunction<
@@ -3041,7 +3041,7 @@ class Cronet {
   }
 
   late final _Cronet_UrlResponseInfo_all_headers_list_size_ptr = _lookup<
-          ffi.NativeFunction<_c_Cronet_UrlResponseInfo_all_headers_list_size>>(
+          ffi.NativeFunction<Native_Cronet_UrlResponseInfo_all_headers_list_size>>(
       'Cronet_UrlResponseInfo_all_headers_list_size');
   late final _dart_Cronet_UrlResponseInfo_all_headers_list_size
       _Cronet_UrlResponseInfo_all_headers_list_size =
@@ -3059,7 +3059,7 @@ class Cronet {
   }
 
   late final _Cronet_UrlResponseInfo_all_headers_list_at_ptr = _lookup<
-          ffi.NativeFunction<_c_Cronet_UrlResponseInfo_all_headers_list_at>>(
+          ffi.NativeFunction<Native_Cronet_UrlResponseInfo_all_headers_list_at>>(
       'Cronet_UrlResponseInfo_all_headers_list_at');
   late final _dart_Cronet_UrlResponseInfo_all_headers_list_at
       _Cronet_UrlResponseInfo_all_headers_list_at =
@@ -3155,7 +3155,7 @@ class Cronet {
   }
 
   late final _Cronet_UrlRequestParams_Create_ptr =
-      _lookup<ffi.NativeFunction<_c_Cronet_UrlRequestParams_Create>>(
+      _lookup<ffi.NativeFunction<Native_Cronet_UrlRequestParams_Create>>(
           'Cronet_UrlRequestParams_Create');
   late final _dart_Cronet_UrlRequestParams_Create
       _Cronet_UrlRequestParams_Create = _Cronet_UrlRequestParams_Create_ptr
@@ -3170,7 +3170,7 @@ class Cronet {
   }
 
   late final _Cronet_UrlRequestParams_Destroy_ptr =
-      _lookup<ffi.NativeFunction<_c_Cronet_UrlRequestParams_Destroy>>(
+      _lookup<ffi.NativeFunction<Native_Cronet_UrlRequestParams_Destroy>>(
           'Cronet_UrlRequestParams_Destroy');
   late final _dart_Cronet_UrlRequestParams_Destroy
       _Cronet_UrlRequestParams_Destroy = _Cronet_UrlRequestParams_Destroy_ptr
@@ -3187,7 +3187,7 @@ class Cronet {
   }
 
   late final _Cronet_UrlRequestParams_http_method_set_ptr =
-      _lookup<ffi.NativeFunction<_c_Cronet_UrlRequestParams_http_method_set>>(
+      _lookup<ffi.NativeFunction<Native_Cronet_UrlRequestParams_http_method_set>>(
           'Cronet_UrlRequestParams_http_method_set');
   late final _dart_Cronet_UrlRequestParams_http_method_set
       _Cronet_UrlRequestParams_http_method_set =
@@ -3205,7 +3205,7 @@ class Cronet {
   }
 
   late final _Cronet_UrlRequestParams_request_headers_add_ptr = _lookup<
-          ffi.NativeFunction<_c_Cronet_UrlRequestParams_request_headers_add>>(
+          ffi.NativeFunction<Native_Cronet_UrlRequestParams_request_headers_add>>(
       'Cronet_UrlRequestParams_request_headers_add');
   late final _dart_Cronet_UrlRequestParams_request_headers_add
       _Cronet_UrlRequestParams_request_headers_add =
@@ -3241,7 +3241,7 @@ class Cronet {
   }
 
   late final _Cronet_UrlRequestParams_priority_set_ptr =
-      _lookup<ffi.NativeFunction<_c_Cronet_UrlRequestParams_priority_set>>(
+      _lookup<ffi.NativeFunction<Native_Cronet_UrlRequestParams_priority_set>>(
           'Cronet_UrlRequestParams_priority_set');
   late final _dart_Cronet_UrlRequestParams_priority_set
       _Cronet_UrlRequestParams_priority_set =
@@ -3260,7 +3260,7 @@ class Cronet {
 
   late final _Cronet_UrlRequestParams_upload_data_provider_set_ptr = _lookup<
           ffi.NativeFunction<
-              _c_Cronet_UrlRequestParams_upload_data_provider_set>>(
+              Native_Cronet_UrlRequestParams_upload_data_provider_set>>(
       'Cronet_UrlRequestParams_upload_data_provider_set');
   late final _dart_Cronet_UrlRequestParams_upload_data_provider_set
       _Cronet_UrlRequestParams_upload_data_provider_set =
@@ -4697,6 +4697,139 @@ class _SymbolAddresses {
               Native_Cronet_UrlResponseInfo_http_status_text_get>>
       get Cronet_UrlResponseInfo_http_status_text_get =>
           _library._Cronet_UrlResponseInfo_http_status_text_get_ptr;
+  ffi.Pointer<ffi.NativeFunction<Native_Cronet_UrlRequest_Create>>
+      get Cronet_UrlRequest_Create => _library._Cronet_UrlRequest_Create_ptr;
+  ffi.Pointer<ffi.NativeFunction<Native_Cronet_UrlRequest_Destroy>>
+      get Cronet_UrlRequest_Destroy => _library._Cronet_UrlRequest_Destroy_ptr;
+  ffi.Pointer<ffi.NativeFunction<Native_Cronet_UrlRequest_InitWithParams>>
+      get Cronet_UrlRequest_InitWithParams =>
+          _library._Cronet_UrlRequest_InitWithParams_ptr;
+  ffi.Pointer<ffi.NativeFunction<Native_Cronet_UrlRequest_Start>>
+      get Cronet_UrlRequest_Start => _library._Cronet_UrlRequest_Start_ptr;
+  ffi.Pointer<
+          ffi.NativeFunction<Native_Cronet_UrlRequestParams_http_method_set>>
+      get Cronet_UrlRequestParams_http_method_set =>
+          _library._Cronet_UrlRequestParams_http_method_set_ptr;
+  ffi.Pointer<ffi.NativeFunction<Native_Cronet_UrlRequestParams_priority_set>>
+      get Cronet_UrlRequestParams_priority_set =>
+          _library._Cronet_UrlRequestParams_priority_set_ptr;
+  ffi.Pointer<
+          ffi.NativeFunction<Native_Cronet_UrlRequestParams_upload_data_provider_set>>
+      get Cronet_UrlRequestParams_upload_data_provider_set =>
+          _library._Cronet_UrlRequestParams_upload_data_provider_set_ptr;
+  ffi.Pointer<ffi.NativeFunction<Native_Cronet_UrlRequestCallback_CreateWith>>
+      get Cronet_UrlRequestCallback_CreateWith =>
+          _library._Cronet_UrlRequestCallback_CreateWith_ptr;
+  ffi.Pointer<ffi.NativeFunction<Native_Cronet_UploadDataProvider_CreateWith>>
+      get Cronet_UploadDataProvider_CreateWith =>
+          _library._Cronet_UploadDataProvider_CreateWith_ptr;
+  ffi.Pointer<
+          ffi.NativeFunction<Native_Cronet_UploadDataProvider_SetClientContext>>
+      get Cronet_UploadDataProvider_SetClientContext =>
+          _library._Cronet_UploadDataProvider_SetClientContext_ptr;
+  ffi.Pointer<ffi.NativeFunction<Native_Cronet_HttpHeader_Create>>
+      get Cronet_HttpHeader_Create => _library._Cronet_HttpHeader_Create_ptr;
+  ffi.Pointer<ffi.NativeFunction<Native_Cronet_HttpHeader_Destroy>>
+      get Cronet_HttpHeader_Destroy => _library._Cronet_HttpHeader_Destroy_ptr;
+  ffi.Pointer<ffi.NativeFunction<Native_Cronet_HttpHeader_name_set>>
+      get Cronet_HttpHeader_name_set =>
+          _library._Cronet_HttpHeader_name_set_ptr;
+  ffi.Pointer<ffi.NativeFunction<Native_Cronet_HttpHeader_value_set>>
+      get Cronet_HttpHeader_value_set =>
+          _library._Cronet_HttpHeader_value_set_ptr;
+  ffi.Pointer<
+          ffi.NativeFunction<Native_Cronet_UrlRequestParams_request_headers_add>>
+      get Cronet_UrlRequestParams_request_headers_add =>
+          _library._Cronet_UrlRequestParams_request_headers_add_ptr;
+  ffi.Pointer<ffi.NativeFunction<Native_Cronet_UrlRequestParams_Create>>
+      get Cronet_UrlRequestParams_Create =>
+          _library._Cronet_UrlRequestParams_Create_ptr;
+  ffi.Pointer<ffi.NativeFunction<Native_Cronet_UrlRequestParams_Destroy>>
+      get Cronet_UrlRequestParams_Destroy =>
+          _library._Cronet_UrlRequestParams_Destroy_ptr;
+  ffi.Pointer<ffi.NativeFunction<Native_Cronet_UrlRequestCallback_Destroy>>
+      get Cronet_UrlRequestCallback_Destroy =>
+          _library._Cronet_UrlRequestCallback_Destroy_ptr;
+  ffi.Pointer<
+          ffi.NativeFunction<Native_Cronet_UrlRequestCallback_SetClientContext>>
+      get Cronet_UrlRequestCallback_SetClientContext =>
+          _library._Cronet_UrlRequestCallback_SetClientContext_ptr;
+  ffi.Pointer<
+          ffi.NativeFunction<Native_Cronet_UrlRequestCallback_GetClientContext>>
+      get Cronet_UrlRequestCallback_GetClientContext =>
+          _library._Cronet_UrlRequestCallback_GetClientContext_ptr;
+  ffi.Pointer<ffi.NativeFunction<Native_Cronet_UploadDataProvider_Destroy>>
+      get Cronet_UploadDataProvider_Destroy =>
+          _library._Cronet_UploadDataProvider_Destroy_ptr;
+  ffi.Pointer<ffi.NativeFunction<Native_Cronet_Buffer_Destroy>>
+      get Cronet_Buffer_Destroy => _library._Cronet_Buffer_Destroy_ptr;
+  ffi.Pointer<ffi.NativeFunction<Native_Cronet_UrlRequest_Read>>
+      get Cronet_UrlRequest_Read => _library._Cronet_UrlRequest_Read_ptr;
+  ffi.Pointer<ffi.NativeFunction<Native_Cronet_UrlRequest_FollowRedirect>>
+      get Cronet_UrlRequest_FollowRedirect =>
+          _library._Cronet_UrlRequest_FollowRedirect_ptr;
+  ffi.Pointer<ffi.NativeFunction<Native_Cronet_UrlRequest_Cancel>>
+      get Cronet_UrlRequest_Cancel => _library._Cronet_UrlRequest_Cancel_ptr;
+  ffi.Pointer<
+          ffi.NativeFunction<Native_Cronet_UrlResponseInfo_all_headers_list_size>>
+      get Cronet_UrlResponseInfo_all_headers_list_size =>
+          _library._Cronet_UrlResponseInfo_all_headers_list_size_ptr;
+  ffi.Pointer<
+          ffi.NativeFunction<Native_Cronet_UrlResponseInfo_all_headers_list_at>>
+      get Cronet_UrlResponseInfo_all_headers_list_at =>
+          _library._Cronet_UrlResponseInfo_all_headers_list_at_ptr;
+  ffi.Pointer<ffi.NativeFunction<Native_Cronet_HttpHeader_name_get>>
+      get Cronet_HttpHeader_name_get =>
+          _library._Cronet_HttpHeader_name_get_ptr;
+  ffi.Pointer<ffi.NativeFunction<Native_Cronet_HttpHeader_value_get>>
+      get Cronet_HttpHeader_value_get =>
+          _library._Cronet_HttpHeader_value_get_ptr;
+  ffi.Pointer<ffi.NativeFunction<Native_Cronet_Buffer_GetData>>
+      get Cronet_Buffer_GetData => _library._Cronet_Buffer_GetData_ptr;
+  ffi.Pointer<ffi.NativeFunction<Native_Cronet_Error_error_code_get>>
+      get Cronet_Error_error_code_get =>
+          _library._Cronet_Error_error_code_get_ptr;
+  ffi.Pointer<ffi.NativeFunction<Native_Cronet_Error_internal_error_code_get>>
+      get Cronet_Error_internal_error_code_get =>
+          _library._Cronet_Error_internal_error_code_get_ptr;
+  ffi.Pointer<ffi.NativeFunction<Native_Cronet_Error_immediately_retryable_get>>
+      get Cronet_Error_immediately_retryable_get =>
+          _library._Cronet_Error_immediately_retryable_get_ptr;
+  ffi.Pointer<
+          ffi.NativeFunction<Native_Cronet_Error_quic_detailed_error_code_get>>
+      get Cronet_Error_quic_detailed_error_code_get =>
+          _library._Cronet_Error_quic_detailed_error_code_get_ptr;
+  ffi.Pointer<ffi.NativeFunction<Native_Cronet_Buffer_GetSize>>
+      get Cronet_Buffer_GetSize => _library._Cronet_Buffer_GetSize_ptr;
+  ffi.Pointer<ffi.NativeFunction<Native_Cronet_UploadDataSink_OnReadSucceeded>>
+      get Cronet_UploadDataSink_OnReadSucceeded =>
+          _library._Cronet_UploadDataSink_OnReadSucceeded_ptr;
+  ffi.Pointer<ffi.NativeFunction<Native_Cronet_UploadDataSink_OnReadError>>
+      get Cronet_UploadDataSink_OnReadError =>
+          _library._Cronet_UploadDataSink_OnReadError_ptr;
+  ffi.Pointer<
+          ffi.NativeFunction<Native_Cronet_UploadDataSink_OnRewindSucceeded>>
+      get Cronet_UploadDataSink_OnRewindSucceeded =>
+          _library._Cronet_UploadDataSink_OnRewindSucceeded_ptr;
+  ffi.Pointer<ffi.NativeFunction<Native_Cronet_UrlRequest_GetStatus>>
+      get Cronet_UrlRequest_GetStatus =>
+          _library._Cronet_UrlRequest_GetStatus_ptr;
+  ffi.Pointer<
+          ffi.NativeFunction<Native_Cronet_UrlRequestStatusListener_CreateWith>>
+      get Cronet_UrlRequestStatusListener_CreateWith =>
+          _library._Cronet_UrlRequestStatusListener_CreateWith_ptr;
+  ffi.Pointer<
+          ffi.NativeFunction<Native_Cronet_UrlRequestStatusListener_SetClientContext>>
+      get Cronet_UrlRequestStatusListener_SetClientContext =>
+          _library._Cronet_UrlRequestStatusListener_SetClientContext_ptr;
+  ffi.Pointer<
+          ffi.NativeFunction<Native_Cronet_UrlRequestStatusListener_GetClientContext>>
+      get Cronet_UrlRequestStatusListener_GetClientContext =>
+          _library._Cronet_UrlRequestStatusListener_GetClientContext_ptr;
+  ffi.Pointer<
+          ffi.NativeFunction<Native_Cronet_UrlRequestStatusListener_Destroy>>
+      get Cronet_UrlRequestStatusListener_Destroy =>
+          _library._Cronet_UrlRequestStatusListener_Destroy_ptr;
 }
 
 class Cronet_Buffer extends ffi.Opaque {}
@@ -4859,7 +4992,7 @@ typedef Native_Cronet_Buffer_Create = ffi.Pointer<Cronet_Buffer> Function();
 
 typedef _dart_Cronet_Buffer_Create = ffi.Pointer<Cronet_Buffer> Function();
 
-typedef _c_Cronet_Buffer_Destroy = ffi.Void Function(
+typedef Native_Cronet_Buffer_Destroy = ffi.Void Function(
   ffi.Pointer<Cronet_Buffer> self,
 );
 
@@ -4909,7 +5042,7 @@ typedef _dart_Cronet_Buffer_InitWithAlloc = void Function(
   int size,
 );
 
-typedef _c_Cronet_Buffer_GetSize = ffi.Uint64 Function(
+typedef Native_Cronet_Buffer_GetSize = ffi.Uint64 Function(
   ffi.Pointer<Cronet_Buffer> self,
 );
 
@@ -4917,7 +5050,7 @@ typedef _dart_Cronet_Buffer_GetSize = int Function(
   ffi.Pointer<Cronet_Buffer> self,
 );
 
-typedef _c_Cronet_Buffer_GetData = ffi.Pointer<ffi.Void> Function(
+typedef Native_Cronet_Buffer_GetData = ffi.Pointer<ffi.Void> Function(
   ffi.Pointer<Cronet_Buffer> self,
 );
 
@@ -5298,7 +5431,7 @@ typedef _dart_Cronet_Engine_CreateWith = ffi.Pointer<Cronet_Engine> Function(
       RemoveRequestFinishedListenerFunc,
 );
 
-typedef _c_Cronet_UrlRequestStatusListener_Destroy = ffi.Void Function(
+typedef Native_Cronet_UrlRequestStatusListener_Destroy = ffi.Void Function(
   ffi.Pointer<Cronet_UrlRequestStatusListener> self,
 );
 
@@ -5306,7 +5439,7 @@ typedef _dart_Cronet_UrlRequestStatusListener_Destroy = void Function(
   ffi.Pointer<Cronet_UrlRequestStatusListener> self,
 );
 
-typedef _c_Cronet_UrlRequestStatusListener_SetClientContext = ffi.Void Function(
+typedef Native_Cronet_UrlRequestStatusListener_SetClientContext = ffi.Void Function(
   ffi.Pointer<Cronet_UrlRequestStatusListener> self,
   ffi.Pointer<ffi.Void> client_context,
 );
@@ -5316,7 +5449,7 @@ typedef _dart_Cronet_UrlRequestStatusListener_SetClientContext = void Function(
   ffi.Pointer<ffi.Void> client_context,
 );
 
-typedef _c_Cronet_UrlRequestStatusListener_GetClientContext
+typedef Native_Cronet_UrlRequestStatusListener_GetClientContext
     = ffi.Pointer<ffi.Void> Function(
   ffi.Pointer<Cronet_UrlRequestStatusListener> self,
 );
@@ -5341,7 +5474,7 @@ typedef Cronet_UrlRequestStatusListener_OnStatusFunc = ffi.Void Function(
   ffi.Int32,
 );
 
-typedef _c_Cronet_UrlRequestStatusListener_CreateWith
+typedef Native_Cronet_UrlRequestStatusListener_CreateWith
     = ffi.Pointer<Cronet_UrlRequestStatusListener> Function(
   ffi.Pointer<ffi.NativeFunction<Cronet_UrlRequestStatusListener_OnStatusFunc>>
       OnStatusFunc,
@@ -5353,7 +5486,7 @@ typedef _dart_Cronet_UrlRequestStatusListener_CreateWith
       OnStatusFunc,
 );
 
-typedef _c_Cronet_UrlRequestCallback_Destroy = ffi.Void Function(
+typedef Native_Cronet_UrlRequestCallback_Destroy = ffi.Void Function(
   ffi.Pointer<Cronet_UrlRequestCallback> self,
 );
 
@@ -5361,7 +5494,7 @@ typedef _dart_Cronet_UrlRequestCallback_Destroy = void Function(
   ffi.Pointer<Cronet_UrlRequestCallback> self,
 );
 
-typedef _c_Cronet_UrlRequestCallback_SetClientContext = ffi.Void Function(
+typedef Native_Cronet_UrlRequestCallback_SetClientContext = ffi.Void Function(
   ffi.Pointer<Cronet_UrlRequestCallback> self,
   ffi.Pointer<ffi.Void> client_context,
 );
@@ -5371,7 +5504,7 @@ typedef _dart_Cronet_UrlRequestCallback_SetClientContext = void Function(
   ffi.Pointer<ffi.Void> client_context,
 );
 
-typedef _c_Cronet_UrlRequestCallback_GetClientContext = ffi.Pointer<ffi.Void>
+typedef Native_Cronet_UrlRequestCallback_GetClientContext = ffi.Pointer<ffi.Void>
     Function(
   ffi.Pointer<Cronet_UrlRequestCallback> self,
 );
@@ -5501,7 +5634,7 @@ typedef Cronet_UrlRequestCallback_OnCanceledFunc = ffi.Void Function(
   ffi.Pointer<Cronet_UrlResponseInfo>,
 );
 
-typedef _c_Cronet_UrlRequestCallback_CreateWith
+typedef Native_Cronet_UrlRequestCallback_CreateWith
     = ffi.Pointer<Cronet_UrlRequestCallback> Function(
   ffi.Pointer<
           ffi.NativeFunction<Cronet_UrlRequestCallback_OnRedirectReceivedFunc>>
@@ -5571,7 +5704,7 @@ typedef _dart_Cronet_UploadDataSink_GetClientContext = ffi.Pointer<ffi.Void>
   ffi.Pointer<Cronet_UploadDataSink> self,
 );
 
-typedef _c_Cronet_UploadDataSink_OnReadSucceeded = ffi.Void Function(
+typedef Native_Cronet_UploadDataSink_OnReadSucceeded = ffi.Void Function(
   ffi.Pointer<Cronet_UploadDataSink> self,
   ffi.Uint64 bytes_read,
   ffi.Uint8 final_chunk,
@@ -5583,7 +5716,7 @@ typedef _dart_Cronet_UploadDataSink_OnReadSucceeded = void Function(
   int final_chunk,
 );
 
-typedef _c_Cronet_UploadDataSink_OnReadError = ffi.Void Function(
+typedef Native_Cronet_UploadDataSink_OnReadError = ffi.Void Function(
   ffi.Pointer<Cronet_UploadDataSink> self,
   ffi.Pointer<ffi.Int8> error_message,
 );
@@ -5593,7 +5726,7 @@ typedef _dart_Cronet_UploadDataSink_OnReadError = void Function(
   ffi.Pointer<ffi.Int8> error_message,
 );
 
-typedef _c_Cronet_UploadDataSink_OnRewindSucceeded = ffi.Void Function(
+typedef Native_Cronet_UploadDataSink_OnRewindSucceeded = ffi.Void Function(
   ffi.Pointer<Cronet_UploadDataSink> self,
 );
 
@@ -5655,7 +5788,7 @@ typedef _dart_Cronet_UploadDataSink_CreateWith
       OnRewindErrorFunc,
 );
 
-typedef _c_Cronet_UploadDataProvider_Destroy = ffi.Void Function(
+typedef Native_Cronet_UploadDataProvider_Destroy = ffi.Void Function(
   ffi.Pointer<Cronet_UploadDataProvider> self,
 );
 
@@ -5663,7 +5796,7 @@ typedef _dart_Cronet_UploadDataProvider_Destroy = void Function(
   ffi.Pointer<Cronet_UploadDataProvider> self,
 );
 
-typedef _c_Cronet_UploadDataProvider_SetClientContext = ffi.Void Function(
+typedef Native_Cronet_UploadDataProvider_SetClientContext = ffi.Void Function(
   ffi.Pointer<Cronet_UploadDataProvider> self,
   ffi.Pointer<ffi.Void> client_context,
 );
@@ -5740,7 +5873,7 @@ typedef Cronet_UploadDataProvider_CloseFunc = ffi.Void Function(
   ffi.Pointer<Cronet_UploadDataProvider>,
 );
 
-typedef _c_Cronet_UploadDataProvider_CreateWith
+typedef Native_Cronet_UploadDataProvider_CreateWith
     = ffi.Pointer<Cronet_UploadDataProvider> Function(
   ffi.Pointer<ffi.NativeFunction<Cronet_UploadDataProvider_GetLengthFunc>>
       GetLengthFunc,
@@ -5762,12 +5895,12 @@ typedef _dart_Cronet_UploadDataProvider_CreateWith
       CloseFunc,
 );
 
-typedef _c_Cronet_UrlRequest_Create = ffi.Pointer<Cronet_UrlRequest> Function();
+typedef Native_Cronet_UrlRequest_Create = ffi.Pointer<Cronet_UrlRequest> Function();
 
 typedef _dart_Cronet_UrlRequest_Create = ffi.Pointer<Cronet_UrlRequest>
     Function();
 
-typedef _c_Cronet_UrlRequest_Destroy = ffi.Void Function(
+typedef Native_Cronet_UrlRequest_Destroy = ffi.Void Function(
   ffi.Pointer<Cronet_UrlRequest> self,
 );
 
@@ -5794,7 +5927,7 @@ typedef _dart_Cronet_UrlRequest_GetClientContext = ffi.Pointer<ffi.Void>
   ffi.Pointer<Cronet_UrlRequest> self,
 );
 
-typedef _c_Cronet_UrlRequest_InitWithParams = ffi.Int32 Function(
+typedef Native_Cronet_UrlRequest_InitWithParams = ffi.Int32 Function(
   ffi.Pointer<Cronet_UrlRequest> self,
   ffi.Pointer<Cronet_Engine> engine,
   ffi.Pointer<ffi.Int8> url,
@@ -5812,7 +5945,7 @@ typedef _dart_Cronet_UrlRequest_InitWithParams = int Function(
   ffi.Pointer<Cronet_Executor> executor,
 );
 
-typedef _c_Cronet_UrlRequest_Start = ffi.Int32 Function(
+typedef Native_Cronet_UrlRequest_Start = ffi.Int32 Function(
   ffi.Pointer<Cronet_UrlRequest> self,
 );
 
@@ -5820,7 +5953,7 @@ typedef _dart_Cronet_UrlRequest_Start = int Function(
   ffi.Pointer<Cronet_UrlRequest> self,
 );
 
-typedef _c_Cronet_UrlRequest_FollowRedirect = ffi.Int32 Function(
+typedef Native_Cronet_UrlRequest_FollowRedirect = ffi.Int32 Function(
   ffi.Pointer<Cronet_UrlRequest> self,
 );
 
@@ -5828,7 +5961,7 @@ typedef _dart_Cronet_UrlRequest_FollowRedirect = int Function(
   ffi.Pointer<Cronet_UrlRequest> self,
 );
 
-typedef _c_Cronet_UrlRequest_Read = ffi.Int32 Function(
+typedef Native_Cronet_UrlRequest_Read = ffi.Int32 Function(
   ffi.Pointer<Cronet_UrlRequest> self,
   ffi.Pointer<Cronet_Buffer> buffer,
 );
@@ -5838,7 +5971,7 @@ typedef _dart_Cronet_UrlRequest_Read = int Function(
   ffi.Pointer<Cronet_Buffer> buffer,
 );
 
-typedef _c_Cronet_UrlRequest_Cancel = ffi.Void Function(
+typedef Native_Cronet_UrlRequest_Cancel = ffi.Void Function(
   ffi.Pointer<Cronet_UrlRequest> self,
 );
 
@@ -5854,7 +5987,7 @@ typedef _dart_Cronet_UrlRequest_IsDone = int Function(
   ffi.Pointer<Cronet_UrlRequest> self,
 );
 
-typedef _c_Cronet_UrlRequest_GetStatus = ffi.Void Function(
+typedef Native_Cronet_UrlRequest_GetStatus = ffi.Void Function(
   ffi.Pointer<Cronet_UrlRequest> self,
   ffi.Pointer<Cronet_UrlRequestStatusListener> listener,
 );
@@ -6059,7 +6192,7 @@ typedef _dart_Cronet_Error_quic_detailed_error_code_set = void Function(
   int quic_detailed_error_code,
 );
 
-typedef _c_Cronet_Error_error_code_get = ffi.Int32 Function(
+typedef Native_Cronet_Error_error_code_get = ffi.Int32 Function(
   ffi.Pointer<Cronet_Error> self,
 );
 
@@ -6075,7 +6208,7 @@ typedef _dart_Cronet_Error_message_get = ffi.Pointer<ffi.Int8> Function(
   ffi.Pointer<Cronet_Error> self,
 );
 
-typedef _c_Cronet_Error_internal_error_code_get = ffi.Int32 Function(
+typedef Native_Cronet_Error_internal_error_code_get = ffi.Int32 Function(
   ffi.Pointer<Cronet_Error> self,
 );
 
@@ -6083,7 +6216,7 @@ typedef _dart_Cronet_Error_internal_error_code_get = int Function(
   ffi.Pointer<Cronet_Error> self,
 );
 
-typedef _c_Cronet_Error_immediately_retryable_get = ffi.Uint8 Function(
+typedef Native_Cronet_Error_immediately_retryable_get = ffi.Uint8 Function(
   ffi.Pointer<Cronet_Error> self,
 );
 
@@ -6091,7 +6224,7 @@ typedef _dart_Cronet_Error_immediately_retryable_get = int Function(
   ffi.Pointer<Cronet_Error> self,
 );
 
-typedef _c_Cronet_Error_quic_detailed_error_code_get = ffi.Int32 Function(
+typedef Native_Cronet_Error_quic_detailed_error_code_get = ffi.Int32 Function(
   ffi.Pointer<Cronet_Error> self,
 );
 
@@ -6588,12 +6721,12 @@ typedef _dart_Cronet_EngineParams_experimental_options_get
   ffi.Pointer<Cronet_EngineParams> self,
 );
 
-typedef _c_Cronet_HttpHeader_Create = ffi.Pointer<Cronet_HttpHeader> Function();
+typedef Native_Cronet_HttpHeader_Create = ffi.Pointer<Cronet_HttpHeader> Function();
 
 typedef _dart_Cronet_HttpHeader_Create = ffi.Pointer<Cronet_HttpHeader>
     Function();
 
-typedef _c_Cronet_HttpHeader_Destroy = ffi.Void Function(
+typedef Native_Cronet_HttpHeader_Destroy = ffi.Void Function(
   ffi.Pointer<Cronet_HttpHeader> self,
 );
 
@@ -6601,7 +6734,7 @@ typedef _dart_Cronet_HttpHeader_Destroy = void Function(
   ffi.Pointer<Cronet_HttpHeader> self,
 );
 
-typedef _c_Cronet_HttpHeader_name_set = ffi.Void Function(
+typedef Native_Cronet_HttpHeader_name_set = ffi.Void Function(
   ffi.Pointer<Cronet_HttpHeader> self,
   ffi.Pointer<ffi.Int8> name,
 );
@@ -6611,7 +6744,7 @@ typedef _dart_Cronet_HttpHeader_name_set = void Function(
   ffi.Pointer<ffi.Int8> name,
 );
 
-typedef _c_Cronet_HttpHeader_value_set = ffi.Void Function(
+typedef Native_Cronet_HttpHeader_value_set = ffi.Void Function(
   ffi.Pointer<Cronet_HttpHeader> self,
   ffi.Pointer<ffi.Int8> value,
 );
@@ -6621,7 +6754,7 @@ typedef _dart_Cronet_HttpHeader_value_set = void Function(
   ffi.Pointer<ffi.Int8> value,
 );
 
-typedef _c_Cronet_HttpHeader_name_get = ffi.Pointer<ffi.Int8> Function(
+typedef Native_Cronet_HttpHeader_name_get = ffi.Pointer<ffi.Int8> Function(
   ffi.Pointer<Cronet_HttpHeader> self,
 );
 
@@ -6629,7 +6762,7 @@ typedef _dart_Cronet_HttpHeader_name_get = ffi.Pointer<ffi.Int8> Function(
   ffi.Pointer<Cronet_HttpHeader> self,
 );
 
-typedef _c_Cronet_HttpHeader_value_get = ffi.Pointer<ffi.Int8> Function(
+typedef Native_Cronet_HttpHeader_value_get = ffi.Pointer<ffi.Int8> Function(
   ffi.Pointer<Cronet_HttpHeader> self,
 );
 
@@ -6794,7 +6927,7 @@ typedef _dart_Cronet_UrlResponseInfo_http_status_text_get
   ffi.Pointer<Cronet_UrlResponseInfo> self,
 );
 
-typedef _c_Cronet_UrlResponseInfo_all_headers_list_size = ffi.Uint32 Function(
+typedef Native_Cronet_UrlResponseInfo_all_headers_list_size = ffi.Uint32 Function(
   ffi.Pointer<Cronet_UrlResponseInfo> self,
 );
 
@@ -6802,7 +6935,7 @@ typedef _dart_Cronet_UrlResponseInfo_all_headers_list_size = int Function(
   ffi.Pointer<Cronet_UrlResponseInfo> self,
 );
 
-typedef _c_Cronet_UrlResponseInfo_all_headers_list_at
+typedef Native_Cronet_UrlResponseInfo_all_headers_list_at
     = ffi.Pointer<Cronet_HttpHeader> Function(
   ffi.Pointer<Cronet_UrlResponseInfo> self,
   ffi.Uint32 index,
@@ -6858,13 +6991,13 @@ typedef _dart_Cronet_UrlResponseInfo_received_byte_count_get = int Function(
   ffi.Pointer<Cronet_UrlResponseInfo> self,
 );
 
-typedef _c_Cronet_UrlRequestParams_Create = ffi.Pointer<Cronet_UrlRequestParams>
+typedef Native_Cronet_UrlRequestParams_Create = ffi.Pointer<Cronet_UrlRequestParams>
     Function();
 
 typedef _dart_Cronet_UrlRequestParams_Create
     = ffi.Pointer<Cronet_UrlRequestParams> Function();
 
-typedef _c_Cronet_UrlRequestParams_Destroy = ffi.Void Function(
+typedef Native_Cronet_UrlRequestParams_Destroy = ffi.Void Function(
   ffi.Pointer<Cronet_UrlRequestParams> self,
 );
 
@@ -6872,7 +7005,7 @@ typedef _dart_Cronet_UrlRequestParams_Destroy = void Function(
   ffi.Pointer<Cronet_UrlRequestParams> self,
 );
 
-typedef _c_Cronet_UrlRequestParams_http_method_set = ffi.Void Function(
+typedef Native_Cronet_UrlRequestParams_http_method_set = ffi.Void Function(
   ffi.Pointer<Cronet_UrlRequestParams> self,
   ffi.Pointer<ffi.Int8> http_method,
 );
@@ -6882,7 +7015,7 @@ typedef _dart_Cronet_UrlRequestParams_http_method_set = void Function(
   ffi.Pointer<ffi.Int8> http_method,
 );
 
-typedef _c_Cronet_UrlRequestParams_request_headers_add = ffi.Void Function(
+typedef Native_Cronet_UrlRequestParams_request_headers_add = ffi.Void Function(
   ffi.Pointer<Cronet_UrlRequestParams> self,
   ffi.Pointer<Cronet_HttpHeader> element,
 );
@@ -6902,7 +7035,7 @@ typedef _dart_Cronet_UrlRequestParams_disable_cache_set = void Function(
   int disable_cache,
 );
 
-typedef _c_Cronet_UrlRequestParams_priority_set = ffi.Void Function(
+typedef Native_Cronet_UrlRequestParams_priority_set = ffi.Void Function(
   ffi.Pointer<Cronet_UrlRequestParams> self,
   ffi.Int32 priority,
 );
@@ -6912,7 +7045,7 @@ typedef _dart_Cronet_UrlRequestParams_priority_set = void Function(
   int priority,
 );
 
-typedef _c_Cronet_UrlRequestParams_upload_data_provider_set = ffi.Void Function(
+typedef Native_Cronet_UrlRequestParams_upload_data_provider_set = ffi.Void Function(
   ffi.Pointer<Cronet_UrlRequestParams> self,
   ffi.Pointer<Cronet_UploadDataProvider> upload_data_provider,
 );
@@ -0,0 +1,33 @@
+// Copyright (c) 2021, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+import 'enums.dart';
+
+/// Progress of a request, see [HttpClientRequest.onProgress].
+class TransferProgress {
+  /// What the request is busy with.
+  final LoadState state;
+
+  /// Bytes of the request body handed to the network stack so far.
+  final int bytesSent;
+
+  /// Length of the request body, or -1 if it isn't known up front.
+  final int uploadLength;
+
+  /// Bytes of the response body received so far.
+  final int bytesReceived;
+
+  /// `Content-Length` of the response, or -1 if it isn't known yet.
+  ///
+  /// This is the encoded length, [bytesReceived] counts decoded bytes.
+  final int contentLength;
+
+  const TransferProgress(this.state, this.bytesSent, this.uploadLength,
+      this.bytesReceived, this.contentLength);
+
+  @override
+  String toString() => 'TransferProgress(state: $state, '
+      'bytesSent: $bytesSent, uploadLength: $uploadLength, '
+      'bytesReceived: $bytesReceived, contentLength: $contentLength)';
+}
@@ -105,6 +105,132 @@ class Wrapper {
   late final _dart_InitCronetExecutorApi _InitCronetExecutorApi =
       _InitCronetExecutorApi_ptr.asFunction<_dart_InitCronetExecutorApi>();
 
+  /// Forward declaration. Required by StartRequests
+  void InitCronetRequestApi(
+    ffi.Pointer<ffi.NativeFunction<_typedefC_15>> Cronet_UrlRequest_Create,
+    ffi.Pointer<ffi.NativeFunction<_typedefC_16>> Cronet_UrlRequest_Destroy,
+    ffi.Pointer<ffi.NativeFunction<_typedefC_17>>
+        Cronet_UrlRequest_InitWithParams,
+    ffi.Pointer<ffi.NativeFunction<_typedefC_18>> Cronet_UrlRequest_Start,
+    ffi.Pointer<ffi.NativeFunction<_typedefC_19>>
+        Cronet_UrlRequestParams_http_method_set,
+    ffi.Pointer<ffi.NativeFunction<_typedefC_20>>
+        Cronet_UrlRequestParams_priority_set,
+    ffi.Pointer<ffi.NativeFunction<_typedefC_21>>
+        Cronet_UrlRequestParams_upload_data_provider_set,
+    ffi.Pointer<ffi.NativeFunction<_typedefC_22>>
+        Cronet_UrlRequestCallback_CreateWith,
+    ffi.Pointer<ffi.NativeFunction<_typedefC_23>>
+        Cronet_UploadDataProvider_CreateWith,
+    ffi.Pointer<ffi.NativeFunction<_typedefC_24>>
+        Cronet_UploadDataProvider_SetClientContext,
+    ffi.Pointer<ffi.NativeFunction<_typedefC_25>> Cronet_HttpHeader_Create,
+    ffi.Pointer<ffi.NativeFunction<_typedefC_26>> Cronet_HttpHeader_Destroy,
+    ffi.Pointer<ffi.NativeFunction<_typedefC_27>> Cronet_HttpHeader_name_set,
+    ffi.Pointer<ffi.NativeFunction<_typedefC_28>> Cronet_HttpHeader_value_set,
+    ffi.Pointer<ffi.NativeFunction<_typedefC_29>>
+        Cronet_UrlRequestParams_request_headers_add,
+    ffi.Pointer<ffi.NativeFunction<_typedefC_30>>
+        Cronet_UrlRequestParams_Create,
+    ffi.Pointer<ffi.NativeFunction<_typedefC_31>>
+        Cronet_UrlRequestParams_Destroy,
+    ffi.Pointer<ffi.NativeFunction<_typedefC_32>>
+        Cronet_UrlRequestCallback_Destroy,
+    ffi.Pointer<ffi.NativeFunction<_typedefC_33>>
+        Cronet_UrlRequestCallback_SetClientContext,
+    ffi.Pointer<ffi.NativeFunction<_typedefC_34>>
+        Cronet_UrlRequestCallback_GetClientContext,
+    ffi.Pointer<ffi.NativeFunction<_typedefC_35>>
+        Cronet_UploadDataProvider_Destroy,
+    ffi.Pointer<ffi.NativeFunction<_typedefC_36>> Cronet_Buffer_Destroy,
+    ffi.Pointer<ffi.NativeFunction<_typedefC_37>> Cronet_UrlRequest_Read,
+    ffi.Pointer<ffi.NativeFunction<_typedefC_38>>
+        Cronet_UrlRequest_FollowRedirect,
+    ffi.Pointer<ffi.NativeFunction<_typedefC_39>> Cronet_UrlRequest_Cancel,
+    ffi.Pointer<ffi.NativeFunction<_typedefC_40>>
+        Cronet_UrlResponseInfo_all_headers_list_size,
+    ffi.Pointer<ffi.NativeFunction<_typedefC_41>>
+        Cronet_UrlResponseInfo_all_headers_list_at,
+    ffi.Pointer<ffi.NativeFunction<_typedefC_42>> Cronet_HttpHeader_name_get,
+    ffi.Pointer<ffi.NativeFunction<_typedefC_43>> Cronet_HttpHeader_value_get,
+    ffi.Pointer<ffi.NativeFunction<_typedefC_44>> Cronet_Buffer_GetData,
+    ffi.Pointer<ffi.NativeFunction<_typedefC_45>> Cronet_Error_error_code_get,
+    ffi.Pointer<ffi.NativeFunction<_typedefC_46>>
+        Cronet_Error_internal_error_code_get,
+    ffi.Pointer<ffi.NativeFunction<_typedefC_47>>
+        Cronet_Error_immediately_retryable_get,
+    ffi.Pointer<ffi.NativeFunction<_typedefC_48>>
+        Cronet_Error_quic_detailed_error_code_get,
+    ffi.Pointer<ffi.NativeFunction<_typedefC_49>> Cronet_Buffer_GetSize,
+    ffi.Pointer<ffi.NativeFunction<_typedefC_50>>
+        Cronet_UploadDataSink_OnReadSucceeded,
+    ffi.Pointer<ffi.NativeFunction<_typedefC_51>>
+        Cronet_UploadDataSink_OnReadError,
+    ffi.Pointer<ffi.NativeFunction<_typedefC_52>>
+        Cronet_UploadDataSink_OnRewindSucceeded,
+    ffi.Pointer<ffi.NativeFunction<_typedefC_53>> Cronet_UrlRequest_GetStatus,
+    ffi.Pointer<ffi.NativeFunction<_typedefC_54>>
+        Cronet_UrlRequestStatusListener_CreateWith,
+    ffi.Pointer<ffi.NativeFunction<_typedefC_55>>
+        Cronet_UrlRequestStatusListener_SetClientContext,
+    ffi.Pointer<ffi.NativeFunction<_typedefC_56>>
+        Cronet_UrlRequestStatusListener_GetClientContext,
+    ffi.Pointer<ffi.NativeFunction<_typedefC_57>>
+        Cronet_UrlRequestStatusListener_Destroy,
+  ) {
+    return _InitCronetRequestApi(
+      Cronet_UrlRequest_Create,
+      Cronet_UrlRequest_Destroy,
+      Cronet_UrlRequest_InitWithParams,
+      Cronet_UrlRequest_Start,
+      Cronet_UrlRequestParams_http_method_set,
+      Cronet_UrlRequestParams_priority_set,
+      Cronet_UrlRequestParams_upload_data_provider_set,
+      Cronet_UrlRequestCallback_CreateWith,
+      Cronet_UploadDataProvider_CreateWith,
+      Cronet_UploadDataProvider_SetClientContext,
+      Cronet_HttpHeader_Create,
+      Cronet_HttpHeader_Destroy,
+      Cronet_HttpHeader_name_set,
+      Cronet_HttpHeader_value_set,
+      Cronet_UrlRequestParams_request_headers_add,
+      Cronet_UrlRequestParams_Create,
+      Cronet_UrlRequestParams_Destroy,
+      Cronet_UrlRequestCallback_Destroy,
+      Cronet_UrlRequestCallback_SetClientContext,
+      Cronet_UrlRequestCallback_GetClientContext,
+      Cronet_UploadDataProvider_Destroy,
+      Cronet_Buffer_Destroy,
+      Cronet_UrlRequest_Read,
+      Cronet_UrlRequest_FollowRedirect,
+      Cronet_UrlRequest_Cancel,
+      Cronet_UrlResponseInfo_all_headers_list_size,
+      Cronet_UrlResponseInfo_all_headers_list_at,
+      Cronet_HttpHeader_name_get,
+      Cronet_HttpHeader_value_get,
+      Cronet_Buffer_GetData,
+      Cronet_Error_error_code_get,
+      Cronet_Error_internal_error_code_get,
+      Cronet_Error_immediately_retryable_get,
+      Cronet_Error_quic_detailed_error_code_get,
+      Cronet_Buffer_GetSize,
+      Cronet_UploadDataSink_OnReadSucceeded,
+      Cronet_UploadDataSink_OnReadError,
+      Cronet_UploadDataSink_OnRewindSucceeded,
+      Cronet_UrlRequest_GetStatus,
+      Cronet_UrlRequestStatusListener_CreateWith,
+      Cronet_UrlRequestStatusListener_SetClientContext,
+      Cronet_UrlRequestStatusListener_GetClientContext,
+      Cronet_UrlRequestStatusListener_Destroy,
+    );
+  }
+
+  late final _InitCronetRequestApi_ptr =
+      _lookup<ffi.NativeFunction<_c_InitCronetRequestApi>>(
+          'InitCronetRequestApi');
+  late final _dart_InitCronetRequestApi _InitCronetRequestApi =
+      _InitCronetRequestApi_ptr.asFunction<_dart_InitCronetRequestApi>();
+
   void RegisterHttpClient(
     Object h,
     ffi.Pointer<Cronet_EnginePtr> ce,
@@ -120,6 +246,55 @@ class Wrapper {
   late final _dart_RegisterHttpClient _RegisterHttpClient =
       _RegisterHttpClient_ptr.asFunction<_dart_RegisterHttpClient>();
 
+  /// Adds a reference to |ce|, for a client of another isolate to take over
+  /// with AttachSharedEngine. Returns the token of the reference, which can be
+  /// used once.
+  int ShareEngine(
+    ffi.Pointer<Cronet_EnginePtr> ce,
+  ) {
+    return _ShareEngine(
+      ce,
+    );
+  }
+
+  late final _ShareEngine_ptr =
+      _lookup<ffi.NativeFunction<_c_ShareEngine>>('ShareEngine');
+  late final _dart_ShareEngine _ShareEngine =
+      _ShareEngine_ptr.asFunction<_dart_ShareEngine>();
+
+  /// Has the client |h| take over the reference of |token|, released once |h|
+  /// is garbage collected. Returns its engine, or null if |token| was used
+  /// already.
+  ffi.Pointer<Cronet_EnginePtr> AttachSharedEngine(
+    Object h,
+    int token,
+  ) {
+    return _AttachSharedEngine(
+      h,
+      token,
+    );
+  }
+
+  late final _AttachSharedEngine_ptr =
+      _lookup<ffi.NativeFunction<_c_AttachSharedEngine>>('AttachSharedEngine');
+  late final _dart_AttachSharedEngine _AttachSharedEngine =
+      _AttachSharedEngine_ptr.asFunction<_dart_AttachSharedEngine>();
+
+  /// Releases the reference of |token|. Returns false if it was used already.
+  int ReleaseSharedEngine(
+    int token,
+  ) {
+    return _ReleaseSharedEngine(
+      token,
+    );
+  }
+
+  late final _ReleaseSharedEngine_ptr =
+      _lookup<ffi.NativeFunction<_c_ReleaseSharedEngine>>(
+          'ReleaseSharedEngine');
+  late final _dart_ReleaseSharedEngine _ReleaseSharedEngine =
+      _ReleaseSharedEngine_ptr.asFunction<_dart_ReleaseSharedEngine>();
+
   void RegisterCallbackHandler(
     int nativePort,
     ffi.Pointer<Cronet_UrlRequest> rp,
@@ -149,6 +324,283 @@ class Wrapper {
   late final _dart_RemoveRequest _RemoveRequest =
       _RemoveRequest_ptr.asFunction<_dart_RemoveRequest>();
 
+  /// Adds |count| headers packed in |headers| to |params|. Every header is
+  /// packed as its name followed by its value, both null terminated.
+  void UrlRequestParamsAddHeaders(
+    ffi.Pointer<Cronet_UrlRequestParamsPtr> params,
+    ffi.Pointer<ffi.Int8> headers,
+    int count,
+  ) {
+    return _UrlRequestParamsAddHeaders(
+      params,
+      headers,
+      count,
+    );
+  }
+
+  late final _UrlRequestParamsAddHeaders_ptr =
+      _lookup<ffi.NativeFunction<_c_UrlRequestParamsAddHeaders>>(
+          'UrlRequestParamsAddHeaders');
+  late final _dart_UrlRequestParamsAddHeaders _UrlRequestParamsAddHeaders =
+      _UrlRequestParamsAddHeaders_ptr.asFunction<
+          _dart_UrlRequestParamsAddHeaders>();
+
+  /// Sets up and starts |count| requests described by |descriptors| on |engine|
+  /// in a single call.
+  void StartRequests(
+    ffi.Pointer<Cronet_EnginePtr> engine,
+    ffi.Pointer<RequestDescriptor> descriptors,
+    int count,
+  ) {
+    return _StartRequests(
+      engine,
+      descriptors,
+      count,
+    );
+  }
+
+  late final _StartRequests_ptr =
+      _lookup<ffi.NativeFunction<_c_StartRequests>>('StartRequests');
+  late final _dart_StartRequests _StartRequests =
+      _StartRequests_ptr.asFunction<_dart_StartRequests>();
+
+  /// The requests of |engine| started and not destroyed yet, in a single block
+  /// allocated with malloc, URLs included. Sets |count| to their number. Returns
+  /// NULL if there is none.
+  ffi.Pointer<RequestSnapshot> SnapshotRequests(
+    ffi.Pointer<Cronet_EnginePtr> engine,
+    ffi.Pointer<ffi.Int32> count,
+  ) {
+    return _SnapshotRequests(
+      engine,
+      count,
+    );
+  }
+
+  late final _SnapshotRequests_ptr =
+      _lookup<ffi.NativeFunction<_c_SnapshotRequests>>('SnapshotRequests');
+  late final _dart_SnapshotRequests _SnapshotRequests =
+      _SnapshotRequests_ptr.asFunction<_dart_SnapshotRequests>();
+
+  /// Has the requests of |engine| checked every now and then, and OnStuck
+  /// posted for those that didn't move for |threshold_ms|. 0 stops the
+  /// checks.
+  void SetStuckRequestThreshold(
+    ffi.Pointer<Cronet_EnginePtr> engine,
+    int threshold_ms,
+  ) {
+    return _SetStuckRequestThreshold(
+      engine,
+      threshold_ms,
+    );
+  }
+
+  late final _SetStuckRequestThreshold_ptr =
+      _lookup<ffi.NativeFunction<_c_SetStuckRequestThreshold>>(
+          'SetStuckRequestThreshold');
+  late final _dart_SetStuckRequestThreshold _SetStuckRequestThreshold =
+      _SetStuckRequestThreshold_ptr.asFunction<
+          _dart_SetStuckRequestThreshold>();
+
+  /// Starts or stops recording the lifecycle events of every request. Nothing
+  /// is recorded by builds without CRONET_TRACING.
+  void SetTracingEnabled(
+    int enabled,
+  ) {
+    return _SetTracingEnabled(
+      enabled,
+    );
+  }
+
+  late final _SetTracingEnabled_ptr =
+      _lookup<ffi.NativeFunction<_c_SetTracingEnabled>>('SetTracingEnabled');
+  late final _dart_SetTracingEnabled _SetTracingEnabled =
+      _SetTracingEnabled_ptr.asFunction<_dart_SetTracingEnabled>();
+
+  /// Records that the Dart side handled a callback posted to |port|.
+  void TraceDartHandled(
+    int port,
+  ) {
+    return _TraceDartHandled(
+      port,
+    );
+  }
+
+  late final _TraceDartHandled_ptr =
+      _lookup<ffi.NativeFunction<_c_TraceDartHandled>>('TraceDartHandled');
+  late final _dart_TraceDartHandled _TraceDartHandled =
+      _TraceDartHandled_ptr.asFunction<_dart_TraceDartHandled>();
+
+  /// The events recorded since the last ClearTrace, as Chrome trace event JSON
+  /// allocated with malloc.
+  ffi.Pointer<ffi.Int8> ExportTrace() {
+    return _ExportTrace();
+  }
+
+  late final _ExportTrace_ptr =
+      _lookup<ffi.NativeFunction<_c_ExportTrace>>('ExportTrace');
+  late final _dart_ExportTrace _ExportTrace =
+      _ExportTrace_ptr.asFunction<_dart_ExportTrace>();
+
+  /// Leaves the events recorded so far out of later exports.
+  void ClearTrace() {
+    return _ClearTrace();
+  }
+
+  late final _ClearTrace_ptr =
+      _lookup<ffi.NativeFunction<_c_ClearTrace>>('ClearTrace');
+  late final _dart_ClearTrace _ClearTrace =
+      _ClearTrace_ptr.asFunction<_dart_ClearTrace>();
+
+  /// Writes the live bytes, peak bytes, live objects and peak objects of each
+  /// category of native memory held by the wrapper to |stats|, followed by the
+  /// live and peak bytes of all of them: Cronet buffers, callback arguments,
+  /// strings copied for the Dart side, upload data providers, executors and
+  /// request ports. That's 26 values.
+  void ReadMemoryStats(
+    ffi.Pointer<ffi.Int64> stats,
+  ) {
+    return _ReadMemoryStats(
+      stats,
+    );
+  }
+
+  late final _ReadMemoryStats_ptr =
+      _lookup<ffi.NativeFunction<_c_ReadMemoryStats>>('ReadMemoryStats');
+  late final _dart_ReadMemoryStats _ReadMemoryStats =
+      _ReadMemoryStats_ptr.asFunction<_dart_ReadMemoryStats>();
+
+  /// Posts the live bytes to |port| once they reach |threshold_bytes|, and again
+  /// after they went back below three quarters of it. 0 turns the alert off.
+  void SetMemoryAlert(
+    int threshold_bytes,
+    int port,
+  ) {
+    return _SetMemoryAlert(
+      threshold_bytes,
+      port,
+    );
+  }
+
+  late final _SetMemoryAlert_ptr =
+      _lookup<ffi.NativeFunction<_c_SetMemoryAlert>>('SetMemoryAlert');
+  late final _dart_SetMemoryAlert _SetMemoryAlert =
+      _SetMemoryAlert_ptr.asFunction<_dart_SetMemoryAlert>();
+
+  /// Frees a string the wrapper handed to the Dart side.
+  void FreeString(
+    ffi.Pointer<ffi.Int8> string,
+  ) {
+    return _FreeString(
+      string,
+    );
+  }
+
+  late final _FreeString_ptr =
+      _lookup<ffi.NativeFunction<_c_FreeString>>('FreeString');
+  late final _dart_FreeString _FreeString =
+      _FreeString_ptr.asFunction<_dart_FreeString>();
+
+  /// Whether callbacks are posted as compact messages, a single Uint8List with
+  /// the id of the callback followed by its arguments, or as arrays holding the
+  /// name of the callback and its arguments. Compact by default.
+  void SetCompactCallbacks(
+    int compact,
+  ) {
+    return _SetCompactCallbacks(
+      compact,
+    );
+  }
+
+  late final _SetCompactCallbacks_ptr =
+      _lookup<ffi.NativeFunction<_c_SetCompactCallbacks>>(
+          'SetCompactCallbacks');
+  late final _dart_SetCompactCallbacks _SetCompactCallbacks =
+      _SetCompactCallbacks_ptr.asFunction<_dart_SetCompactCallbacks>();
+
+  /// Reads the next chunk of the response into the buffer handed to the Dart
+  /// side with OnResponseStarted.
+  int RequestContextRead(
+    ffi.Pointer<RequestContext> self,
+  ) {
+    return _RequestContextRead(
+      self,
+    );
+  }
+
+  late final _RequestContextRead_ptr =
+      _lookup<ffi.NativeFunction<_c_RequestContextRead>>('RequestContextRead');
+  late final _dart_RequestContextRead _RequestContextRead =
+      _RequestContextRead_ptr.asFunction<_dart_RequestContextRead>();
+
+  /// Cancels the request, or its retry if it waits for one. Must be used instead
+  /// of Cronet_UrlRequest_Cancel, as a retry replaces the request.
+  void RequestContextCancel(
+    ffi.Pointer<RequestContext> self,
+  ) {
+    return _RequestContextCancel(
+      self,
+    );
+  }
+
+  late final _RequestContextCancel_ptr =
+      _lookup<ffi.NativeFunction<_c_RequestContextCancel>>(
+          'RequestContextCancel');
+  late final _dart_RequestContextCancel _RequestContextCancel =
+      _RequestContextCancel_ptr.asFunction<_dart_RequestContextCancel>();
+
+  /// Destroys the request and everything allocated for it. Must only be called
+  /// once the request is done.
+  void RequestContextDestroy(
+    ffi.Pointer<RequestContext> self,
+  ) {
+    return _RequestContextDestroy(
+      self,
+    );
+  }
+
+  late final _RequestContextDestroy_ptr =
+      _lookup<ffi.NativeFunction<_c_RequestContextDestroy>>(
+          'RequestContextDestroy');
+  late final _dart_RequestContextDestroy _RequestContextDestroy =
+      _RequestContextDestroy_ptr.asFunction<_dart_RequestContextDestroy>();
+
+  /// Whether the request body can be compressed with |compression|, one of
+  /// COMPRESSION_*, in this build.
+  int UploadCompressionSupported(
+    int compression,
+  ) {
+    return _UploadCompressionSupported(
+      compression,
+    );
+  }
+
+  late final _UploadCompressionSupported_ptr =
+      _lookup<ffi.NativeFunction<_c_UploadCompressionSupported>>(
+          'UploadCompressionSupported');
+  late final _dart_UploadCompressionSupported _UploadCompressionSupported =
+      _UploadCompressionSupported_ptr
+          .asFunction<_dart_UploadCompressionSupported>();
+
+  /// Sets the size of the file at |path| to |length| and reserves its disk space
+  /// where supported, creating the file if needed. Returns 0 or an errno
+  /// value.
+  int FileSinkPreallocate(
+    ffi.Pointer<ffi.Int8> path,
+    int length,
+  ) {
+    return _FileSinkPreallocate(
+      path,
+      length,
+    );
+  }
+
+  late final _FileSinkPreallocate_ptr =
+      _lookup<ffi.NativeFunction<_c_FileSinkPreallocate>>(
+          'FileSinkPreallocate');
+  late final _dart_FileSinkPreallocate _FileSinkPreallocate =
+      _FileSinkPreallocate_ptr.asFunction<_dart_FileSinkPreallocate>();
+
   /// Callbacks. ISSUE: https://github.com/dart-lang/sdk/issues/37022
   void OnRedirectReceived(
     ffi.Pointer<Cronet_UrlRequestCallbackPtr> self,
@@ -460,6 +912,202 @@ class SampleExecutor extends ffi.Opaque {}
 
 class UploadDataProvider extends ffi.Opaque {}
 
+class RequestContext extends ffi.Opaque {}
+
+/// A redirect followed by a request.
+class RedirectEntry extends ffi.Struct {
+  external ffi.Pointer<ffi.Int8> location;
+
+  @ffi.Int32()
+  external int status_code;
+}
+
+/// A part of a multipart/form-data request body. See
+/// RequestDescriptor.multipart_parts.
+class MultipartPart extends ffi.Struct {
+  external ffi.Pointer<ffi.Int8> name;
+
+  /// File name the part is sent with, or null.
+  external ffi.Pointer<ffi.Int8> filename;
+
+  /// Content-Type of the part, or null.
+  external ffi.Pointer<ffi.Int8> content_type;
+
+  /// Content of the part: the |length| bytes at |data| if |path| is null,
+  /// copied when the request is started. Otherwise |length| bytes of the file
+  /// at |path| from |offset|, or the rest of it if |length| is -1, read while
+  /// the part is being uploaded.
+  external ffi.Pointer<ffi.Uint8> data;
+
+  external ffi.Pointer<ffi.Int8> path;
+
+  @ffi.Int64()
+  external int offset;
+
+  @ffi.Int64()
+  external int length;
+}
+
+class Cronet_UrlRequestParamsPtr extends ffi.Opaque {}
+
+class Cronet_HttpHeaderPtr extends ffi.Opaque {}
+
+/// Describes a single request to be started by StartRequests.
+///
+/// Fields above |result| are filled by the Dart side, the rest are written
+/// back by the wrapper.
+class RequestDescriptor extends ffi.Struct {
+  /// Port to which the callbacks of this request are dispatched.
+  @ffi.Int64()
+  external int port;
+
+  external ffi.Pointer<ffi.Int8> url;
+
+  external ffi.Pointer<ffi.Int8> method;
+
+  /// Packed request headers. See UrlRequestParamsAddHeaders.
+  external ffi.Pointer<ffi.Int8> headers;
+
+  @ffi.Int32()
+  external int num_headers;
+
+  /// Length of the request body. An upload data provider is attached to the
+  /// request if it is greater than 0.
+  @ffi.Int64()
+  external int upload_length;
+
+  /// One of COMPRESSION_*. Unless COMPRESSION_NONE, the |upload_length| bytes
+  /// at |upload_data| are copied and compressed natively while being uploaded,
+  /// instead of being read from the Dart side.
+  @ffi.Int32()
+  external int upload_compression;
+
+  external ffi.Pointer<ffi.Uint8> upload_data;
+
+  /// Parts of a multipart/form-data body separated by |multipart_boundary|,
+  /// produced natively while being uploaded. Takes the place of the body of
+  /// |upload_length| bytes if |num_multipart_parts| is greater than 0.
+  external ffi.Pointer<MultipartPart> multipart_parts;
+
+  @ffi.Int32()
+  external int num_multipart_parts;
+
+  external ffi.Pointer<ffi.Int8> multipart_boundary;
+
+  /// One of Cronet_UrlRequestParams_REQUEST_PRIORITY.
+  @ffi.Int32()
+  external int priority;
+
+  /// Number of redirects to follow. 0 cancels the request on a redirect.
+  @ffi.Int32()
+  external int max_redirects;
+
+  /// REDIRECT_* flags the redirects are checked against.
+  @ffi.Int32()
+  external int redirect_flags;
+
+  /// Non zero to accumulate the whole response body natively and deliver it
+  /// with OnSucceeded instead of a message per read.
+  @ffi.Int32()
+  external int aggregate_body;
+
+  /// One of FRAMING_*. Unless FRAMING_NONE, the response body is split into
+  /// records natively and delivered with OnRecordsRead.
+  @ffi.Int32()
+  external int framing;
+
+  /// Milliseconds to wait for the response headers, for a read to complete and
+  /// for the whole request. 0 waits forever. The request is cancelled once one
+  /// of them expires.
+  @ffi.Int32()
+  external int connect_timeout_ms;
+
+  @ffi.Int32()
+  external int read_timeout_ms;
+
+  @ffi.Int32()
+  external int total_timeout_ms;
+
+  /// Milliseconds between two OnProgress callbacks while the request runs. 0
+  /// reports no progress.
+  @ffi.Int32()
+  external int progress_interval_ms;
+
+  /// Attempts made before a transient failure is reported. Only requests
+  /// without a body are retried, and only until their response starts.
+  @ffi.Int32()
+  external int max_attempts;
+
+  /// Backoff before the first retry, doubled for every retry up to
+  /// |retry_max_backoff_ms|. The actual delay is picked at random below it.
+  @ffi.Int32()
+  external int retry_backoff_ms;
+
+  @ffi.Int32()
+  external int retry_max_backoff_ms;
+
+  /// Percentage of a retry the request earns towards the retry budget shared
+  /// by every request.
+  @ffi.Int32()
+  external int retry_budget_percent;
+
+  /// File the response body is written to, at |sink_offset|, instead of being
+  /// delivered to the Dart side. Null delivers it.
+  external ffi.Pointer<ffi.Int8> sink_path;
+
+  @ffi.Int64()
+  external int sink_offset;
+
+  /// Length of the byte range the request asks for, or -1 if it doesn't ask
+  /// for one. A range request fails unless answered with 206 Partial Content
+  /// and no more than |sink_length| bytes.
+  @ffi.Int64()
+  external int sink_length;
+
+  /// Result of initializing and starting the request.
+  @ffi.Int32()
+  external int result;
+
+  /// Started request. Null if |result| isn't Cronet_RESULT_SUCCESS.
+  external ffi.Pointer<Cronet_UrlRequest> request;
+
+  /// Context owning the request and everything allocated for it. Null if
+  /// |result| isn't Cronet_RESULT_SUCCESS.
+  external ffi.Pointer<RequestContext> context;
+}
+
+/// A live request of an engine, see SnapshotRequests.
+class RequestSnapshot extends ffi.Struct {
+  external ffi.Pointer<ffi.Int8> url;
+
+  /// Milliseconds since the request was started.
+  @ffi.Int64()
+  external int age_ms;
+
+  /// Milliseconds since the request last moved: transferred bytes, followed a
+  /// redirect or changed its load state.
+  @ffi.Int64()
+  external int idle_ms;
+
+  @ffi.Int64()
+  external int bytes_sent;
+
+  @ffi.Int64()
+  external int bytes_received;
+
+  @ffi.Int32()
+  external int redirects;
+
+  /// Last Cronet_UrlRequestStatusListener_Status seen by the watchdog, INVALID
+  /// if the watchdog isn't running.
+  @ffi.Int32()
+  external int status;
+
+  /// Non zero if the watchdog flagged the request as stuck.
+  @ffi.Int32()
+  external int stuck;
+}
+
 class Cronet_EnginePtr extends ffi.Opaque {}
 
 class Cronet_BufferPtr extends ffi.Opaque {}
@@ -480,6 +1128,8 @@ class Cronet_UrlRequestCallbackPtr extends ffi.Opaque {}
 
 class Cronet_UploadDataSinkPtr extends ffi.Opaque {}
 
+class Cronet_UrlRequestStatusListenerPtr extends ffi.Opaque {}
+
 typedef _c_VersionString = ffi.Pointer<ffi.Int8> Function();
 
 typedef _dart_VersionString = ffi.Pointer<ffi.Int8> Function();
@@ -603,6 +1253,345 @@ typedef _dart_InitCronetExecutorApi = void Function(
   ffi.Pointer<ffi.NativeFunction<_typedefC_14>> Cronet_Runnable_Destroy,
 );
 
+typedef _typedefC_15 = ffi.Pointer<Cronet_UrlRequest> Function();
+
+typedef _typedefC_16 = ffi.Void Function(
+  ffi.Pointer<Cronet_UrlRequest>,
+);
+
+typedef _typedefC_17 = ffi.Int32 Function(
+  ffi.Pointer<Cronet_UrlRequest>,
+  ffi.Pointer<Cronet_EnginePtr>,
+  ffi.Pointer<ffi.Int8>,
+  ffi.Pointer<Cronet_UrlRequestParamsPtr>,
+  ffi.Pointer<Cronet_UrlRequestCallbackPtr>,
+  ffi.Pointer<Cronet_ExecutorPtr>,
+);
+
+typedef _typedefC_18 = ffi.Int32 Function(
+  ffi.Pointer<Cronet_UrlRequest>,
+);
+
+typedef _typedefC_19 = ffi.Void Function(
+  ffi.Pointer<Cronet_UrlRequestParamsPtr>,
+  ffi.Pointer<ffi.Int8>,
+);
+
+typedef _typedefC_20 = ffi.Void Function(
+  ffi.Pointer<Cronet_UrlRequestParamsPtr>,
+  ffi.Int32,
+);
+
+typedef _typedefC_21 = ffi.Void Function(
+  ffi.Pointer<Cronet_UrlRequestParamsPtr>,
+  ffi.Pointer<Cronet_UploadDataProviderPtr>,
+);
+
+typedef _typedefC_22 = ffi.Pointer<Cronet_UrlRequestCallbackPtr> Function(
+  ffi.Pointer<ffi.NativeFunction<Native_OnRedirectReceived>>,
+  ffi.Pointer<ffi.NativeFunction<Native_OnResponseStarted>>,
+  ffi.Pointer<ffi.NativeFunction<Native_OnReadCompleted>>,
+  ffi.Pointer<ffi.NativeFunction<Native_OnSucceeded>>,
+  ffi.Pointer<ffi.NativeFunction<Native_OnFailed>>,
+  ffi.Pointer<ffi.NativeFunction<Native_OnCanceled>>,
+);
+
+typedef _typedefC_23 = ffi.Pointer<Cronet_UploadDataProviderPtr> Function(
+  ffi.Pointer<ffi.NativeFunction<Native_UploadDataProvider_GetLength>>,
+  ffi.Pointer<ffi.NativeFunction<Native_UploadDataProvider_Read>>,
+  ffi.Pointer<ffi.NativeFunction<Native_UploadDataProvider_Rewind>>,
+  ffi.Pointer<ffi.NativeFunction<Native_UploadDataProvider_CloseFunc>>,
+);
+
+typedef _typedefC_24 = ffi.Void Function(
+  ffi.Pointer<Cronet_UploadDataProviderPtr>,
+  ffi.Pointer<ffi.Void>,
+);
+
+typedef _typedefC_25 = ffi.Pointer<Cronet_HttpHeaderPtr> Function();
+
+typedef _typedefC_26 = ffi.Void Function(
+  ffi.Pointer<Cronet_HttpHeaderPtr>,
+);
+
+typedef _typedefC_27 = ffi.Void Function(
+  ffi.Pointer<Cronet_HttpHeaderPtr>,
+  ffi.Pointer<ffi.Int8>,
+);
+
+typedef _typedefC_28 = ffi.Void Function(
+  ffi.Pointer<Cronet_HttpHeaderPtr>,
+  ffi.Pointer<ffi.Int8>,
+);
+
+typedef _typedefC_29 = ffi.Void Function(
+  ffi.Pointer<Cronet_UrlRequestParamsPtr>,
+  ffi.Pointer<Cronet_HttpHeaderPtr>,
+);
+
+typedef _typedefC_30 = ffi.Pointer<Cronet_UrlRequestParamsPtr> Function();
+
+typedef _typedefC_31 = ffi.Void Function(
+  ffi.Pointer<Cronet_UrlRequestParamsPtr>,
+);
+
+typedef _typedefC_32 = ffi.Void Function(
+  ffi.Pointer<Cronet_UrlRequestCallbackPtr>,
+);
+
+typedef _typedefC_33 = ffi.Void Function(
+  ffi.Pointer<Cronet_UrlRequestCallbackPtr>,
+  ffi.Pointer<ffi.Void>,
+);
+
+typedef _typedefC_34 = ffi.Pointer<ffi.Void> Function(
+  ffi.Pointer<Cronet_UrlRequestCallbackPtr>,
+);
+
+typedef _typedefC_35 = ffi.Void Function(
+  ffi.Pointer<Cronet_UploadDataProviderPtr>,
+);
+
+typedef _typedefC_36 = ffi.Void Function(
+  ffi.Pointer<Cronet_BufferPtr>,
+);
+
+typedef _typedefC_37 = ffi.Int32 Function(
+  ffi.Pointer<Cronet_UrlRequest>,
+  ffi.Pointer<Cronet_BufferPtr>,
+);
+
+typedef _typedefC_38 = ffi.Int32 Function(
+  ffi.Pointer<Cronet_UrlRequest>,
+);
+
+typedef _typedefC_39 = ffi.Void Function(
+  ffi.Pointer<Cronet_UrlRequest>,
+);
+
+typedef _typedefC_40 = ffi.Uint32 Function(
+  ffi.Pointer<Cronet_UrlResponseInfoPtr>,
+);
+
+typedef _typedefC_41 = ffi.Pointer<Cronet_HttpHeaderPtr> Function(
+  ffi.Pointer<Cronet_UrlResponseInfoPtr>,
+  ffi.Uint32,
+);
+
+typedef _typedefC_42 = ffi.Pointer<ffi.Int8> Function(
+  ffi.Pointer<Cronet_HttpHeaderPtr>,
+);
+
+typedef _typedefC_43 = ffi.Pointer<ffi.Int8> Function(
+  ffi.Pointer<Cronet_HttpHeaderPtr>,
+);
+
+typedef _typedefC_44 = ffi.Pointer<ffi.Void> Function(
+  ffi.Pointer<Cronet_BufferPtr>,
+);
+
+typedef _typedefC_45 = ffi.Int32 Function(
+  ffi.Pointer<Cronet_ErrorPtr>,
+);
+
+typedef _typedefC_46 = ffi.Int32 Function(
+  ffi.Pointer<Cronet_ErrorPtr>,
+);
+
+typedef _typedefC_47 = ffi.Uint8 Function(
+  ffi.Pointer<Cronet_ErrorPtr>,
+);
+
+typedef _typedefC_48 = ffi.Int32 Function(
+  ffi.Pointer<Cronet_ErrorPtr>,
+);
+
+typedef _typedefC_49 = ffi.Uint64 Function(
+  ffi.Pointer<Cronet_BufferPtr>,
+);
+
+typedef _typedefC_50 = ffi.Void Function(
+  ffi.Pointer<Cronet_UploadDataSinkPtr>,
+  ffi.Uint64,
+  ffi.Uint8,
+);
+
+typedef _typedefC_51 = ffi.Void Function(
+  ffi.Pointer<Cronet_UploadDataSinkPtr>,
+  ffi.Pointer<ffi.Int8>,
+);
+
+typedef _typedefC_52 = ffi.Void Function(
+  ffi.Pointer<Cronet_UploadDataSinkPtr>,
+);
+
+typedef _typedefC_53 = ffi.Void Function(
+  ffi.Pointer<Cronet_UrlRequest>,
+  ffi.Pointer<Cronet_UrlRequestStatusListenerPtr>,
+);
+
+typedef _typedefC_54 = ffi.Pointer<Cronet_UrlRequestStatusListenerPtr> Function(
+  ffi.Pointer<
+      ffi.NativeFunction<
+          ffi.Void Function(
+              ffi.Pointer<Cronet_UrlRequestStatusListenerPtr>, ffi.Int32)>>,
+);
+
+typedef _typedefC_55 = ffi.Void Function(
+  ffi.Pointer<Cronet_UrlRequestStatusListenerPtr>,
+  ffi.Pointer<ffi.Void>,
+);
+
+typedef _typedefC_56 = ffi.Pointer<ffi.Void> Function(
+  ffi.Pointer<Cronet_UrlRequestStatusListenerPtr>,
+);
+
+typedef _typedefC_57 = ffi.Void Function(
+  ffi.Pointer<Cronet_UrlRequestStatusListenerPtr>,
+);
+
+typedef _c_InitCronetRequestApi = ffi.Void Function(
+  ffi.Pointer<ffi.NativeFunction<_typedefC_15>> Cronet_UrlRequest_Create,
+  ffi.Pointer<ffi.NativeFunction<_typedefC_16>> Cronet_UrlRequest_Destroy,
+  ffi.Pointer<ffi.NativeFunction<_typedefC_17>>
+      Cronet_UrlRequest_InitWithParams,
+  ffi.Pointer<ffi.NativeFunction<_typedefC_18>> Cronet_UrlRequest_Start,
+  ffi.Pointer<ffi.NativeFunction<_typedefC_19>>
+      Cronet_UrlRequestParams_http_method_set,
+  ffi.Pointer<ffi.NativeFunction<_typedefC_20>>
+      Cronet_UrlRequestParams_priority_set,
+  ffi.Pointer<ffi.NativeFunction<_typedefC_21>>
+      Cronet_UrlRequestParams_upload_data_provider_set,
+  ffi.Pointer<ffi.NativeFunction<_typedefC_22>>
+      Cronet_UrlRequestCallback_CreateWith,
+  ffi.Pointer<ffi.NativeFunction<_typedefC_23>>
+      Cronet_UploadDataProvider_CreateWith,
+  ffi.Pointer<ffi.NativeFunction<_typedefC_24>>
+      Cronet_UploadDataProvider_SetClientContext,
+  ffi.Pointer<ffi.NativeFunction<_typedefC_25>> Cronet_HttpHeader_Create,
+  ffi.Pointer<ffi.NativeFunction<_typedefC_26>> Cronet_HttpHeader_Destroy,
+  ffi.Pointer<ffi.NativeFunction<_typedefC_27>> Cronet_HttpHeader_name_set,
+  ffi.Pointer<ffi.NativeFunction<_typedefC_28>> Cronet_HttpHeader_value_set,
+  ffi.Pointer<ffi.NativeFunction<_typedefC_29>>
+      Cronet_UrlRequestParams_request_headers_add,
+  ffi.Pointer<ffi.NativeFunction<_typedefC_30>> Cronet_UrlRequestParams_Create,
+  ffi.Pointer<ffi.NativeFunction<_typedefC_31>> Cronet_UrlRequestParams_Destroy,
+  ffi.Pointer<ffi.NativeFunction<_typedefC_32>>
+      Cronet_UrlRequestCallback_Destroy,
+  ffi.Pointer<ffi.NativeFunction<_typedefC_33>>
+      Cronet_UrlRequestCallback_SetClientContext,
+  ffi.Pointer<ffi.NativeFunction<_typedefC_34>>
+      Cronet_UrlRequestCallback_GetClientContext,
+  ffi.Pointer<ffi.NativeFunction<_typedefC_35>>
+      Cronet_UploadDataProvider_Destroy,
+  ffi.Pointer<ffi.NativeFunction<_typedefC_36>> Cronet_Buffer_Destroy,
+  ffi.Pointer<ffi.NativeFunction<_typedefC_37>> Cronet_UrlRequest_Read,
+  ffi.Pointer<ffi.NativeFunction<_typedefC_38>>
+      Cronet_UrlRequest_FollowRedirect,
+  ffi.Pointer<ffi.NativeFunction<_typedefC_39>> Cronet_UrlRequest_Cancel,
+  ffi.Pointer<ffi.NativeFunction<_typedefC_40>>
+      Cronet_UrlResponseInfo_all_headers_list_size,
+  ffi.Pointer<ffi.NativeFunction<_typedefC_41>>
+      Cronet_UrlResponseInfo_all_headers_list_at,
+  ffi.Pointer<ffi.NativeFunction<_typedefC_42>> Cronet_HttpHeader_name_get,
+  ffi.Pointer<ffi.NativeFunction<_typedefC_43>> Cronet_HttpHeader_value_get,
+  ffi.Pointer<ffi.NativeFunction<_typedefC_44>> Cronet_Buffer_GetData,
+  ffi.Pointer<ffi.NativeFunction<_typedefC_45>> Cronet_Error_error_code_get,
+  ffi.Pointer<ffi.NativeFunction<_typedefC_46>>
+      Cronet_Error_internal_error_code_get,
+  ffi.Pointer<ffi.NativeFunction<_typedefC_47>>
+      Cronet_Error_immediately_retryable_get,
+  ffi.Pointer<ffi.NativeFunction<_typedefC_48>>
+      Cronet_Error_quic_detailed_error_code_get,
+  ffi.Pointer<ffi.NativeFunction<_typedefC_49>> Cronet_Buffer_GetSize,
+  ffi.Pointer<ffi.NativeFunction<_typedefC_50>>
+      Cronet_UploadDataSink_OnReadSucceeded,
+  ffi.Pointer<ffi.NativeFunction<_typedefC_51>>
+      Cronet_UploadDataSink_OnReadError,
+  ffi.Pointer<ffi.NativeFunction<_typedefC_52>>
+      Cronet_UploadDataSink_OnRewindSucceeded,
+  ffi.Pointer<ffi.NativeFunction<_typedefC_53>> Cronet_UrlRequest_GetStatus,
+  ffi.Pointer<ffi.NativeFunction<_typedefC_54>>
+      Cronet_UrlRequestStatusListener_CreateWith,
+  ffi.Pointer<ffi.NativeFunction<_typedefC_55>>
+      Cronet_UrlRequestStatusListener_SetClientContext,
+  ffi.Pointer<ffi.NativeFunction<_typedefC_56>>
+      Cronet_UrlRequestStatusListener_GetClientContext,
+  ffi.Pointer<ffi.NativeFunction<_typedefC_57>>
+      Cronet_UrlRequestStatusListener_Destroy,
+);
+
+typedef _dart_InitCronetRequestApi = void Function(
+  ffi.Pointer<ffi.NativeFunction<_typedefC_15>> Cronet_UrlRequest_Create,
+  ffi.Pointer<ffi.NativeFunction<_typedefC_16>> Cronet_UrlRequest_Destroy,
+  ffi.Pointer<ffi.NativeFunction<_typedefC_17>>
+      Cronet_UrlRequest_InitWithParams,
+  ffi.Pointer<ffi.NativeFunction<_typedefC_18>> Cronet_UrlRequest_Start,
+  ffi.Pointer<ffi.NativeFunction<_typedefC_19>>
+      Cronet_UrlRequestParams_http_method_set,
+  ffi.Pointer<ffi.NativeFunction<_typedefC_20>>
+      Cronet_UrlRequestParams_priority_set,
+  ffi.Pointer<ffi.NativeFunction<_typedefC_21>>
+      Cronet_UrlRequestParams_upload_data_provider_set,
+  ffi.Pointer<ffi.NativeFunction<_typedefC_22>>
+      Cronet_UrlRequestCallback_CreateWith,
+  ffi.Pointer<ffi.NativeFunction<_typedefC_23>>
+      Cronet_UploadDataProvider_CreateWith,
+  ffi.Pointer<ffi.NativeFunction<_typedefC_24>>
+      Cronet_UploadDataProvider_SetClientContext,
+  ffi.Pointer<ffi.NativeFunction<_typedefC_25>> Cronet_HttpHeader_Create,
+  ffi.Pointer<ffi.NativeFunction<_typedefC_26>> Cronet_HttpHeader_Destroy,
+  ffi.Pointer<ffi.NativeFunction<_typedefC_27>> Cronet_HttpHeader_name_set,
+  ffi.Pointer<ffi.NativeFunction<_typedefC_28>> Cronet_HttpHeader_value_set,
+  ffi.Pointer<ffi.NativeFunction<_typedefC_29>>
+      Cronet_UrlRequestParams_request_headers_add,
+  ffi.Pointer<ffi.NativeFunction<_typedefC_30>> Cronet_UrlRequestParams_Create,
+  ffi.Pointer<ffi.NativeFunction<_typedefC_31>> Cronet_UrlRequestParams_Destroy,
+  ffi.Pointer<ffi.NativeFunction<_typedefC_32>>
+      Cronet_UrlRequestCallback_Destroy,
+  ffi.Pointer<ffi.NativeFunction<_typedefC_33>>
+      Cronet_UrlRequestCallback_SetClientContext,
+  ffi.Pointer<ffi.NativeFunction<_typedefC_34>>
+      Cronet_UrlRequestCallback_GetClientContext,
+  ffi.Pointer<ffi.NativeFunction<_typedefC_35>>
+      Cronet_UploadDataProvider_Destroy,
+  ffi.Pointer<ffi.NativeFunction<_typedefC_36>> Cronet_Buffer_Destroy,
+  ffi.Pointer<ffi.NativeFunction<_typedefC_37>> Cronet_UrlRequest_Read,
+  ffi.Pointer<ffi.NativeFunction<_typedefC_38>>
+      Cronet_UrlRequest_FollowRedirect,
+  ffi.Pointer<ffi.NativeFunction<_typedefC_39>> Cronet_UrlRequest_Cancel,
+  ffi.Pointer<ffi.NativeFunction<_typedefC_40>>
+      Cronet_UrlResponseInfo_all_headers_list_size,
+  ffi.Pointer<ffi.NativeFunction<_typedefC_41>>
+      Cronet_UrlResponseInfo_all_headers_list_at,
+  ffi.Pointer<ffi.NativeFunction<_typedefC_42>> Cronet_HttpHeader_name_get,
+  ffi.Pointer<ffi.NativeFunction<_typedefC_43>> Cronet_HttpHeader_value_get,
+  ffi.Pointer<ffi.NativeFunction<_typedefC_44>> Cronet_Buffer_GetData,
+  ffi.Pointer<ffi.NativeFunction<_typedefC_45>> Cronet_Error_error_code_get,
+  ffi.Pointer<ffi.NativeFunction<_typedefC_46>>
+      Cronet_Error_internal_error_code_get,
+  ffi.Pointer<ffi.NativeFunction<_typedefC_47>>
+      Cronet_Error_immediately_retryable_get,
+  ffi.Pointer<ffi.NativeFunction<_typedefC_48>>
+      Cronet_Error_quic_detailed_error_code_get,
+  ffi.Pointer<ffi.NativeFunction<_typedefC_49>> Cronet_Buffer_GetSize,
+  ffi.Pointer<ffi.NativeFunction<_typedefC_50>>
+      Cronet_UploadDataSink_OnReadSucceeded,
+  ffi.Pointer<ffi.NativeFunction<_typedefC_51>>
+      Cronet_UploadDataSink_OnReadError,
+  ffi.Pointer<ffi.NativeFunction<_typedefC_52>>
+      Cronet_UploadDataSink_OnRewindSucceeded,
+  ffi.Pointer<ffi.NativeFunction<_typedefC_53>> Cronet_UrlRequest_GetStatus,
+  ffi.Pointer<ffi.NativeFunction<_typedefC_54>>
+      Cronet_UrlRequestStatusListener_CreateWith,
+  ffi.Pointer<ffi.NativeFunction<_typedefC_55>>
+      Cronet_UrlRequestStatusListener_SetClientContext,
+  ffi.Pointer<ffi.NativeFunction<_typedefC_56>>
+      Cronet_UrlRequestStatusListener_GetClientContext,
+  ffi.Pointer<ffi.NativeFunction<_typedefC_57>>
+      Cronet_UrlRequestStatusListener_Destroy,
+);
+
 typedef _c_RegisterHttpClient = ffi.Void Function(
   ffi.Handle h,
   ffi.Pointer<Cronet_EnginePtr> ce,
@@ -613,6 +1602,32 @@ typedef _dart_RegisterHttpClient = void Function(
   ffi.Pointer<Cronet_EnginePtr> ce,
 );
 
+typedef _c_ShareEngine = ffi.Int64 Function(
+  ffi.Pointer<Cronet_EnginePtr> ce,
+);
+
+typedef _dart_ShareEngine = int Function(
+  ffi.Pointer<Cronet_EnginePtr> ce,
+);
+
+typedef _c_AttachSharedEngine = ffi.Pointer<Cronet_EnginePtr> Function(
+  ffi.Handle h,
+  ffi.Int64 token,
+);
+
+typedef _dart_AttachSharedEngine = ffi.Pointer<Cronet_EnginePtr> Function(
+  Object h,
+  int token,
+);
+
+typedef _c_ReleaseSharedEngine = ffi.Uint8 Function(
+  ffi.Int64 token,
+);
+
+typedef _dart_ReleaseSharedEngine = int Function(
+  int token,
+);
+
 typedef _c_RegisterCallbackHandler = ffi.Void Function(
   ffi.Int64 nativePort,
   ffi.Pointer<Cronet_UrlRequest> rp,
@@ -631,6 +1646,150 @@ typedef _dart_RemoveRequest = void Function(
   ffi.Pointer<Cronet_UrlRequest> rp,
 );
 
+typedef _c_UrlRequestParamsAddHeaders = ffi.Void Function(
+  ffi.Pointer<Cronet_UrlRequestParamsPtr> params,
+  ffi.Pointer<ffi.Int8> headers,
+  ffi.Int32 count,
+);
+
+typedef _dart_UrlRequestParamsAddHeaders = void Function(
+  ffi.Pointer<Cronet_UrlRequestParamsPtr> params,
+  ffi.Pointer<ffi.Int8> headers,
+  int count,
+);
+
+typedef _c_StartRequests = ffi.Void Function(
+  ffi.Pointer<Cronet_EnginePtr> engine,
+  ffi.Pointer<RequestDescriptor> descriptors,
+  ffi.Int32 count,
+);
+
+typedef _dart_StartRequests = void Function(
+  ffi.Pointer<Cronet_EnginePtr> engine,
+  ffi.Pointer<RequestDescriptor> descriptors,
+  int count,
+);
+
+typedef _c_SnapshotRequests = ffi.Pointer<RequestSnapshot> Function(
+  ffi.Pointer<Cronet_EnginePtr> engine,
+  ffi.Pointer<ffi.Int32> count,
+);
+
+typedef _dart_SnapshotRequests = ffi.Pointer<RequestSnapshot> Function(
+  ffi.Pointer<Cronet_EnginePtr> engine,
+  ffi.Pointer<ffi.Int32> count,
+);
+
+typedef _c_SetStuckRequestThreshold = ffi.Void Function(
+  ffi.Pointer<Cronet_EnginePtr> engine,
+  ffi.Uint32 threshold_ms,
+);
+
+typedef _dart_SetStuckRequestThreshold = void Function(
+  ffi.Pointer<Cronet_EnginePtr> engine,
+  int threshold_ms,
+);
+
+typedef _c_SetTracingEnabled = ffi.Void Function(
+  ffi.Uint8 enabled,
+);
+
+typedef _dart_SetTracingEnabled = void Function(
+  int enabled,
+);
+
+typedef _c_TraceDartHandled = ffi.Void Function(
+  ffi.Int64 port,
+);
+
+typedef _dart_TraceDartHandled = void Function(
+  int port,
+);
+
+typedef _c_ExportTrace = ffi.Pointer<ffi.Int8> Function();
+
+typedef _dart_ExportTrace = ffi.Pointer<ffi.Int8> Function();
+
+typedef _c_ClearTrace = ffi.Void Function();
+
+typedef _dart_ClearTrace = void Function();
+
+typedef _c_ReadMemoryStats = ffi.Void Function(
+  ffi.Pointer<ffi.Int64> stats,
+);
+
+typedef _dart_ReadMemoryStats = void Function(
+  ffi.Pointer<ffi.Int64> stats,
+);
+
+typedef _c_SetMemoryAlert = ffi.Void Function(
+  ffi.Int64 threshold_bytes,
+  ffi.Int64 port,
+);
+
+typedef _dart_SetMemoryAlert = void Function(
+  int threshold_bytes,
+  int port,
+);
+
+typedef _c_FreeString = ffi.Void Function(
+  ffi.Pointer<ffi.Int8> string,
+);
+
+typedef _dart_FreeString = void Function(
+  ffi.Pointer<ffi.Int8> string,
+);
+
+typedef _c_SetCompactCallbacks = ffi.Void Function(
+  ffi.Uint8 compact,
+);
+
+typedef _dart_SetCompactCallbacks = void Function(
+  int compact,
+);
+
+typedef _c_RequestContextRead = ffi.Int32 Function(
+  ffi.Pointer<RequestContext> self,
+);
+
+typedef _dart_RequestContextRead = int Function(
+  ffi.Pointer<RequestContext> self,
+);
+
+typedef _c_RequestContextCancel = ffi.Void Function(
+  ffi.Pointer<RequestContext> self,
+);
+
+typedef _dart_RequestContextCancel = void Function(
+  ffi.Pointer<RequestContext> self,
+);
+
+typedef _c_RequestContextDestroy = ffi.Void Function(
+  ffi.Pointer<RequestContext> self,
+);
+
+typedef _dart_RequestContextDestroy = void Function(
+  ffi.Pointer<RequestContext> self,
+);
+
+typedef _c_UploadCompressionSupported = ffi.Uint8 Function(
+  ffi.Int32 compression,
+);
+
+typedef _dart_UploadCompressionSupported = int Function(
+  int compression,
+);
+
+typedef _c_FileSinkPreallocate = ffi.Int32 Function(
+  ffi.Pointer<ffi.Int8> path,
+  ffi.Int64 length,
+);
+
+typedef _dart_FileSinkPreallocate = int Function(
+  ffi.Pointer<ffi.Int8> path,
+  int length,
+);
+
 typedef Native_OnRedirectReceived = ffi.Void Function(
   ffi.Pointer<Cronet_UrlRequestCallbackPtr> self,
   ffi.Pointer<Cronet_UrlRequest> request,
@@ -804,3 +1963,47 @@ typedef Native_UploadDataProvider_CloseFunc = ffi.Void Function(
 typedef _dart_UploadDataProvider_CloseFunc = void Function(
   ffi.Pointer<Cronet_UploadDataProviderPtr> self,
 );
+
+const int REDIRECT_SAME_ORIGIN_ONLY = 1;
+
+const int REDIRECT_ALLOW_HTTP = 2;
+
+const int REDIRECT_ALLOW_HTTPS = 4;
+
+const int REDIRECT_STRIP_AUTH_CROSS_ORIGIN = 8;
+
+const int REDIRECT_DENIED_CROSS_ORIGIN = 1;
+
+const int REDIRECT_DENIED_SCHEME = 2;
+
+const int REDIRECT_DENIED_CREDENTIALS = 3;
+
+const int FRAMING_NONE = 0;
+
+const int FRAMING_NDJSON = 1;
+
+const int FRAMING_SSE = 2;
+
+const int FRAMING_ERROR_INVALID_UTF8 = 1;
+
+const int FRAMING_ERROR_RECORD_TOO_LONG = 2;
+
+const int TIMEOUT_CONNECT = 1;
+
+const int TIMEOUT_READ = 2;
+
+const int TIMEOUT_TOTAL = 3;
+
+const int COMPRESSION_NONE = 0;
+
+const int COMPRESSION_GZIP = 1;
+
+const int COMPRESSION_DEFLATE = 2;
+
+const int COMPRESSION_ZSTD = 3;
+
+const int SINK_ERROR_IO = 1;
+
+const int SINK_ERROR_NOT_PARTIAL = 2;
+
+const int SINK_ERROR_TOO_LONG = 3;
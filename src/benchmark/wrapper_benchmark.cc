@@ -0,0 +1,267 @@
+// Copyright (c) 2021, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// Microbenchmarks of the hot paths of the wrapper, run without Dart or the
+// network: the wrapper sources are linked against the fake Cronet library and
+// messages to Dart are posted to a stub that drops them.
+//
+// Reports the time and the heap allocations per operation of
+//   executor:  SampleExecutor::Execute until RunTasksInQueue runs the task.
+//   dispatch:  CallbackArgBuilder and DispatchCallback of one message.
+//   upload:    UploadDataProvider::ReadFunc filling a Cronet buffer from a
+//              native body.
+//
+// Usage: wrapper_benchmark [iterations scale, 1 by default]
+
+#include "../../third_party/cronet/cronet.idl_c.h"
+#include "../../third_party/cronet_impl/sample_executor.h"
+#include "../multipart_source.h"
+#include "../trace_buffer.h"
+#include "../upload_data_provider.h"
+#include "../wrapper_utils.h"
+
+#include <atomic>
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+// Heap allocations of every thread, counted by interposing malloc where the C
+// library allows it. operator new allocates through malloc as well.
+static std::atomic<uint64_t> allocations{0};
+
+#if defined(__GLIBC__)
+#define COUNTS_ALLOCATIONS 1
+
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *pointer, size_t size);
+void __libc_free(void *pointer);
+
+void *malloc(size_t size) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  return __libc_calloc(count, size);
+}
+
+void *realloc(void *pointer, size_t size) {
+  if (pointer == nullptr) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+  }
+  return __libc_realloc(pointer, size);
+}
+
+void free(void *pointer) { __libc_free(pointer); }
+}
+#else
+#define COUNTS_ALLOCATIONS 0
+#endif
+
+// Defined in wrapper.cc, which isn't part of the benchmark.
+void *(*_Cronet_Buffer_GetData)(Cronet_BufferPtr self);
+uint64_t (*_Cronet_Buffer_GetSize)(Cronet_BufferPtr self);
+void (*_Cronet_UploadDataSink_OnReadSucceeded)(Cronet_UploadDataSinkPtr self,
+                                               uint64_t bytes_read,
+                                               bool final_chunk);
+void (*_Cronet_UploadDataSink_OnReadError)(Cronet_UploadDataSinkPtr self,
+                                           Cronet_String error_message);
+void (*_Cronet_UploadDataSink_OnRewindSucceeded)(
+    Cronet_UploadDataSinkPtr self);
+
+extern std::unordered_map<Cronet_UrlRequestPtr, Dart_Port> requestNativePorts;
+
+using Clock = std::chrono::steady_clock;
+
+struct Result {
+  uint64_t iterations;
+  Clock::duration elapsed;
+  uint64_t allocations;
+  // Bytes moved, for throughput. 0 if it doesn't apply.
+  uint64_t bytes;
+};
+
+static void Report(const char *name, const Result &result) {
+  double ns = std::chrono::duration<double, std::nano>(result.elapsed).count();
+  printf("%-18s %10llu ops %12.1f ns/op", name,
+         static_cast<unsigned long long>(result.iterations),
+         ns / result.iterations);
+  if (COUNTS_ALLOCATIONS) {
+    printf(" %8.2f allocs/op",
+           static_cast<double>(result.allocations) / result.iterations);
+  } else {
+    printf(" %8s allocs/op", "-");
+  }
+  if (result.bytes > 0) {
+    printf(" %10.1f MB/s", result.bytes / (ns / 1e9) / 1e6);
+  }
+  printf("\n");
+}
+
+// Stand-in for the Dart VM. Takes ownership of external typed data the way
+// the VM does, by running their finalizers, here right away.
+static bool PostCObjectStub(Dart_Port_DL port, Dart_CObject *message) {
+  if (message->type == Dart_CObject_kArray) {
+    for (intptr_t i = 0; i < message->value.as_array.length; i++) {
+      PostCObjectStub(port, message->value.as_array.values[i]);
+    }
+  } else if (message->type == Dart_CObject_kExternalTypedData) {
+    message->value.as_external_typed_data.callback(
+        nullptr, message->value.as_external_typed_data.peer);
+  }
+  return true;
+}
+
+/* executor */
+
+static std::atomic<bool> taskRan{false};
+
+static void RunTask(Cronet_RunnablePtr self) {
+  taskRan.store(true, std::memory_order_release);
+}
+
+// One task at a time, so that each measures the latency from Execute to the
+// executor thread running it rather than the throughput of the queue. Cronet
+// allocates a runnable per task, as done here.
+static Result BenchmarkExecutor(uint64_t iterations) {
+  SampleExecutor executor;
+  executor.Init();
+  Cronet_ExecutorPtr cronet_executor = executor.GetExecutor();
+  uint64_t before = allocations.load();
+  Clock::time_point start = Clock::now();
+  for (uint64_t i = 0; i < iterations; i++) {
+    taskRan.store(false, std::memory_order_relaxed);
+    Cronet_Executor_Execute(cronet_executor,
+                            Cronet_Runnable_CreateWith(RunTask));
+    while (!taskRan.load(std::memory_order_acquire)) {
+    }
+  }
+  Clock::duration elapsed = Clock::now() - start;
+  return {iterations, elapsed, allocations.load() - before, 0};
+}
+
+/* dispatch */
+
+// A read completion, the most frequent callback.
+static Result BenchmarkDispatch(uint64_t iterations) {
+  Cronet_UrlRequestPtr request = reinterpret_cast<Cronet_UrlRequestPtr>(1);
+  requestNativePorts[request] = 1;
+  uint64_t before = allocations.load();
+  Clock::time_point start = Clock::now();
+  for (uint64_t i = 0; i < iterations; i++) {
+    DispatchCallback("OnReadCompleted", request,
+                     CallbackArgBuilder(4, request, nullptr, nullptr,
+                                        static_cast<uintptr_t>(i)));
+  }
+  Clock::duration elapsed = Clock::now() - start;
+  requestNativePorts.erase(request);
+  return {iterations, elapsed, allocations.load() - before, 0};
+}
+
+// The same posted as arrays holding the name of the callback and external
+// typed data of its arguments.
+static Result BenchmarkMessageDispatch(uint64_t iterations) {
+  UseCompactCallbacks(false);
+  Result result = BenchmarkDispatch(iterations);
+  UseCompactCallbacks(true);
+  return result;
+}
+
+// The same with every dispatch recorded in the trace.
+static Result BenchmarkTracedDispatch(uint64_t iterations) {
+  TraceBuffer::SetEnabled(true);
+  Result result = BenchmarkDispatch(iterations);
+  TraceBuffer::SetEnabled(false);
+  return result;
+}
+
+/* upload */
+
+// Bytes of the current body read so far, and of all bodies.
+static uint64_t uploaded = 0;
+static uint64_t uploadedTotal = 0;
+
+static void OnUploadReadSucceeded(Cronet_UploadDataSinkPtr self,
+                                  uint64_t bytes_read, bool final_chunk) {
+  uploaded += bytes_read;
+  uploadedTotal += bytes_read;
+}
+
+static void OnUploadReadError(Cronet_UploadDataSinkPtr self,
+                              Cronet_String error_message) {
+  fprintf(stderr, "upload failed: %s\n", error_message);
+  exit(1);
+}
+
+static void OnUploadRewindSucceeded(Cronet_UploadDataSinkPtr self) {}
+
+// A 16 MiB multipart body, read into the 32 KiB buffers Cronet uses.
+static Result BenchmarkUpload(uint64_t iterations) {
+  const size_t kBodySize = 16 * 1024 * 1024;
+  const uint64_t kBufferSize = 32 * 1024;
+  std::vector<uint8_t> body(kBodySize, 'x');
+  MultipartPart part = {"file", "body.bin", "application/octet-stream",
+                        body.data(), nullptr, 0,
+                        static_cast<int64_t>(kBodySize)};
+  int error = 0;
+  UploadDataProvider provider;
+  provider.Init(0, nullptr);
+  provider.SetSource(MultipartSource::Create(&part, 1, "boundary", &error));
+  int64_t length = provider.GetLength();
+  Cronet_BufferPtr buffer = Cronet_Buffer_Create();
+  Cronet_Buffer_InitWithAlloc(buffer, kBufferSize);
+  Cronet_UploadDataSinkPtr sink = nullptr;
+  uploaded = 0;
+  uploadedTotal = 0;
+  uint64_t before = allocations.load();
+  Clock::time_point start = Clock::now();
+  for (uint64_t i = 0; i < iterations; i++) {
+    if (static_cast<int64_t>(uploaded) == length) {
+      provider.RewindFunc(sink);
+      uploaded = 0;
+    }
+    provider.ReadFunc(sink, buffer);
+  }
+  Clock::duration elapsed = Clock::now() - start;
+  uint64_t count = allocations.load() - before;
+  Cronet_Buffer_Destroy(buffer);
+  return {iterations, elapsed, count, uploadedTotal};
+}
+
+int main(int argc, char **argv) {
+  uint64_t scale = argc > 1 ? strtoull(argv[1], nullptr, 10) : 1;
+  if (scale == 0) {
+    fprintf(stderr, "usage: %s [iterations scale]\n", argv[0]);
+    return 1;
+  }
+  Dart_PostCObject_DL = PostCObjectStub;
+  InitCronetExecutorApi(Cronet_Executor_CreateWith,
+                        Cronet_Executor_SetClientContext,
+                        Cronet_Executor_GetClientContext,
+                        Cronet_Executor_Destroy, Cronet_Runnable_Run,
+                        Cronet_Runnable_Destroy);
+  _Cronet_Buffer_GetData = Cronet_Buffer_GetData;
+  _Cronet_Buffer_GetSize = Cronet_Buffer_GetSize;
+  _Cronet_UploadDataSink_OnReadSucceeded = OnUploadReadSucceeded;
+  _Cronet_UploadDataSink_OnReadError = OnUploadReadError;
+  _Cronet_UploadDataSink_OnRewindSucceeded = OnUploadRewindSucceeded;
+
+  // Warm up caches and the allocator before measuring.
+  BenchmarkExecutor(1000);
+  BenchmarkDispatch(1000);
+  BenchmarkMessageDispatch(1000);
+  BenchmarkUpload(1000);
+
+  Report("executor", BenchmarkExecutor(100000 * scale));
+  Report("dispatch", BenchmarkDispatch(1000000 * scale));
+  Report("dispatch messages", BenchmarkMessageDispatch(1000000 * scale));
+  Report("dispatch traced", BenchmarkTracedDispatch(1000000 * scale));
+  Report("upload", BenchmarkUpload(100000 * scale));
+  return 0;
+}
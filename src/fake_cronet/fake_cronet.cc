@@ -0,0 +1,809 @@
+// Copyright (c) 2021, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// Stand-in for the Cronet library, implementing the part of its C API used by
+// the wrapper and the Dart bindings. Responses are synthesized from memory on
+// a network thread per engine, so what a benchmark measures against it is
+// the cost of the wrapper and of the Dart side alone.
+//
+// The response to a URL is shaped by its query:
+//   size=N    Length of the body, 11 bytes by default.
+//   status=N  Status code, 200 by default.
+//   fail=N    Fails the request with Cronet_Error_ERROR_CODE N instead of
+//             responding.
+// A request body is read in full before the response starts.
+
+#include "../../third_party/cronet/cronet.idl_c.h"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Runs the tasks of an engine in order, on a thread of its own.
+class NetworkThread {
+public:
+  NetworkThread() : thread_(&NetworkThread::Run, this) {}
+
+  // Runs the tasks posted so far, then stops the thread.
+  ~NetworkThread() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopping_ = true;
+    }
+    wakeup_.notify_one();
+    thread_.join();
+  }
+
+  void Post(std::function<void()> task) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      tasks_.push_back(std::move(task));
+    }
+    wakeup_.notify_one();
+  }
+
+private:
+  void Run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      wakeup_.wait(lock, [this] { return stopping_ || !tasks_.empty(); });
+      if (tasks_.empty()) {
+        return;
+      }
+      std::function<void()> task = std::move(tasks_.front());
+      tasks_.pop_front();
+      lock.unlock();
+      task();
+      lock.lock();
+    }
+  }
+
+  std::mutex mutex_;
+  std::condition_variable wakeup_;
+  std::deque<std::function<void()>> tasks_;
+  bool stopping_ = false;
+  std::thread thread_;
+};
+
+struct Cronet_Engine {
+  NetworkThread *network = nullptr;
+};
+
+struct Cronet_EngineParams {};
+
+struct Cronet_QuicHint {};
+
+struct Cronet_Buffer {
+  void *data = nullptr;
+  uint64_t size = 0;
+};
+
+struct Cronet_Runnable {
+  std::function<void()> run;
+  Cronet_ClientContext client_context = nullptr;
+};
+
+struct Cronet_Executor {
+  Cronet_Executor_ExecuteFunc execute;
+  Cronet_ClientContext client_context;
+};
+
+struct Cronet_HttpHeader {
+  std::string name;
+  std::string value;
+};
+
+struct Cronet_UrlRequestParams {
+  std::string method = "GET";
+  std::vector<Cronet_HttpHeader> headers;
+  Cronet_UploadDataProviderPtr upload_data_provider = nullptr;
+};
+
+struct Cronet_UrlRequestCallback {
+  Cronet_UrlRequestCallback_OnRedirectReceivedFunc on_redirect_received;
+  Cronet_UrlRequestCallback_OnResponseStartedFunc on_response_started;
+  Cronet_UrlRequestCallback_OnReadCompletedFunc on_read_completed;
+  Cronet_UrlRequestCallback_OnSucceededFunc on_succeeded;
+  Cronet_UrlRequestCallback_OnFailedFunc on_failed;
+  Cronet_UrlRequestCallback_OnCanceledFunc on_canceled;
+  Cronet_ClientContext client_context;
+};
+
+struct Cronet_UploadDataProvider {
+  Cronet_UploadDataProvider_GetLengthFunc get_length;
+  Cronet_UploadDataProvider_ReadFunc read;
+  Cronet_UploadDataProvider_RewindFunc rewind;
+  Cronet_UploadDataProvider_CloseFunc close;
+  Cronet_ClientContext client_context;
+};
+
+struct Cronet_UrlRequestStatusListener {
+  Cronet_UrlRequestStatusListener_OnStatusFunc on_status;
+  Cronet_ClientContext client_context;
+};
+
+struct Cronet_UrlResponseInfo {
+  int32_t http_status_code = 200;
+  std::string http_status_text = "OK";
+  std::vector<Cronet_HttpHeader> all_headers;
+};
+
+struct Cronet_Error {
+  std::string message;
+  Cronet_Error_ERROR_CODE error_code = Cronet_Error_ERROR_CODE_ERROR_OTHER;
+};
+
+struct Cronet_UploadDataSink {
+  Cronet_UrlRequestPtr request;
+};
+
+enum class RequestState { kCreated, kUploading, kWaiting, kReading, kDone };
+
+// Everything but creation, destruction and the functions called before the
+// request starts is handled on the network thread of the engine.
+struct Cronet_UrlRequest {
+  Cronet_EnginePtr engine = nullptr;
+  Cronet_UrlRequestCallbackPtr callback = nullptr;
+  Cronet_ExecutorPtr executor = nullptr;
+  Cronet_UploadDataProviderPtr upload = nullptr;
+  Cronet_UploadDataSink sink = {nullptr};
+  Cronet_Buffer upload_buffer;
+  int64_t upload_length = 0;
+  int64_t uploaded = 0;
+  RequestState state = RequestState::kCreated;
+  Cronet_UrlResponseInfo info;
+  Cronet_Error error;
+  int64_t body_length = 11;
+  int64_t body_read = 0;
+  int32_t fail = 0;
+  // Held while a status listener is called. No listener is called once the
+  // request is destroyed, as with Cronet, whose executor is gone by then.
+  std::mutex status_lock;
+  bool destroyed = false;
+};
+
+static const size_t kUploadBufferSize = 32 * 1024;
+
+// Content of every body.
+static const uint8_t *Payload() {
+  static const size_t kSize = 64 * 1024;
+  static const uint8_t *payload = [] {
+    static uint8_t bytes[kSize];
+    const char text[] = "hello world";
+    for (size_t i = 0; i < kSize; i++) {
+      bytes[i] = static_cast<uint8_t>(text[i % (sizeof(text) - 1)]);
+    }
+    return bytes;
+  }();
+  return payload;
+}
+
+static const size_t kPayloadSize = 64 * 1024;
+
+static int64_t QueryValue(const std::string &url, const char *name,
+                          int64_t fallback) {
+  size_t query = url.find('?');
+  if (query == std::string::npos) {
+    return fallback;
+  }
+  std::string key = std::string(name) + "=";
+  size_t start = query + 1;
+  while (start < url.size()) {
+    size_t end = url.find('&', start);
+    if (end == std::string::npos) {
+      end = url.size();
+    }
+    if (url.compare(start, key.size(), key) == 0) {
+      return strtoll(url.c_str() + start + key.size(), nullptr, 10);
+    }
+    start = end + 1;
+  }
+  return fallback;
+}
+
+static void Execute(Cronet_UrlRequestPtr request, std::function<void()> task) {
+  Cronet_RunnablePtr runnable = new Cronet_Runnable();
+  runnable->run = std::move(task);
+  request->executor->execute(request->executor, runnable);
+}
+
+static void Post(Cronet_UrlRequestPtr request, std::function<void()> task) {
+  request->engine->network->Post(std::move(task));
+}
+
+// Ends |request|, the final callback follows.
+static void Finish(Cronet_UrlRequestPtr request) {
+  request->state = RequestState::kDone;
+  if (request->upload != nullptr) {
+    Cronet_UploadDataProviderPtr upload = request->upload;
+    Execute(request, [upload] { upload->close(upload); });
+  }
+}
+
+static void Fail(Cronet_UrlRequestPtr request, Cronet_Error_ERROR_CODE code,
+                 const char *message) {
+  bool started = request->state == RequestState::kReading;
+  Finish(request);
+  request->error.error_code = code;
+  request->error.message = message;
+  Execute(request, [request, started] {
+    request->callback->on_failed(request->callback, request,
+                                 started ? &request->info : nullptr,
+                                 &request->error);
+  });
+}
+
+static void Respond(Cronet_UrlRequestPtr request) {
+  if (request->fail != 0) {
+    Fail(request, static_cast<Cronet_Error_ERROR_CODE>(request->fail),
+         "Failed as asked by the URL");
+    return;
+  }
+  request->state = RequestState::kReading;
+  Execute(request, [request] {
+    request->callback->on_response_started(request->callback, request,
+                                           &request->info);
+  });
+}
+
+static void ReadUpload(Cronet_UrlRequestPtr request) {
+  Execute(request, [request] {
+    request->upload->read(request->upload, &request->sink,
+                          &request->upload_buffer);
+  });
+}
+
+extern "C" {
+
+/* Engine */
+
+CRONET_EXPORT Cronet_EnginePtr Cronet_Engine_Create(void) {
+  return new Cronet_Engine();
+}
+
+CRONET_EXPORT void Cronet_Engine_Destroy(Cronet_EnginePtr self) {
+  delete self->network;
+  delete self;
+}
+
+CRONET_EXPORT Cronet_RESULT Cronet_Engine_StartWithParams(
+    Cronet_EnginePtr self, Cronet_EngineParamsPtr params) {
+  if (self->network != nullptr) {
+    return Cronet_RESULT_ILLEGAL_STATE_ENGINE_ALREADY_STARTED;
+  }
+  self->network = new NetworkThread();
+  return Cronet_RESULT_SUCCESS;
+}
+
+CRONET_EXPORT Cronet_RESULT Cronet_Engine_Shutdown(Cronet_EnginePtr self) {
+  delete self->network;
+  self->network = nullptr;
+  return Cronet_RESULT_SUCCESS;
+}
+
+CRONET_EXPORT Cronet_String Cronet_Engine_GetVersionString(
+    Cronet_EnginePtr self) {
+  return "fake";
+}
+
+CRONET_EXPORT Cronet_EngineParamsPtr Cronet_EngineParams_Create(void) {
+  return new Cronet_EngineParams();
+}
+
+CRONET_EXPORT void Cronet_EngineParams_Destroy(Cronet_EngineParamsPtr self) {
+  delete self;
+}
+
+CRONET_EXPORT void Cronet_EngineParams_user_agent_set(
+    Cronet_EngineParamsPtr self, const Cronet_String user_agent) {}
+
+CRONET_EXPORT void Cronet_EngineParams_enable_quic_set(
+    Cronet_EngineParamsPtr self, const bool enable_quic) {}
+
+CRONET_EXPORT void Cronet_EngineParams_enable_http2_set(
+    Cronet_EngineParamsPtr self, const bool enable_http2) {}
+
+CRONET_EXPORT void Cronet_EngineParams_enable_brotli_set(
+    Cronet_EngineParamsPtr self, const bool enable_brotli) {}
+
+CRONET_EXPORT void Cronet_EngineParams_accept_language_set(
+    Cronet_EngineParamsPtr self, const Cronet_String accept_language) {}
+
+CRONET_EXPORT void Cronet_EngineParams_quic_hints_add(
+    Cronet_EngineParamsPtr self, const Cronet_QuicHintPtr element) {}
+
+CRONET_EXPORT Cronet_QuicHintPtr Cronet_QuicHint_Create(void) {
+  return new Cronet_QuicHint();
+}
+
+CRONET_EXPORT void Cronet_QuicHint_Destroy(Cronet_QuicHintPtr self) {
+  delete self;
+}
+
+CRONET_EXPORT void Cronet_QuicHint_host_set(Cronet_QuicHintPtr self,
+                                            const Cronet_String host) {}
+
+CRONET_EXPORT void Cronet_QuicHint_port_set(Cronet_QuicHintPtr self,
+                                            const int32_t port) {}
+
+CRONET_EXPORT void Cronet_QuicHint_alternate_port_set(
+    Cronet_QuicHintPtr self, const int32_t alternate_port) {}
+
+/* Buffer */
+
+CRONET_EXPORT Cronet_BufferPtr Cronet_Buffer_Create(void) {
+  return new Cronet_Buffer();
+}
+
+CRONET_EXPORT void Cronet_Buffer_InitWithAlloc(Cronet_BufferPtr self,
+                                               uint64_t size) {
+  self->data = malloc(static_cast<size_t>(size));
+  self->size = size;
+}
+
+CRONET_EXPORT Cronet_RawDataPtr Cronet_Buffer_GetData(Cronet_BufferPtr self) {
+  return self->data;
+}
+
+CRONET_EXPORT uint64_t Cronet_Buffer_GetSize(Cronet_BufferPtr self) {
+  return self->size;
+}
+
+CRONET_EXPORT void Cronet_Buffer_Destroy(Cronet_BufferPtr self) {
+  free(self->data);
+  delete self;
+}
+
+/* Executor */
+
+CRONET_EXPORT Cronet_ExecutorPtr
+Cronet_Executor_CreateWith(Cronet_Executor_ExecuteFunc ExecuteFunc) {
+  return new Cronet_Executor{ExecuteFunc};
+}
+
+CRONET_EXPORT void Cronet_Executor_Execute(Cronet_ExecutorPtr self,
+                                           Cronet_RunnablePtr command) {
+  self->execute(self, command);
+}
+
+CRONET_EXPORT void Cronet_Executor_SetClientContext(
+    Cronet_ExecutorPtr self, Cronet_ClientContext client_context) {
+  self->client_context = client_context;
+}
+
+CRONET_EXPORT Cronet_ClientContext
+Cronet_Executor_GetClientContext(Cronet_ExecutorPtr self) {
+  return self->client_context;
+}
+
+CRONET_EXPORT void Cronet_Executor_Destroy(Cronet_ExecutorPtr self) {
+  delete self;
+}
+
+CRONET_EXPORT Cronet_RunnablePtr
+Cronet_Runnable_CreateWith(Cronet_Runnable_RunFunc RunFunc) {
+  Cronet_RunnablePtr runnable = new Cronet_Runnable();
+  runnable->run = [runnable, RunFunc] { RunFunc(runnable); };
+  return runnable;
+}
+
+CRONET_EXPORT void Cronet_Runnable_SetClientContext(
+    Cronet_RunnablePtr self, Cronet_ClientContext client_context) {
+  self->client_context = client_context;
+}
+
+CRONET_EXPORT Cronet_ClientContext
+Cronet_Runnable_GetClientContext(Cronet_RunnablePtr self) {
+  return self->client_context;
+}
+
+CRONET_EXPORT void Cronet_Runnable_Run(Cronet_RunnablePtr self) {
+  self->run();
+}
+
+CRONET_EXPORT void Cronet_Runnable_Destroy(Cronet_RunnablePtr self) {
+  delete self;
+}
+
+/* Headers, response info and errors */
+
+CRONET_EXPORT Cronet_HttpHeaderPtr Cronet_HttpHeader_Create(void) {
+  return new Cronet_HttpHeader();
+}
+
+CRONET_EXPORT void Cronet_HttpHeader_Destroy(Cronet_HttpHeaderPtr self) {
+  delete self;
+}
+
+CRONET_EXPORT void Cronet_HttpHeader_name_set(Cronet_HttpHeaderPtr self,
+                                              const Cronet_String name) {
+  self->name = name;
+}
+
+CRONET_EXPORT void Cronet_HttpHeader_value_set(Cronet_HttpHeaderPtr self,
+                                               const Cronet_String value) {
+  self->value = value;
+}
+
+CRONET_EXPORT Cronet_String
+Cronet_HttpHeader_name_get(const Cronet_HttpHeaderPtr self) {
+  return self->name.c_str();
+}
+
+CRONET_EXPORT Cronet_String
+Cronet_HttpHeader_value_get(const Cronet_HttpHeaderPtr self) {
+  return self->value.c_str();
+}
+
+CRONET_EXPORT int32_t Cronet_UrlResponseInfo_http_status_code_get(
+    const Cronet_UrlResponseInfoPtr self) {
+  return self->http_status_code;
+}
+
+CRONET_EXPORT Cronet_String Cronet_UrlResponseInfo_http_status_text_get(
+    const Cronet_UrlResponseInfoPtr self) {
+  return self->http_status_text.c_str();
+}
+
+CRONET_EXPORT uint32_t Cronet_UrlResponseInfo_all_headers_list_size(
+    const Cronet_UrlResponseInfoPtr self) {
+  return static_cast<uint32_t>(self->all_headers.size());
+}
+
+CRONET_EXPORT Cronet_HttpHeaderPtr Cronet_UrlResponseInfo_all_headers_list_at(
+    const Cronet_UrlResponseInfoPtr self, uint32_t index) {
+  return &self->all_headers[index];
+}
+
+CRONET_EXPORT Cronet_String Cronet_Error_message_get(const Cronet_ErrorPtr self) {
+  return self->message.c_str();
+}
+
+CRONET_EXPORT Cronet_Error_ERROR_CODE
+Cronet_Error_error_code_get(const Cronet_ErrorPtr self) {
+  return self->error_code;
+}
+
+CRONET_EXPORT int32_t
+Cronet_Error_internal_error_code_get(const Cronet_ErrorPtr self) {
+  return 0;
+}
+
+CRONET_EXPORT bool
+Cronet_Error_immediately_retryable_get(const Cronet_ErrorPtr self) {
+  return false;
+}
+
+CRONET_EXPORT int32_t
+Cronet_Error_quic_detailed_error_code_get(const Cronet_ErrorPtr self) {
+  return 0;
+}
+
+/* Request params and callbacks */
+
+CRONET_EXPORT Cronet_UrlRequestParamsPtr Cronet_UrlRequestParams_Create(void) {
+  return new Cronet_UrlRequestParams();
+}
+
+CRONET_EXPORT void Cronet_UrlRequestParams_Destroy(
+    Cronet_UrlRequestParamsPtr self) {
+  delete self;
+}
+
+CRONET_EXPORT void Cronet_UrlRequestParams_http_method_set(
+    Cronet_UrlRequestParamsPtr self, const Cronet_String http_method) {
+  self->method = http_method;
+}
+
+CRONET_EXPORT void Cronet_UrlRequestParams_priority_set(
+    Cronet_UrlRequestParamsPtr self,
+    const Cronet_UrlRequestParams_REQUEST_PRIORITY priority) {}
+
+CRONET_EXPORT void Cronet_UrlRequestParams_upload_data_provider_set(
+    Cronet_UrlRequestParamsPtr self,
+    const Cronet_UploadDataProviderPtr upload_data_provider) {
+  self->upload_data_provider = upload_data_provider;
+}
+
+CRONET_EXPORT void Cronet_UrlRequestParams_request_headers_add(
+    Cronet_UrlRequestParamsPtr self, const Cronet_HttpHeaderPtr element) {
+  self->headers.push_back(*element);
+}
+
+CRONET_EXPORT Cronet_UrlRequestCallbackPtr Cronet_UrlRequestCallback_CreateWith(
+    Cronet_UrlRequestCallback_OnRedirectReceivedFunc OnRedirectReceivedFunc,
+    Cronet_UrlRequestCallback_OnResponseStartedFunc OnResponseStartedFunc,
+    Cronet_UrlRequestCallback_OnReadCompletedFunc OnReadCompletedFunc,
+    Cronet_UrlRequestCallback_OnSucceededFunc OnSucceededFunc,
+    Cronet_UrlRequestCallback_OnFailedFunc OnFailedFunc,
+    Cronet_UrlRequestCallback_OnCanceledFunc OnCanceledFunc) {
+  return new Cronet_UrlRequestCallback{
+      OnRedirectReceivedFunc, OnResponseStartedFunc, OnReadCompletedFunc,
+      OnSucceededFunc,        OnFailedFunc,          OnCanceledFunc};
+}
+
+CRONET_EXPORT void Cronet_UrlRequestCallback_Destroy(
+    Cronet_UrlRequestCallbackPtr self) {
+  delete self;
+}
+
+CRONET_EXPORT void Cronet_UrlRequestCallback_SetClientContext(
+    Cronet_UrlRequestCallbackPtr self, Cronet_ClientContext client_context) {
+  self->client_context = client_context;
+}
+
+CRONET_EXPORT Cronet_ClientContext
+Cronet_UrlRequestCallback_GetClientContext(Cronet_UrlRequestCallbackPtr self) {
+  return self->client_context;
+}
+
+CRONET_EXPORT Cronet_UploadDataProviderPtr
+Cronet_UploadDataProvider_CreateWith(
+    Cronet_UploadDataProvider_GetLengthFunc GetLengthFunc,
+    Cronet_UploadDataProvider_ReadFunc ReadFunc,
+    Cronet_UploadDataProvider_RewindFunc RewindFunc,
+    Cronet_UploadDataProvider_CloseFunc CloseFunc) {
+  return new Cronet_UploadDataProvider{GetLengthFunc, ReadFunc, RewindFunc,
+                                       CloseFunc};
+}
+
+CRONET_EXPORT void Cronet_UploadDataProvider_Destroy(
+    Cronet_UploadDataProviderPtr self) {
+  delete self;
+}
+
+CRONET_EXPORT void Cronet_UploadDataProvider_SetClientContext(
+    Cronet_UploadDataProviderPtr self, Cronet_ClientContext client_context) {
+  self->client_context = client_context;
+}
+
+CRONET_EXPORT Cronet_ClientContext Cronet_UploadDataProvider_GetClientContext(
+    Cronet_UploadDataProviderPtr self) {
+  return self->client_context;
+}
+
+CRONET_EXPORT Cronet_UrlRequestStatusListenerPtr
+Cronet_UrlRequestStatusListener_CreateWith(
+    Cronet_UrlRequestStatusListener_OnStatusFunc OnStatusFunc) {
+  return new Cronet_UrlRequestStatusListener{OnStatusFunc};
+}
+
+CRONET_EXPORT void Cronet_UrlRequestStatusListener_SetClientContext(
+    Cronet_UrlRequestStatusListenerPtr self,
+    Cronet_ClientContext client_context) {
+  self->client_context = client_context;
+}
+
+CRONET_EXPORT Cronet_ClientContext
+Cronet_UrlRequestStatusListener_GetClientContext(
+    Cronet_UrlRequestStatusListenerPtr self) {
+  return self->client_context;
+}
+
+CRONET_EXPORT void Cronet_UrlRequestStatusListener_Destroy(
+    Cronet_UrlRequestStatusListenerPtr self) {
+  delete self;
+}
+
+/* Request */
+
+CRONET_EXPORT Cronet_UrlRequestPtr Cronet_UrlRequest_Create(void) {
+  return new Cronet_UrlRequest();
+}
+
+CRONET_EXPORT void Cronet_UrlRequest_Destroy(Cronet_UrlRequestPtr self) {
+  {
+    std::lock_guard<std::mutex> lock(self->status_lock);
+    self->destroyed = true;
+  }
+  if (self->engine == nullptr || self->engine->network == nullptr) {
+    free(self->upload_buffer.data);
+    delete self;
+    return;
+  }
+  // After the tasks already posted for the request.
+  Post(self, [self] {
+    free(self->upload_buffer.data);
+    delete self;
+  });
+}
+
+CRONET_EXPORT Cronet_RESULT Cronet_UrlRequest_InitWithParams(
+    Cronet_UrlRequestPtr self, Cronet_EnginePtr engine, Cronet_String url,
+    Cronet_UrlRequestParamsPtr params, Cronet_UrlRequestCallbackPtr callback,
+    Cronet_ExecutorPtr executor) {
+  if (url == nullptr) {
+    return Cronet_RESULT_NULL_POINTER_URL;
+  }
+  if (callback == nullptr) {
+    return Cronet_RESULT_NULL_POINTER_CALLBACK;
+  }
+  if (executor == nullptr) {
+    return Cronet_RESULT_NULL_POINTER_EXECUTOR;
+  }
+  if (engine->network == nullptr) {
+    return Cronet_RESULT_ILLEGAL_STATE;
+  }
+  self->engine = engine;
+  self->callback = callback;
+  self->executor = executor;
+  self->upload = params->upload_data_provider;
+  std::string location(url);
+  self->body_length = QueryValue(location, "size", 11);
+  self->info.http_status_code =
+      static_cast<int32_t>(QueryValue(location, "status", 200));
+  self->fail = static_cast<int32_t>(QueryValue(location, "fail", 0));
+  self->info.all_headers.push_back({"Content-Type", "text/plain"});
+  self->info.all_headers.push_back(
+      {"Content-Length", std::to_string(self->body_length)});
+  return Cronet_RESULT_SUCCESS;
+}
+
+CRONET_EXPORT Cronet_RESULT Cronet_UrlRequest_Start(Cronet_UrlRequestPtr self) {
+  if (self->engine == nullptr) {
+    return Cronet_RESULT_ILLEGAL_STATE_REQUEST_NOT_INITIALIZED;
+  }
+  Post(self, [self] {
+    if (self->state != RequestState::kCreated) {
+      return;
+    }
+    if (self->upload == nullptr) {
+      self->state = RequestState::kWaiting;
+      Respond(self);
+      return;
+    }
+    self->state = RequestState::kUploading;
+    self->sink.request = self;
+    self->upload_buffer.data = malloc(kUploadBufferSize);
+    self->upload_buffer.size = kUploadBufferSize;
+    Execute(self, [self] {
+      int64_t length = self->upload->get_length(self->upload);
+      Post(self, [self, length] {
+        if (self->state != RequestState::kUploading) {
+          return;
+        }
+        self->upload_length = length;
+        if (length == 0) {
+          self->state = RequestState::kWaiting;
+          Respond(self);
+        } else {
+          ReadUpload(self);
+        }
+      });
+    });
+  });
+  return Cronet_RESULT_SUCCESS;
+}
+
+CRONET_EXPORT Cronet_RESULT Cronet_UrlRequest_Read(Cronet_UrlRequestPtr self,
+                                                   Cronet_BufferPtr buffer) {
+  Post(self, [self, buffer] {
+    if (self->state != RequestState::kReading) {
+      // The buffer is released along with the request, as Cronet does.
+      Cronet_Buffer_Destroy(buffer);
+      return;
+    }
+    int64_t left = self->body_length - self->body_read;
+    if (left <= 0) {
+      Cronet_Buffer_Destroy(buffer);
+      Finish(self);
+      Execute(self, [self] {
+        self->callback->on_succeeded(self->callback, self, &self->info);
+      });
+      return;
+    }
+    uint64_t bytes = buffer->size;
+    if (bytes > kPayloadSize) {
+      bytes = kPayloadSize;
+    }
+    if (static_cast<int64_t>(bytes) > left) {
+      bytes = static_cast<uint64_t>(left);
+    }
+    memcpy(buffer->data, Payload(), static_cast<size_t>(bytes));
+    self->body_read += static_cast<int64_t>(bytes);
+    Execute(self, [self, buffer, bytes] {
+      self->callback->on_read_completed(self->callback, self, &self->info,
+                                        buffer, bytes);
+    });
+  });
+  return Cronet_RESULT_SUCCESS;
+}
+
+CRONET_EXPORT Cronet_RESULT
+Cronet_UrlRequest_FollowRedirect(Cronet_UrlRequestPtr self) {
+  // Never redirects.
+  return Cronet_RESULT_ILLEGAL_STATE_UNEXPECTED_REDIRECT;
+}
+
+CRONET_EXPORT void Cronet_UrlRequest_Cancel(Cronet_UrlRequestPtr self) {
+  if (self->engine == nullptr) {
+    return;
+  }
+  Post(self, [self] {
+    if (self->state == RequestState::kDone) {
+      return;
+    }
+    bool started = self->state == RequestState::kReading;
+    Finish(self);
+    Execute(self, [self, started] {
+      self->callback->on_canceled(self->callback, self,
+                                  started ? &self->info : nullptr);
+    });
+  });
+}
+
+CRONET_EXPORT void
+Cronet_UrlRequest_GetStatus(Cronet_UrlRequestPtr self,
+                            Cronet_UrlRequestStatusListenerPtr listener) {
+  // Reported from the network thread rather than the executor, which may be
+  // gone along with the request by then.
+  Post(self, [self, listener] {
+    std::lock_guard<std::mutex> lock(self->status_lock);
+    if (self->destroyed) {
+      return;
+    }
+    Cronet_UrlRequestStatusListener_Status status;
+    switch (self->state) {
+    case RequestState::kUploading:
+      status = Cronet_UrlRequestStatusListener_Status_SENDING_REQUEST;
+      break;
+    case RequestState::kWaiting:
+      status = Cronet_UrlRequestStatusListener_Status_WAITING_FOR_RESPONSE;
+      break;
+    case RequestState::kReading:
+      status = Cronet_UrlRequestStatusListener_Status_READING_RESPONSE;
+      break;
+    default:
+      status = Cronet_UrlRequestStatusListener_Status_INVALID;
+    }
+    listener->on_status(listener, status);
+  });
+}
+
+/* Upload */
+
+CRONET_EXPORT void Cronet_UploadDataSink_OnReadSucceeded(
+    Cronet_UploadDataSinkPtr self, uint64_t bytes_read, bool final_chunk) {
+  Cronet_UrlRequestPtr request = self->request;
+  Post(request, [request, bytes_read, final_chunk] {
+    if (request->state != RequestState::kUploading) {
+      return;
+    }
+    request->uploaded += static_cast<int64_t>(bytes_read);
+    bool done = request->upload_length < 0
+                    ? final_chunk
+                    : request->uploaded >= request->upload_length;
+    if (done) {
+      request->state = RequestState::kWaiting;
+      Respond(request);
+    } else {
+      ReadUpload(request);
+    }
+  });
+}
+
+CRONET_EXPORT void
+Cronet_UploadDataSink_OnReadError(Cronet_UploadDataSinkPtr self,
+                                  Cronet_String error_message) {
+  Cronet_UrlRequestPtr request = self->request;
+  std::string message(error_message);
+  Post(request, [request, message] {
+    if (request->state == RequestState::kUploading) {
+      Fail(request, Cronet_Error_ERROR_CODE_ERROR_CALLBACK, message.c_str());
+    }
+  });
+}
+
+CRONET_EXPORT void
+Cronet_UploadDataSink_OnRewindSucceeded(Cronet_UploadDataSinkPtr self) {
+  // Bodies are never rewound, requests don't fail while uploading.
+}
+
+} // extern "C"
@@ -0,0 +1,105 @@
+// Copyright (c) 2021, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "file_sink.h"
+#include <errno.h>
+#include <fcntl.h>
+
+#if defined(_WIN32)
+#include <io.h>
+#include <share.h>
+#include <sys/stat.h>
+#else
+#include <unistd.h>
+#endif
+
+#if defined(_WIN32)
+// Windows has no pwrite. The descriptor is private to the sink, so seeking it
+// before every write is equivalent.
+static int OpenForWriting(const char *path) {
+  int fd = -1;
+  _sopen_s(&fd, path, _O_WRONLY | _O_CREAT | _O_BINARY, _SH_DENYNO,
+           _S_IREAD | _S_IWRITE);
+  return fd;
+}
+
+static int64_t WriteAt(int fd, const uint8_t *data, size_t length,
+                       int64_t offset) {
+  if (_lseeki64(fd, offset, SEEK_SET) < 0) {
+    return -1;
+  }
+  unsigned int chunk = length > 0x40000000 ? 0x40000000
+                                           : static_cast<unsigned int>(length);
+  return _write(fd, data, chunk);
+}
+
+static void CloseFile(int fd) { _close(fd); }
+#else
+static int OpenForWriting(const char *path) {
+  return open(path, O_WRONLY | O_CREAT | O_CLOEXEC, 0644);
+}
+
+static int64_t WriteAt(int fd, const uint8_t *data, size_t length,
+                       int64_t offset) {
+  return pwrite(fd, data, length, static_cast<off_t>(offset));
+}
+
+static void CloseFile(int fd) { close(fd); }
+#endif
+
+FileSink::~FileSink() {
+  if (fd_ >= 0) {
+    CloseFile(fd_);
+  }
+}
+
+bool FileSink::Write(const uint8_t *data, size_t length) {
+  if (fd_ < 0) {
+    fd_ = OpenForWriting(path_);
+    if (fd_ < 0) {
+      error_ = errno;
+      return false;
+    }
+  }
+  while (length > 0) {
+    int64_t n = WriteAt(fd_, data, length, offset_ + written_);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      error_ = errno;
+      return false;
+    }
+    data += n;
+    length -= static_cast<size_t>(n);
+    written_ += n;
+  }
+  return true;
+}
+
+int FileSink::Preallocate(const char *path, int64_t length) {
+  int fd = OpenForWriting(path);
+  if (fd < 0) {
+    return errno;
+  }
+#if defined(_WIN32)
+  int error = _chsize_s(fd, length);
+#else
+  // Sets the exact size first, the file may be left over from a bigger
+  // object.
+  int error = ftruncate(fd, static_cast<off_t>(length)) == 0 ? 0 : errno;
+#if defined(__linux__)
+  if (error == 0) {
+    // Reserves the blocks, so that running out of space fails here and not
+    // halfway through the download. Not every file system supports it.
+    error = posix_fallocate(fd, 0, static_cast<off_t>(length));
+    if (error == EOPNOTSUPP || error == EINVAL) {
+      error = 0;
+    }
+  }
+#endif
+#endif
+  CloseFile(fd);
+  return error;
+}
@@ -0,0 +1,44 @@
+// Copyright (c) 2021, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef FILE_SINK_H_
+#define FILE_SINK_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Writes a response body into a file, starting at a fixed offset.
+//
+// Writes are positioned, so that the ranges of an object can be written into
+// the same file by concurrent requests, each through its own sink. The file
+// is opened, and created if needed, on the first write.
+class FileSink {
+public:
+  FileSink(const char *path, int64_t offset) : path_(path), offset_(offset) {}
+  ~FileSink();
+  FileSink(const FileSink &) = delete;
+  FileSink &operator=(const FileSink &) = delete;
+
+  // Writes |length| bytes of |data| after the bytes written so far. Returns
+  // false on failure, see error().
+  bool Write(const uint8_t *data, size_t length);
+
+  // Bytes written so far.
+  int64_t written() const { return written_; }
+  // errno of the last failure.
+  int error() const { return error_; }
+
+  // Reserves |length| bytes of disk space for the file at |path|, creating it
+  // if needed. Returns 0 or an errno value.
+  static int Preallocate(const char *path, int64_t length);
+
+private:
+  const char *path_;
+  int64_t offset_;
+  int64_t written_ = 0;
+  int fd_ = -1;
+  int error_ = 0;
+};
+
+#endif // FILE_SINK_H_
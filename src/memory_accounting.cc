@@ -0,0 +1,82 @@
+// Copyright (c) 2021, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "memory_accounting.h"
+
+#include <atomic>
+
+namespace {
+
+struct Counters {
+  std::atomic<int64_t> live_bytes{0};
+  std::atomic<int64_t> peak_bytes{0};
+  std::atomic<int64_t> live_objects{0};
+  std::atomic<int64_t> peak_objects{0};
+};
+
+} // namespace
+
+static Counters categories[MEMORY_CATEGORY_COUNT];
+static std::atomic<int64_t> totalLive{0};
+static std::atomic<int64_t> totalPeak{0};
+
+static std::atomic<int64_t> alertThreshold{0};
+static std::atomic<Dart_Port> alertPort{ILLEGAL_PORT};
+// Whether the alert is posted once the threshold is reached.
+static std::atomic<bool> alertArmed{false};
+
+static void RaisePeak(std::atomic<int64_t> &peak, int64_t value) {
+  int64_t current = peak.load(std::memory_order_relaxed);
+  while (value > current &&
+         !peak.compare_exchange_weak(current, value,
+                                     std::memory_order_relaxed)) {
+  }
+}
+
+void MemoryAccounting::Allocated(MemoryCategory category, int64_t bytes) {
+  Counters &counters = categories[category];
+  RaisePeak(counters.peak_bytes,
+            counters.live_bytes.fetch_add(bytes, std::memory_order_relaxed) +
+                bytes);
+  RaisePeak(counters.peak_objects,
+            counters.live_objects.fetch_add(1, std::memory_order_relaxed) + 1);
+  int64_t total = totalLive.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+  RaisePeak(totalPeak, total);
+  int64_t threshold = alertThreshold.load(std::memory_order_relaxed);
+  if (threshold > 0 && total >= threshold &&
+      alertArmed.load(std::memory_order_relaxed) &&
+      alertArmed.exchange(false)) {
+    Dart_PostInteger_DL(alertPort.load(), total);
+  }
+}
+
+void MemoryAccounting::Freed(MemoryCategory category, int64_t bytes) {
+  Counters &counters = categories[category];
+  counters.live_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+  counters.live_objects.fetch_sub(1, std::memory_order_relaxed);
+  int64_t total = totalLive.fetch_sub(bytes, std::memory_order_relaxed) - bytes;
+  int64_t threshold = alertThreshold.load(std::memory_order_relaxed);
+  if (threshold > 0 && total < threshold - threshold / 4 &&
+      !alertArmed.load(std::memory_order_relaxed)) {
+    alertArmed.store(true);
+  }
+}
+
+void MemoryAccounting::Read(int64_t *stats) {
+  for (int i = 0; i < MEMORY_CATEGORY_COUNT; i++) {
+    stats[4 * i] = categories[i].live_bytes.load();
+    stats[4 * i + 1] = categories[i].peak_bytes.load();
+    stats[4 * i + 2] = categories[i].live_objects.load();
+    stats[4 * i + 3] = categories[i].peak_objects.load();
+  }
+  stats[4 * MEMORY_CATEGORY_COUNT] = totalLive.load();
+  stats[4 * MEMORY_CATEGORY_COUNT + 1] = totalPeak.load();
+}
+
+void MemoryAccounting::SetAlert(int64_t threshold, Dart_Port port) {
+  alertThreshold.store(0);
+  alertPort.store(port);
+  alertArmed.store(threshold > 0);
+  alertThreshold.store(threshold);
+}
@@ -0,0 +1,49 @@
+// Copyright (c) 2021, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef MEMORY_ACCOUNTING_H_
+#define MEMORY_ACCOUNTING_H_
+
+#include "../third_party/dart-sdk/dart_api_dl.h"
+
+#include <stdint.h>
+
+// What the native memory held by the wrapper is used for.
+enum MemoryCategory : int {
+  // Response buffers handed to Cronet.
+  MEMORY_CRONET_BUFFERS,
+  // Arguments of callbacks, until the Dart side collects them.
+  MEMORY_CALLBACK_ARGS,
+  // Strings copied for the Dart side: status texts, error messages,
+  // validators and URLs.
+  MEMORY_STRINGS,
+  MEMORY_UPLOAD_PROVIDERS,
+  // SampleExecutors, each of which runs a thread.
+  MEMORY_EXECUTORS,
+  // Entries of requestNativePorts.
+  MEMORY_REQUEST_PORTS,
+  MEMORY_CATEGORY_COUNT,
+};
+
+// Live and peak bytes and objects of each category, kept with atomic
+// counters so that any thread can account for what it allocates.
+class MemoryAccounting {
+public:
+  static void Allocated(MemoryCategory category, int64_t bytes);
+  static void Freed(MemoryCategory category, int64_t bytes);
+
+  // Writes the live bytes, peak bytes, live objects and peak objects of each
+  // category in turn to |stats|, followed by the live and peak bytes of all
+  // of them together. That's kStatsLength values.
+  static void Read(int64_t *stats);
+
+  // Posts the live bytes to |port| once they reach |threshold| bytes, and
+  // again after they went back below three quarters of it. A |threshold| of
+  // 0 turns the alert off.
+  static void SetAlert(int64_t threshold, Dart_Port port);
+
+  static const int kStatsLength = 4 * MEMORY_CATEGORY_COUNT + 2;
+};
+
+#endif // MEMORY_ACCOUNTING_H_
@@ -0,0 +1,220 @@
+// Copyright (c) 2021, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "multipart_source.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#if defined(_WIN32)
+#include <io.h>
+#include <share.h>
+#else
+#include <unistd.h>
+#endif
+
+#if defined(_WIN32)
+static int OpenForReading(const char *path) {
+  int fd = -1;
+  _sopen_s(&fd, path, _O_RDONLY | _O_BINARY, _SH_DENYNO, 0);
+  return fd;
+}
+
+static int64_t ReadAt(int fd, uint8_t *out, size_t length, int64_t offset) {
+  if (_lseeki64(fd, offset, SEEK_SET) < 0) {
+    return -1;
+  }
+  unsigned int chunk = length > 0x40000000 ? 0x40000000
+                                           : static_cast<unsigned int>(length);
+  return _read(fd, out, chunk);
+}
+
+static int FileSize(const char *path, int64_t *size) {
+  struct _stat64 info;
+  if (_stat64(path, &info) != 0) {
+    return errno;
+  }
+  *size = info.st_size;
+  return 0;
+}
+
+static void CloseFile(int fd) { _close(fd); }
+#else
+static int OpenForReading(const char *path) {
+  return open(path, O_RDONLY | O_CLOEXEC);
+}
+
+static int64_t ReadAt(int fd, uint8_t *out, size_t length, int64_t offset) {
+  return pread(fd, out, length, static_cast<off_t>(offset));
+}
+
+static int FileSize(const char *path, int64_t *size) {
+  struct stat info;
+  if (stat(path, &info) != 0) {
+    return errno;
+  }
+  *size = static_cast<int64_t>(info.st_size);
+  return 0;
+}
+
+static void CloseFile(int fd) { close(fd); }
+#endif
+
+// Quotes a name or file name of a part the way browsers do.
+static void AppendQuoted(std::string &out, const char *value) {
+  out += '"';
+  for (const char *c = value; *c != '\0'; c++) {
+    switch (*c) {
+    case '"':
+      out += "%22";
+      break;
+    case '\r':
+      out += "%0D";
+      break;
+    case '\n':
+      out += "%0A";
+      break;
+    default:
+      out += *c;
+    }
+  }
+  out += '"';
+}
+
+MultipartSource *MultipartSource::Create(const MultipartPart *parts,
+                                         int32_t count, const char *boundary,
+                                         int *error) {
+  MultipartSource *source = new MultipartSource();
+  std::string delimiter = std::string("--") + boundary;
+  for (int32_t i = 0; i < count; i++) {
+    const MultipartPart &part = parts[i];
+    std::string header = delimiter;
+    header += "\r\nContent-Disposition: form-data; name=";
+    AppendQuoted(header, part.name);
+    if (part.filename != nullptr) {
+      header += "; filename=";
+      AppendQuoted(header, part.filename);
+    }
+    header += "\r\n";
+    if (part.content_type != nullptr) {
+      // Would end the header early.
+      if (strpbrk(part.content_type, "\r\n") != nullptr) {
+        *error = EINVAL;
+        delete source;
+        return nullptr;
+      }
+      header += "Content-Type: ";
+      header += part.content_type;
+      header += "\r\n";
+    }
+    header += "\r\n";
+    source->Append(header);
+    if (part.path == nullptr) {
+      source->Append(std::string(reinterpret_cast<const char *>(part.data),
+                                 static_cast<size_t>(part.length)));
+    } else {
+      int64_t length = part.length;
+      if (length < 0) {
+        int64_t size = 0;
+        *error = FileSize(part.path, &size);
+        if (*error == 0 && size < part.offset) {
+          *error = EINVAL;
+        }
+        if (*error != 0) {
+          delete source;
+          return nullptr;
+        }
+        length = size - part.offset;
+      }
+      source->segments_.push_back({std::string(), part.path, part.offset,
+                                   length});
+      source->length_ += length;
+    }
+    source->Append("\r\n");
+  }
+  source->Append(delimiter + "--\r\n");
+  return source;
+}
+
+MultipartSource::~MultipartSource() {
+  if (fd_ >= 0) {
+    CloseFile(fd_);
+  }
+}
+
+// In memory runs are merged, a body without files is a single segment.
+void MultipartSource::Append(const std::string &bytes) {
+  if (segments_.empty() || !segments_.back().path.empty()) {
+    segments_.push_back({std::string(), std::string(), 0, 0});
+  }
+  Segment &segment = segments_.back();
+  segment.bytes += bytes;
+  segment.length += static_cast<int64_t>(bytes.size());
+  length_ += static_cast<int64_t>(bytes.size());
+}
+
+void MultipartSource::NextSegment() {
+  if (fd_ >= 0) {
+    CloseFile(fd_);
+    fd_ = -1;
+  }
+  segment_++;
+  position_ = 0;
+}
+
+int64_t MultipartSource::Read(uint8_t *out, size_t capacity, bool *done) {
+  size_t written = 0;
+  while (written < capacity && segment_ < segments_.size()) {
+    const Segment &segment = segments_[segment_];
+    int64_t left = segment.length - position_;
+    size_t chunk = capacity - written;
+    if (static_cast<int64_t>(chunk) > left) {
+      chunk = static_cast<size_t>(left);
+    }
+    if (segment.path.empty()) {
+      memcpy(out + written, segment.bytes.data() + position_, chunk);
+    } else if (chunk > 0) {
+      if (fd_ < 0) {
+        fd_ = OpenForReading(segment.path.c_str());
+        if (fd_ < 0) {
+          error_ = "Opening a file part failed";
+          return -1;
+        }
+      }
+      int64_t n =
+          ReadAt(fd_, out + written, chunk, segment.offset + position_);
+      if (n < 0 && errno == EINTR) {
+        continue;
+      }
+      if (n < 0) {
+        error_ = "Reading a file part failed";
+        return -1;
+      }
+      if (n == 0) {
+        // The length was announced with the headers already.
+        error_ = "A file part got shorter while being uploaded";
+        return -1;
+      }
+      chunk = static_cast<size_t>(n);
+    }
+    written += chunk;
+    position_ += static_cast<int64_t>(chunk);
+    if (position_ == segment.length) {
+      NextSegment();
+    }
+  }
+  *done = segment_ == segments_.size();
+  return static_cast<int64_t>(written);
+}
+
+void MultipartSource::Rewind() {
+  if (fd_ >= 0) {
+    CloseFile(fd_);
+    fd_ = -1;
+  }
+  segment_ = 0;
+  position_ = 0;
+  error_ = nullptr;
+}
@@ -0,0 +1,56 @@
+// Copyright (c) 2021, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef MULTIPART_SOURCE_H_
+#define MULTIPART_SOURCE_H_
+
+#include "upload_source.h"
+#include "wrapper.h"
+#include <string>
+#include <vector>
+
+// Produces a multipart/form-data body. Boundaries and part headers are
+// generated up front, file parts are read as they are uploaded, so that
+// memory use doesn't depend on the size of the files.
+class MultipartSource : public UploadSource {
+public:
+  // Body made of the |count| |parts| separated by |boundary|. Null if the
+  // length of a file part can't be determined or a content type holds a line
+  // break, |error| is then set to an errno value.
+  static MultipartSource *Create(const MultipartPart *parts, int32_t count,
+                                 const char *boundary, int *error);
+
+  ~MultipartSource() override;
+
+  int64_t length() const override { return length_; }
+  int64_t Read(uint8_t *out, size_t capacity, bool *done) override;
+  void Rewind() override;
+  const char *error() const override { return error_; }
+
+private:
+  // A run of the body: |bytes| if |path| is empty, otherwise |length| bytes
+  // of the file at |path| from |offset|.
+  struct Segment {
+    std::string bytes;
+    std::string path;
+    int64_t offset;
+    int64_t length;
+  };
+
+  MultipartSource() = default;
+  void Append(const std::string &bytes);
+  void NextSegment();
+
+  std::vector<Segment> segments_;
+  int64_t length_ = 0;
+  // Segment being read and the position in it.
+  size_t segment_ = 0;
+  int64_t position_ = 0;
+  // Descriptor of the file of the segment being read, opened on its first
+  // read.
+  int fd_ = -1;
+  const char *error_ = nullptr;
+};
+
+#endif // MULTIPART_SOURCE_H_
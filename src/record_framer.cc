@@ -0,0 +1,290 @@
+// Copyright (c) 2021, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "record_framer.h"
+#include <stdlib.h>
+#include <string.h>
+
+// The scans below use SSE2, always there on x86-64, or NEON on arm64. With
+// GCC and Clang on x86, AVX2 versions are also compiled, whatever the flags
+// of the build, and used if the CPU supports AVX2.
+#if defined(__SSE2__) || defined(_M_X64) ||                                    \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FRAMER_SSE2
+#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define FRAMER_NEON
+#include <arm_neon.h>
+#endif
+#if defined(FRAMER_SSE2) && (defined(__GNUC__) || defined(__clang__))
+#define FRAMER_AVX2
+#include <immintrin.h>
+#endif
+#if defined(_MSC_VER) && defined(FRAMER_SSE2)
+#include <intrin.h>
+#endif
+
+// Records can't grow past this while waiting for their terminator.
+static const size_t kMaxRecordLength = 8 * 1024 * 1024;
+
+#if defined(FRAMER_SSE2)
+static inline size_t CountTrailingZeros(uint32_t mask) {
+#if defined(_MSC_VER)
+  unsigned long index;
+  _BitScanForward(&index, mask);
+  return index;
+#else
+  return __builtin_ctz(mask);
+#endif
+}
+#endif
+
+#if defined(FRAMER_AVX2)
+static bool DetectAvx2() {
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("avx2");
+}
+
+// Picked once when the library is loaded.
+static const bool hasAvx2 = DetectAvx2();
+
+// Offset of the first '\n' in the whole 32 byte blocks of |data|, or of the
+// first byte after them if there is none.
+__attribute__((target("avx2"))) static size_t
+FindNewlineAvx2(const uint8_t *data, size_t length) {
+  const __m256i newline32 = _mm256_set1_epi8('\n');
+  size_t i = 0;
+  for (; i + 32 <= length; i += 32) {
+    __m256i chunk =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+    uint32_t mask = static_cast<uint32_t>(
+        _mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, newline32)));
+    if (mask != 0) {
+      return i + __builtin_ctz(mask);
+    }
+  }
+  return i;
+}
+
+// Number of ASCII bytes the whole 32 byte blocks of |data| start with.
+__attribute__((target("avx2"))) static size_t
+CountAsciiAvx2(const uint8_t *data, size_t length) {
+  size_t i = 0;
+  for (; i + 32 <= length; i += 32) {
+    uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i))));
+    if (mask != 0) {
+      return i + __builtin_ctz(mask);
+    }
+  }
+  return i;
+}
+#endif
+
+// Offset of the first '\n' in |data|, or |length| if there is none.
+static size_t FindNewline(const uint8_t *data, size_t length) {
+  size_t i = 0;
+#if defined(FRAMER_AVX2)
+  if (hasAvx2) {
+    i = FindNewlineAvx2(data, length);
+    if (i < length && data[i] == '\n') {
+      return i;
+    }
+  }
+#endif
+#if defined(FRAMER_SSE2)
+  const __m128i newline16 = _mm_set1_epi8('\n');
+  for (; i + 16 <= length; i += 16) {
+    __m128i chunk =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+    uint32_t mask = static_cast<uint32_t>(
+        _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, newline16)));
+    if (mask != 0) {
+      return i + CountTrailingZeros(mask);
+    }
+  }
+#elif defined(FRAMER_NEON)
+  const uint8x16_t newline16 = vdupq_n_u8('\n');
+  for (; i + 16 <= length; i += 16) {
+    if (vmaxvq_u8(vceqq_u8(vld1q_u8(data + i), newline16)) != 0) {
+      break;
+    }
+  }
+#endif
+  for (; i < length; i++) {
+    if (data[i] == '\n') {
+      return i;
+    }
+  }
+  return length;
+}
+
+// Number of ASCII bytes |data| starts with.
+static size_t CountAscii(const uint8_t *data, size_t length) {
+  size_t i = 0;
+#if defined(FRAMER_AVX2)
+  if (hasAvx2) {
+    i = CountAsciiAvx2(data, length);
+    if (i < length && data[i] >= 0x80) {
+      return i;
+    }
+  }
+#endif
+#if defined(FRAMER_SSE2)
+  for (; i + 16 <= length; i += 16) {
+    uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i))));
+    if (mask != 0) {
+      return i + CountTrailingZeros(mask);
+    }
+  }
+#elif defined(FRAMER_NEON)
+  for (; i + 16 <= length; i += 16) {
+    if (vmaxvq_u8(vld1q_u8(data + i)) >= 0x80) {
+      break;
+    }
+  }
+#endif
+  while (i < length && data[i] < 0x80) {
+    i++;
+  }
+  return i;
+}
+
+static bool IsValidUtf8(const uint8_t *data, size_t length) {
+  size_t i = 0;
+  while (true) {
+    i += CountAscii(data + i, length - i);
+    if (i == length) {
+      return true;
+    }
+    uint8_t lead = data[i];
+    size_t continuations;
+    uint32_t code_point, min;
+    if ((lead & 0xE0) == 0xC0) {
+      continuations = 1;
+      code_point = lead & 0x1F;
+      min = 0x80;
+    } else if ((lead & 0xF0) == 0xE0) {
+      continuations = 2;
+      code_point = lead & 0x0F;
+      min = 0x800;
+    } else if ((lead & 0xF8) == 0xF0) {
+      continuations = 3;
+      code_point = lead & 0x07;
+      min = 0x10000;
+    } else {
+      return false;
+    }
+    if (length - i <= continuations) {
+      return false;
+    }
+    for (size_t j = 1; j <= continuations; j++) {
+      uint8_t byte = data[i + j];
+      if ((byte & 0xC0) != 0x80) {
+        return false;
+      }
+      code_point = (code_point << 6) | (byte & 0x3F);
+    }
+    // Overlong encodings, surrogates and out of range code points.
+    if (code_point < min || code_point > 0x10FFFF ||
+        (code_point >= 0xD800 && code_point <= 0xDFFF)) {
+      return false;
+    }
+    i += continuations + 1;
+  }
+}
+
+RecordFramer::Error RecordFramer::Feed(const uint8_t *data, size_t length) {
+  // Start of the current record in |data|. Whatever is in |partial_| comes
+  // before it.
+  size_t record_start = 0;
+  size_t line_start = 0;
+  while (line_start < length) {
+    size_t newline =
+        line_start + FindNewline(data + line_start, length - line_start);
+    if (newline == length) {
+      break;
+    }
+    // Only the first line can have started in a previous call.
+    size_t carried = partial_line_length_;
+    size_t line_length = carried + newline - line_start;
+    uint8_t last = newline > line_start ? data[newline - 1]
+                                        : (carried > 0 ? partial_.back() : 0);
+    if (last == '\r') {
+      line_length--;
+    }
+    partial_line_length_ = 0;
+    if (mode_ == kNdjson) {
+      if (line_length > 0) {
+        Error error = Emit(data + record_start, newline - record_start);
+        if (error != kOk) {
+          return error;
+        }
+      }
+      partial_.clear();
+      record_start = newline + 1;
+    } else if (line_length == 0) {
+      // An empty line ends the event. Its '\r', if any, isn't part of it.
+      partial_.resize(partial_.size() - carried);
+      Error error = Emit(data + record_start, line_start - record_start);
+      if (error != kOk) {
+        return error;
+      }
+      partial_.clear();
+      record_start = newline + 1;
+    }
+    line_start = newline + 1;
+  }
+  partial_line_length_ += length - line_start;
+  partial_.insert(partial_.end(), data + record_start, data + length);
+  return partial_.size() > kMaxRecordLength ? kRecordTooLong : kOk;
+}
+
+RecordFramer::Error RecordFramer::Finish() {
+  Error error = kOk;
+  if (mode_ == kNdjson && !partial_.empty()) {
+    error = Emit(nullptr, 0);
+  }
+  partial_.clear();
+  partial_line_length_ = 0;
+  return error;
+}
+
+// Emits |partial_| followed by |length| bytes of |data| as a record, without
+// its trailing line terminator.
+RecordFramer::Error RecordFramer::Emit(const uint8_t *data, size_t length) {
+  size_t start = records_.size();
+  records_.insert(records_.end(), partial_.begin(), partial_.end());
+  records_.insert(records_.end(), data, data + length);
+  if (records_.size() > start && records_.back() == '\n') {
+    records_.pop_back();
+  }
+  if (records_.size() > start && records_.back() == '\r') {
+    records_.pop_back();
+  }
+  if (records_.size() == start) {
+    // Consecutive empty lines between events.
+    return kOk;
+  }
+  if (!IsValidUtf8(records_.data() + start, records_.size() - start)) {
+    records_.resize(start);
+    return kInvalidUtf8;
+  }
+  ends_.push_back(static_cast<uint32_t>(records_.size()));
+  return kOk;
+}
+
+uint8_t *RecordFramer::TakeRecords(size_t *size) {
+  uint32_t count = static_cast<uint32_t>(ends_.size());
+  size_t header_size = sizeof(uint32_t) * (count + 1);
+  *size = header_size + records_.size();
+  uint8_t *block = static_cast<uint8_t *>(malloc(*size));
+  memcpy(block, &count, sizeof(uint32_t));
+  memcpy(block + sizeof(uint32_t), ends_.data(), sizeof(uint32_t) * count);
+  memcpy(block + header_size, records_.data(), records_.size());
+  records_.clear();
+  ends_.clear();
+  return block;
+}
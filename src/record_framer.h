@@ -0,0 +1,53 @@
+// Copyright (c) 2021, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef RECORD_FRAMER_H_
+#define RECORD_FRAMER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+// Splits a byte stream into records as it arrives.
+//
+// NDJSON records are the non empty lines of the stream. Server-Sent Events
+// records are the events of the stream, i.e. blocks of lines terminated by an
+// empty line. Line terminators are not part of the records. Partial records
+// are carried over to the next call to Feed.
+class RecordFramer {
+public:
+  // Same values as FRAMING_* in wrapper.h.
+  enum Mode { kNdjson = 1, kServerSentEvents = 2 };
+  // Same values as FRAMING_ERROR_* in wrapper.h.
+  enum Error { kOk = 0, kInvalidUtf8 = 1, kRecordTooLong = 2 };
+
+  explicit RecordFramer(int32_t mode) : mode_(mode) {}
+
+  // Frames |length| bytes of |data|.
+  Error Feed(const uint8_t *data, size_t length);
+  // Ends the stream. The last NDJSON line doesn't need a terminator, an
+  // unterminated event is dropped.
+  Error Finish();
+
+  // Whether records have been framed since the last TakeRecords.
+  bool HasRecords() const { return !ends_.empty(); }
+  // Hands over the records framed so far, packed into a single block
+  // allocated with malloc: the number of records as an uint32_t, the end
+  // offset of every record as an uint32_t, then the records back to back.
+  uint8_t *TakeRecords(size_t *size);
+
+private:
+  Error Emit(const uint8_t *data, size_t length);
+
+  int32_t mode_;
+  // Bytes of the current record received by previous calls to Feed.
+  std::vector<uint8_t> partial_;
+  // Length of the current line received by previous calls to Feed.
+  size_t partial_line_length_ = 0;
+  // Records framed since the last TakeRecords.
+  std::vector<uint8_t> records_;
+  std::vector<uint32_t> ends_;
+};
+
+#endif // RECORD_FRAMER_H_
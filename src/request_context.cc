@@ -0,0 +1,877 @@
+// Copyright (c) 2021, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "request_context.h"
+#include "../third_party/cronet_impl/sample_executor.h"
+#include "file_sink.h"
+#include "memory_accounting.h"
+#include "record_framer.h"
+#include "multipart_source.h"
+#include "request_registry.h"
+#include "trace_buffer.h"
+#include "upload_data_provider.h"
+#include "upload_encoder.h"
+#include "wrapper_utils.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Defined in wrapper.cc.
+extern void (*_Cronet_Buffer_InitWithAlloc)(Cronet_BufferPtr self,
+                                            uint64_t size);
+extern Cronet_BufferPtr (*_Cronet_Buffer_Create)(void);
+extern void (*_Cronet_Buffer_Destroy)(Cronet_BufferPtr self);
+extern Cronet_UrlRequestPtr (*_Cronet_UrlRequest_Create)(void);
+extern void (*_Cronet_UrlRequest_Destroy)(Cronet_UrlRequestPtr self);
+extern Cronet_RESULT (*_Cronet_UrlRequest_InitWithParams)(
+    Cronet_UrlRequestPtr self, Cronet_EnginePtr engine, Cronet_String url,
+    Cronet_UrlRequestParamsPtr params, Cronet_UrlRequestCallbackPtr callback,
+    Cronet_ExecutorPtr executor);
+extern Cronet_RESULT (*_Cronet_UrlRequest_Start)(Cronet_UrlRequestPtr self);
+extern Cronet_RESULT (*_Cronet_UrlRequest_Read)(Cronet_UrlRequestPtr self,
+                                                Cronet_BufferPtr buffer);
+extern Cronet_UrlRequestParamsPtr (*_Cronet_UrlRequestParams_Create)(void);
+extern void (*_Cronet_UrlRequestParams_Destroy)(
+    Cronet_UrlRequestParamsPtr self);
+extern void (*_Cronet_UrlRequestParams_http_method_set)(
+    Cronet_UrlRequestParamsPtr self, Cronet_String http_method);
+extern void (*_Cronet_UrlRequestParams_priority_set)(
+    Cronet_UrlRequestParamsPtr self,
+    Cronet_UrlRequestParams_REQUEST_PRIORITY priority);
+extern void (*_Cronet_UrlRequestParams_upload_data_provider_set)(
+    Cronet_UrlRequestParamsPtr self,
+    Cronet_UploadDataProviderPtr upload_data_provider);
+extern Cronet_UrlRequestCallbackPtr (*_Cronet_UrlRequestCallback_CreateWith)(
+    Cronet_UrlRequestCallback_OnRedirectReceivedFunc OnRedirectReceivedFunc,
+    Cronet_UrlRequestCallback_OnResponseStartedFunc OnResponseStartedFunc,
+    Cronet_UrlRequestCallback_OnReadCompletedFunc OnReadCompletedFunc,
+    Cronet_UrlRequestCallback_OnSucceededFunc OnSucceededFunc,
+    Cronet_UrlRequestCallback_OnFailedFunc OnFailedFunc,
+    Cronet_UrlRequestCallback_OnCanceledFunc OnCanceledFunc);
+extern void (*_Cronet_UrlRequestCallback_Destroy)(
+    Cronet_UrlRequestCallbackPtr self);
+extern void (*_Cronet_UrlRequestCallback_SetClientContext)(
+    Cronet_UrlRequestCallbackPtr self, Cronet_ClientContext client_context);
+extern Cronet_ClientContext (*_Cronet_UrlRequestCallback_GetClientContext)(
+    Cronet_UrlRequestCallbackPtr self);
+extern Cronet_UploadDataProviderPtr (*_Cronet_UploadDataProvider_CreateWith)(
+    Cronet_UploadDataProvider_GetLengthFunc GetLengthFunc,
+    Cronet_UploadDataProvider_ReadFunc ReadFunc,
+    Cronet_UploadDataProvider_RewindFunc RewindFunc,
+    Cronet_UploadDataProvider_CloseFunc CloseFunc);
+extern void (*_Cronet_UploadDataProvider_SetClientContext)(
+    Cronet_UploadDataProviderPtr self, Cronet_ClientContext client_context);
+extern void (*_Cronet_UploadDataProvider_Destroy)(
+    Cronet_UploadDataProviderPtr self);
+extern Cronet_RESULT (*_Cronet_UrlRequest_FollowRedirect)(
+    Cronet_UrlRequestPtr self);
+extern void (*_Cronet_UrlRequest_Cancel)(Cronet_UrlRequestPtr self);
+extern void *(*_Cronet_Buffer_GetData)(Cronet_BufferPtr self);
+extern uint32_t (*_Cronet_UrlResponseInfo_all_headers_list_size)(
+    Cronet_UrlResponseInfoPtr self);
+extern Cronet_HttpHeaderPtr (*_Cronet_UrlResponseInfo_all_headers_list_at)(
+    Cronet_UrlResponseInfoPtr self, uint32_t index);
+extern Cronet_String (*_Cronet_HttpHeader_name_get)(Cronet_HttpHeaderPtr self);
+extern Cronet_String (*_Cronet_HttpHeader_value_get)(
+    Cronet_HttpHeaderPtr self);
+extern Cronet_String (*_Cronet_Error_message_get)(const Cronet_ErrorPtr self);
+extern Cronet_Error_ERROR_CODE (*_Cronet_Error_error_code_get)(
+    const Cronet_ErrorPtr self);
+extern int32_t (*_Cronet_Error_internal_error_code_get)(
+    const Cronet_ErrorPtr self);
+extern bool (*_Cronet_Error_immediately_retryable_get)(
+    const Cronet_ErrorPtr self);
+extern int32_t (*_Cronet_Error_quic_detailed_error_code_get)(
+    const Cronet_ErrorPtr self);
+extern void (*_Cronet_UrlRequest_GetStatus)(
+    Cronet_UrlRequestPtr self, Cronet_UrlRequestStatusListenerPtr listener);
+extern Cronet_UrlRequestStatusListenerPtr (
+    *_Cronet_UrlRequestStatusListener_CreateWith)(
+    Cronet_UrlRequestStatusListener_OnStatusFunc OnStatusFunc);
+extern void (*_Cronet_UrlRequestStatusListener_SetClientContext)(
+    Cronet_UrlRequestStatusListenerPtr self,
+    Cronet_ClientContext client_context);
+extern Cronet_ClientContext (
+    *_Cronet_UrlRequestStatusListener_GetClientContext)(
+    Cronet_UrlRequestStatusListenerPtr self);
+extern void (*_Cronet_UrlRequestStatusListener_Destroy)(
+    Cronet_UrlRequestStatusListenerPtr self);
+
+// Size of the buffer the response is read into.
+static const int64_t kResponseBufferSize = 32 * 1024;
+
+// Bodies aren't presized beyond this, whatever Content-Length says.
+static const size_t kMaxPresizedBody = 16 * 1024 * 1024;
+
+// Bytes written to a file between two progress reports.
+static const int64_t kSinkProgressBytes = 1024 * 1024;
+
+// Retries every request may spend, earned back by the requests allowed to
+// retry. Shared by all the engines.
+static const double kMaxRetryBudget = 10;
+static std::mutex retryBudgetLock;
+static double retryBudget = kMaxRetryBudget;
+
+static void DepositRetry(int32_t percent) {
+  std::lock_guard<std::mutex> lock(retryBudgetLock);
+  retryBudget += percent / 100.0;
+  if (retryBudget > kMaxRetryBudget) {
+    retryBudget = kMaxRetryBudget;
+  }
+}
+
+static bool WithdrawRetry() {
+  std::lock_guard<std::mutex> lock(retryBudgetLock);
+  if (retryBudget < 1) {
+    return false;
+  }
+  retryBudget -= 1;
+  return true;
+}
+
+// Errors likely to go away if the request is sent again.
+static bool IsTransient(Cronet_Error_ERROR_CODE code) {
+  switch (code) {
+  case Cronet_Error_ERROR_CODE_ERROR_NETWORK_CHANGED:
+  case Cronet_Error_ERROR_CODE_ERROR_TIMED_OUT:
+  case Cronet_Error_ERROR_CODE_ERROR_CONNECTION_CLOSED:
+  case Cronet_Error_ERROR_CODE_ERROR_CONNECTION_TIMED_OUT:
+  case Cronet_Error_ERROR_CODE_ERROR_CONNECTION_REFUSED:
+  case Cronet_Error_ERROR_CODE_ERROR_CONNECTION_RESET:
+  case Cronet_Error_ERROR_CODE_ERROR_QUIC_PROTOCOL_FAILED:
+    return true;
+  default:
+    return false;
+  }
+}
+
+// ASCII case insensitive comparison of the first |len| characters.
+static bool EqualsIgnoreCase(const char *a, const char *b, size_t len) {
+  for (size_t i = 0; i < len; i++) {
+    char ca = a[i] >= 'A' && a[i] <= 'Z' ? a[i] - 'A' + 'a' : a[i];
+    char cb = b[i] >= 'A' && b[i] <= 'Z' ? b[i] - 'A' + 'a' : b[i];
+    if (ca != cb) {
+      return false;
+    }
+    if (ca == '\0') {
+      break;
+    }
+  }
+  return true;
+}
+
+// Value of the first response header named |name|, or null.
+static Cronet_String FindHeader(Cronet_UrlResponseInfoPtr info,
+                                const char *name) {
+  size_t len = strlen(name) + 1;
+  uint32_t num_headers = _Cronet_UrlResponseInfo_all_headers_list_size(info);
+  for (uint32_t i = 0; i < num_headers; i++) {
+    Cronet_HttpHeaderPtr header =
+        _Cronet_UrlResponseInfo_all_headers_list_at(info, i);
+    if (EqualsIgnoreCase(_Cronet_HttpHeader_name_get(header), name, len)) {
+      return _Cronet_HttpHeader_value_get(header);
+    }
+  }
+  return nullptr;
+}
+
+// Length of the scheme://authority part of |url|.
+static size_t OriginLength(const char *url) {
+  const char *authority = strstr(url, "://");
+  if (authority == nullptr) {
+    return strlen(url);
+  }
+  authority += 3;
+  return authority + strcspn(authority, "/?#") - url;
+}
+
+static bool IsSameOrigin(const char *a, const char *b) {
+  size_t len = OriginLength(a);
+  return len == OriginLength(b) && EqualsIgnoreCase(a, b, len);
+}
+
+static bool HasScheme(const char *url, const char *scheme) {
+  size_t len = strlen(scheme);
+  return EqualsIgnoreCase(url, scheme, len) && url[len] == ':';
+}
+
+/* Arena */
+
+Arena::~Arena() {
+  for (size_t i = 0; i < blocks_.size(); i++) {
+    free(blocks_[i]);
+  }
+}
+
+void *Arena::Allocate(size_t size) {
+  const size_t alignment = alignof(std::max_align_t);
+  size = (size + alignment - 1) & ~(alignment - 1);
+  // Big allocations get a block of their own, so that the free space of the
+  // current block isn't wasted.
+  if (size > kBlockSize / 4) {
+    char *block = static_cast<char *>(malloc(size));
+    blocks_.push_back(block);
+    return block;
+  }
+  if (size > remaining_) {
+    cursor_ = static_cast<char *>(malloc(kBlockSize));
+    blocks_.push_back(cursor_);
+    remaining_ = kBlockSize;
+  }
+  void *result = cursor_;
+  cursor_ += size;
+  remaining_ -= size;
+  return result;
+}
+
+char *Arena::CopyString(const char *str) {
+  size_t len = strlen(str);
+  char *copy = static_cast<char *>(Allocate(len + 1));
+  memcpy(copy, str, len + 1);
+  return copy;
+}
+
+/* Request Context */
+
+RequestContext::RequestContext(Dart_Port port)
+    : port_(port), random_(static_cast<uint32_t>(
+                       reinterpret_cast<uintptr_t>(this) >> 4)) {}
+
+RequestContext::~RequestContext() {
+  // First of all, so that neither a timer nor the watchdog looks at the
+  // request while it goes away.
+  RequestRegistry::Remove(this);
+  CancelTimers();
+  if (request_ != nullptr) {
+    RemoveRequest(request_);
+    _Cronet_UrlRequest_Destroy(request_);
+  }
+  for (Cronet_UrlRequestPtr failed : failed_requests_) {
+    _Cronet_UrlRequest_Destroy(failed);
+  }
+  if (executor_ != nullptr) {
+    // Joins the executor thread, before anything a task still running on it
+    // may use is released. Queued tasks are dropped.
+    delete executor_;
+    MemoryAccounting::Freed(MEMORY_EXECUTORS, sizeof(SampleExecutor));
+  }
+  if (params_ != nullptr) {
+    _Cronet_UrlRequestParams_Destroy(params_);
+  }
+  if (callback_ != nullptr) {
+    _Cronet_UrlRequestCallback_Destroy(callback_);
+  }
+  if (cronet_upload_provider_ != nullptr) {
+    _Cronet_UploadDataProvider_Destroy(cronet_upload_provider_);
+  }
+  delete upload_provider_;
+  free(body_);
+  delete framer_;
+  delete sink_;
+  if (buffer_ != nullptr) {
+    // Otherwise Cronet destroys it along with the request.
+    if (buffer_held_.load()) {
+      _Cronet_Buffer_Destroy(buffer_);
+    }
+    MemoryAccounting::Freed(MEMORY_CRONET_BUFFERS, kResponseBufferSize);
+  }
+  // Last, Cronet doesn't report the load state of a request once it is
+  // destroyed and its executor is gone.
+  if (progress_listener_ != nullptr) {
+    _Cronet_UrlRequestStatusListener_Destroy(progress_listener_);
+  }
+  if (status_listener_ != nullptr) {
+    _Cronet_UrlRequestStatusListener_Destroy(status_listener_);
+  }
+}
+
+Cronet_RESULT RequestContext::Start(Cronet_EnginePtr engine,
+                                    const RequestDescriptor &descriptor) {
+  engine_ = engine;
+  url_ = arena_.CopyString(descriptor.url);
+  started_ = std::chrono::steady_clock::now();
+  TRACE_EVENT(TRACE_CREATED, port_, 0);
+  RequestRegistry::Add(this);
+  max_redirects_ = descriptor.max_redirects;
+  redirect_flags_ = descriptor.redirect_flags;
+  aggregate_body_ = descriptor.aggregate_body != 0;
+  if (descriptor.sink_path != nullptr) {
+    sink_ = new FileSink(arena_.CopyString(descriptor.sink_path),
+                         descriptor.sink_offset);
+    sink_length_ = descriptor.sink_length;
+  } else if (!aggregate_body_ && descriptor.framing != FRAMING_NONE) {
+    framer_ = new RecordFramer(descriptor.framing);
+  }
+  const char *header = descriptor.headers;
+  for (int32_t i = 0; i < descriptor.num_headers; i++) {
+    const char *value = header + strlen(header) + 1;
+    if (EqualsIgnoreCase(header, "authorization", 14) ||
+        EqualsIgnoreCase(header, "cookie", 7)) {
+      has_credentials_ = true;
+    }
+    header = value + strlen(value) + 1;
+  }
+
+  executor_ = new SampleExecutor();
+  MemoryAccounting::Allocated(MEMORY_EXECUTORS, sizeof(SampleExecutor));
+  executor_->Init();
+  callback_ = _Cronet_UrlRequestCallback_CreateWith(
+      OnRedirectReceived, OnResponseStarted, OnReadCompleted, OnSucceeded,
+      OnFailed, OnCanceled);
+  _Cronet_UrlRequestCallback_SetClientContext(callback_, this);
+
+  params_ = _Cronet_UrlRequestParams_Create();
+  _Cronet_UrlRequestParams_http_method_set(params_, descriptor.method);
+  UrlRequestParamsAddHeaders(params_, descriptor.headers,
+                             descriptor.num_headers);
+  _Cronet_UrlRequestParams_priority_set(
+      params_, static_cast<Cronet_UrlRequestParams_REQUEST_PRIORITY>(
+                   descriptor.priority));
+  if (descriptor.upload_length > 0 || descriptor.num_multipart_parts > 0) {
+    // Data upload provider with registered callbacks (from cronet side).
+    cronet_upload_provider_ = _Cronet_UploadDataProvider_CreateWith(
+        UploadDataProvider_GetLength, UploadDataProvider_Read,
+        UploadDataProvider_Rewind, UploadDataProvider_CloseFunc);
+    // Data upload provider implementation (wrapper).
+    upload_provider_ = new UploadDataProvider();
+    upload_length_ = descriptor.upload_length;
+    _Cronet_UploadDataProvider_SetClientContext(cronet_upload_provider_,
+                                                upload_provider_);
+    _Cronet_UrlRequestParams_upload_data_provider_set(params_,
+                                                      cronet_upload_provider_);
+    if (descriptor.num_multipart_parts > 0) {
+      int error = 0;
+      MultipartSource *source = MultipartSource::Create(
+          descriptor.multipart_parts, descriptor.num_multipart_parts,
+          descriptor.multipart_boundary, &error);
+      if (source == nullptr) {
+        return Cronet_RESULT_ILLEGAL_ARGUMENT;
+      }
+      upload_provider_->SetSource(source);
+    } else if (descriptor.upload_compression != COMPRESSION_NONE) {
+      UploadEncoder *encoder = UploadEncoder::Create(
+          descriptor.upload_compression, descriptor.upload_data,
+          static_cast<size_t>(descriptor.upload_length));
+      if (encoder == nullptr) {
+        return Cronet_RESULT_ILLEGAL_ARGUMENT;
+      }
+      upload_provider_->SetSource(encoder);
+    }
+  }
+
+  // The body is read from the Dart side, which can't replay it.
+  if (descriptor.max_attempts > 1 && upload_provider_ == nullptr) {
+    max_attempts_ = descriptor.max_attempts;
+    retry_backoff_ms_ = descriptor.retry_backoff_ms;
+    retry_max_backoff_ms_ = descriptor.retry_max_backoff_ms;
+    retry_timer_.callback = OnRetry;
+    retry_timer_.data = this;
+    DepositRetry(descriptor.retry_budget_percent);
+  }
+  if (descriptor.progress_interval_ms > 0) {
+    progress_interval_ms_ = descriptor.progress_interval_ms;
+    progress_timer_.callback = OnProgressTick;
+    progress_timer_.data = this;
+  }
+  if (descriptor.connect_timeout_ms > 0 || descriptor.read_timeout_ms > 0 ||
+      descriptor.total_timeout_ms > 0 || max_attempts_ > 1 ||
+      progress_interval_ms_ > 0) {
+    wheel_ = TimerWheel::ForEngine(engine);
+    Timer *timers[] = {&connect_timer_, &read_timer_, &total_timer_};
+    int32_t tags[] = {TIMEOUT_CONNECT, TIMEOUT_READ, TIMEOUT_TOTAL};
+    for (int i = 0; i < 3; i++) {
+      timers[i]->callback = OnTimeout;
+      timers[i]->data = this;
+      timers[i]->tag = tags[i];
+    }
+    connect_timeout_ms_ = descriptor.connect_timeout_ms;
+    read_timeout_ms_ = descriptor.read_timeout_ms;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  Cronet_RESULT res = StartAttempt();
+  if (res == Cronet_RESULT_SUCCESS && descriptor.total_timeout_ms > 0) {
+    // Covers every attempt.
+    wheel_->Schedule(&total_timer_, descriptor.total_timeout_ms);
+  }
+  if (res == Cronet_RESULT_SUCCESS && progress_interval_ms_ > 0) {
+    wheel_->Schedule(&progress_timer_, progress_interval_ms_);
+  }
+  return res;
+}
+
+Cronet_RESULT RequestContext::StartAttempt() {
+  attempts_++;
+  request_ = _Cronet_UrlRequest_Create();
+  // Port has to be known before the request is started, as callbacks may
+  // arrive before this function returns.
+  RegisterCallbackHandler(port_, request_);
+  if (upload_provider_ != nullptr) {
+    upload_provider_->Init(upload_length_, request_);
+  }
+  Cronet_RESULT res = _Cronet_UrlRequest_InitWithParams(
+      request_, engine_, url_, params_, callback_, executor_->GetExecutor());
+  if (res != Cronet_RESULT_SUCCESS) {
+    return res;
+  }
+  // Armed before starting, callbacks may arrive before Start returns.
+  if (connect_timeout_ms_ > 0) {
+    wheel_->Schedule(&connect_timer_, connect_timeout_ms_);
+  }
+  TRACE_EVENT(TRACE_STARTED, port_, attempts_);
+  return _Cronet_UrlRequest_Start(request_);
+}
+
+Cronet_BufferPtr RequestContext::CreateResponseBuffer() {
+  buffer_ = _Cronet_Buffer_Create();
+  _Cronet_Buffer_InitWithAlloc(buffer_, kResponseBufferSize);
+  MemoryAccounting::Allocated(MEMORY_CRONET_BUFFERS, kResponseBufferSize);
+  buffer_held_.store(true);
+  return buffer_;
+}
+
+void RequestContext::OnBufferReturned() {
+  buffer_held_.store(true);
+  if (read_timeout_ms_ > 0) {
+    wheel_->Cancel(&read_timer_);
+  }
+}
+
+Cronet_RESULT RequestContext::Read() {
+  // Only the time Cronet spends on a read counts, not the time the Dart side
+  // takes to ask for the next one.
+  if (read_timeout_ms_ > 0) {
+    wheel_->Schedule(&read_timer_, read_timeout_ms_);
+  }
+  buffer_held_.store(false);
+  Cronet_RESULT res = _Cronet_UrlRequest_Read(request_, buffer_);
+  if (res != Cronet_RESULT_SUCCESS) {
+    // Cronet didn't take the buffer.
+    buffer_held_.store(true);
+    if (read_timeout_ms_ > 0) {
+      wheel_->Cancel(&read_timer_);
+    }
+  }
+  return res;
+}
+
+bool RequestContext::StartAggregating(Cronet_UrlResponseInfoPtr info) {
+  Cronet_String content_length = FindHeader(info, "content-length");
+  if (content_length != nullptr) {
+    // Content-Length is the encoded size, the body still grows if it turns
+    // out to be bigger once decoded.
+    unsigned long long length = strtoull(content_length, nullptr, 10);
+    body_capacity_ = static_cast<size_t>(
+        length < kMaxPresizedBody ? length : kMaxPresizedBody);
+  }
+  if (body_capacity_ > 0) {
+    body_ = static_cast<uint8_t *>(malloc(body_capacity_));
+    if (body_ == nullptr) {
+      DispatchCallback("OnBodyError", request_,
+                       CallbackArgBuilder(1, body_capacity_));
+      body_capacity_ = 0;
+      return false;
+    }
+  }
+  return true;
+}
+
+bool RequestContext::AppendToBody(Cronet_BufferPtr buffer,
+                                  uint64_t bytes_read) {
+  if (body_size_ + bytes_read > body_capacity_) {
+    size_t capacity = body_capacity_ > 0 ? body_capacity_ : 32 * 1024;
+    while (capacity < body_size_ + bytes_read) {
+      capacity *= 2;
+    }
+    // The body so far is freed along with the context.
+    uint8_t *body = static_cast<uint8_t *>(realloc(body_, capacity));
+    if (body == nullptr) {
+      DispatchCallback("OnBodyError", request_, CallbackArgBuilder(1, capacity));
+      return false;
+    }
+    body_ = body;
+    body_capacity_ = capacity;
+  }
+  memcpy(body_ + body_size_, _Cronet_Buffer_GetData(buffer), bytes_read);
+  body_size_ += bytes_read;
+  return true;
+}
+
+void RequestContext::DispatchBody(int32_t status_code) {
+  uint8_t *body = body_size_ > 0 ? body_ : nullptr;
+  if (body == nullptr) {
+    free(body_);
+  }
+  body_ = nullptr;
+  DispatchCallbackWithData(
+      "OnSucceeded", request_,
+      CallbackArgBuilder(3, status_code, redirects_.size(), redirects_.data()),
+      body, body_size_);
+}
+
+// Posts the records framed so far, if any.
+static void DispatchRecords(RecordFramer *framer,
+                            Cronet_UrlRequestPtr request) {
+  if (!framer->HasRecords()) {
+    return;
+  }
+  size_t size;
+  uint8_t *records = framer->TakeRecords(&size);
+  DispatchCallbackWithData("OnRecordsRead", request, CallbackArgBuilder(0),
+                           records, size);
+}
+
+bool RequestContext::FrameRecords(Cronet_BufferPtr buffer,
+                                  uint64_t bytes_read) {
+  RecordFramer::Error error = framer_->Feed(
+      static_cast<const uint8_t *>(_Cronet_Buffer_GetData(buffer)),
+      bytes_read);
+  // Records framed before the error are still delivered.
+  DispatchRecords(framer_, request_);
+  if (error != RecordFramer::kOk) {
+    DispatchCallback("OnFramingError", request_, CallbackArgBuilder(1, error));
+    return false;
+  }
+  return true;
+}
+
+void RequestContext::FinishRecords(int32_t status_code) {
+  RecordFramer::Error error = framer_->Finish();
+  DispatchRecords(framer_, request_);
+  if (error != RecordFramer::kOk) {
+    // Too late to cancel, report the error before the request completes.
+    DispatchCallback("OnFramingError", request_, CallbackArgBuilder(1, error));
+  }
+  DispatchCallback("OnSucceeded", request_,
+                   CallbackArgBuilder(3, status_code, redirects_.size(),
+                                      redirects_.data()));
+}
+
+bool RequestContext::StartSink(Cronet_UrlResponseInfoPtr info,
+                               int32_t status_code) {
+  // Length of the whole object, or -1 if unknown.
+  int64_t length = -1;
+  Cronet_String content_range = FindHeader(info, "content-range");
+  Cronet_String content_length = FindHeader(info, "content-length");
+  if (status_code == 206 && content_range != nullptr) {
+    const char *total = strchr(content_range, '/');
+    if (total != nullptr && total[1] != '*') {
+      length = strtoll(total + 1, nullptr, 10);
+    }
+  } else if (content_length != nullptr) {
+    length = strtoll(content_length, nullptr, 10);
+  }
+  // Strong validator the ranges are checked against with If-Range. Weak
+  // entity tags can't be used for that.
+  Cronet_String validator = FindHeader(info, "etag");
+  if (validator != nullptr && strncmp(validator, "W/", 2) == 0) {
+    validator = nullptr;
+  }
+  if (validator == nullptr) {
+    validator = FindHeader(info, "last-modified");
+  }
+  // Freed by the Dart side.
+  char *validator_copy =
+      validator != nullptr ? CopyStringForDart(validator) : nullptr;
+  DispatchCallback("OnSinkStarted", request_,
+                   CallbackArgBuilder(4, status_code, Low32(length),
+                                      High32(length), validator_copy));
+  if (sink_length_ >= 0 && status_code != 206) {
+    // The whole object would be written where the range belongs. The object
+    // has likely changed since the range was computed.
+    DispatchCallback("OnSinkError", request_,
+                     CallbackArgBuilder(2, SINK_ERROR_NOT_PARTIAL, 0));
+    return false;
+  }
+  return true;
+}
+
+bool RequestContext::WriteToSink(Cronet_BufferPtr buffer,
+                                 uint64_t bytes_read) {
+  if (sink_length_ >= 0 &&
+      sink_->written() + static_cast<int64_t>(bytes_read) > sink_length_) {
+    // Would overwrite the next range.
+    DispatchCallback("OnSinkError", request_,
+                     CallbackArgBuilder(2, SINK_ERROR_TOO_LONG, 0));
+    return false;
+  }
+  const uint8_t *data =
+      static_cast<const uint8_t *>(_Cronet_Buffer_GetData(buffer));
+  if (!sink_->Write(data, static_cast<size_t>(bytes_read))) {
+    DispatchCallback("OnSinkError", request_,
+                     CallbackArgBuilder(2, SINK_ERROR_IO, sink_->error()));
+    return false;
+  }
+  if (sink_->written() - sink_reported_ >= kSinkProgressBytes) {
+    sink_reported_ = sink_->written();
+    DispatchCallback("OnSinkProgress", request_,
+                     CallbackArgBuilder(2, Low32(sink_reported_),
+                                        High32(sink_reported_)));
+  }
+  return true;
+}
+
+void RequestContext::FinishSink(int32_t status_code) {
+  int64_t written = sink_->written();
+  DispatchCallback("OnSinkProgress", request_,
+                   CallbackArgBuilder(2, Low32(written), High32(written)));
+  DispatchCallback("OnSucceeded", request_,
+                   CallbackArgBuilder(3, status_code, redirects_.size(),
+                                      redirects_.data()));
+}
+
+int32_t RequestContext::CheckRedirect(Cronet_String location) const {
+  bool same_origin = IsSameOrigin(url_, location);
+  if (!same_origin && (redirect_flags_ & REDIRECT_SAME_ORIGIN_ONLY)) {
+    return REDIRECT_DENIED_CROSS_ORIGIN;
+  }
+  bool http_allowed = (redirect_flags_ & REDIRECT_ALLOW_HTTP) &&
+                      HasScheme(location, "http");
+  bool https_allowed = (redirect_flags_ & REDIRECT_ALLOW_HTTPS) &&
+                       HasScheme(location, "https");
+  if (!http_allowed && !https_allowed) {
+    return REDIRECT_DENIED_SCHEME;
+  }
+  // Cronet can't drop headers of a redirected request, so a request carrying
+  // credentials is not allowed to leave its origin at all.
+  if (!same_origin && has_credentials_ &&
+      (redirect_flags_ & REDIRECT_STRIP_AUTH_CROSS_ORIGIN)) {
+    return REDIRECT_DENIED_CREDENTIALS;
+  }
+  return 0;
+}
+
+void RequestContext::OnRedirect(Cronet_String location, int32_t status_code) {
+  TRACE_EVENT(TRACE_REDIRECT, port_, status_code);
+  if (static_cast<int32_t>(redirects_.size()) >= max_redirects_) {
+    // Same as not following redirects at all.
+    _Cronet_UrlRequest_Cancel(request_);
+    return;
+  }
+  int32_t denied = CheckRedirect(location);
+  if (denied != 0) {
+    // Location lives in the arena until the request is destroyed, which only
+    // happens after the Dart side has seen this message.
+    DispatchCallback("OnRedirectDenied", request_,
+                     CallbackArgBuilder(4, denied, arena_.CopyString(location),
+                                        redirects_.size(), redirects_.data()));
+    _Cronet_UrlRequest_Cancel(request_);
+    return;
+  }
+  RedirectEntry entry = {arena_.CopyString(location), status_code};
+  redirects_.push_back(entry);
+  redirect_count_.store(static_cast<int32_t>(redirects_.size()));
+  // Only fails if the request is already done, in which case the final
+  // callback is on its way anyway.
+  _Cronet_UrlRequest_FollowRedirect(request_);
+}
+
+void RequestContext::ResponseStarted(Cronet_UrlResponseInfoPtr info) {
+  TRACE_EVENT(TRACE_RESPONSE_STARTED, port_, 0);
+  // Too late for a retry, part of the response may be delivered already.
+  response_started_ = true;
+  if (progress_interval_ms_ > 0) {
+    Cronet_String content_length = FindHeader(info, "content-length");
+    if (content_length != nullptr) {
+      expected_.store(strtoll(content_length, nullptr, 10));
+    }
+  }
+  if (wheel_ != nullptr) {
+    wheel_->Cancel(&connect_timer_);
+  }
+}
+
+void RequestContext::Finished() {
+  {
+    // The progress timer doesn't schedule itself again from now on.
+    std::lock_guard<std::mutex> lock(mutex_);
+    finished_ = true;
+  }
+  CancelTimers();
+}
+
+void RequestContext::CancelTimers() {
+  if (wheel_ != nullptr) {
+    wheel_->Cancel(&connect_timer_);
+    wheel_->Cancel(&read_timer_);
+    wheel_->Cancel(&total_timer_);
+    wheel_->Cancel(&retry_timer_);
+    wheel_->Cancel(&progress_timer_);
+  }
+}
+
+void RequestContext::OnTimeout(Timer *timer) {
+  RequestContext *context = static_cast<RequestContext *>(timer->data);
+  // The first deadline to expire is the one reported.
+  int32_t none = 0;
+  context->timed_out_.compare_exchange_strong(none, timer->tag);
+  context->Cancel();
+}
+
+void RequestContext::Cancel() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  cancelled_ = true;
+  if (retry_pending_) {
+    // The retry reports the cancellation instead of starting an attempt.
+    wheel_->Schedule(&retry_timer_, 0);
+    return;
+  }
+  // Cancelling a request that is done already does nothing.
+  _Cronet_UrlRequest_Cancel(request_);
+}
+
+bool RequestContext::ShouldRetry(Cronet_Error_ERROR_CODE code,
+                                 bool immediately_retryable) {
+  return !cancelled_ && !response_started_ && attempts_ < max_attempts_ &&
+         (immediately_retryable || IsTransient(code)) && WithdrawRetry();
+}
+
+uint32_t RequestContext::Backoff() {
+  uint64_t backoff = static_cast<uint64_t>(retry_backoff_ms_)
+                     << (attempts_ - 1 < 20 ? attempts_ - 1 : 20);
+  if (backoff > retry_max_backoff_ms_) {
+    backoff = retry_max_backoff_ms_;
+  }
+  // Full jitter, so that requests failing together don't retry together.
+  return static_cast<uint32_t>(random_() % (backoff + 1));
+}
+
+void RequestContext::OnRequestFailed(Cronet_ErrorPtr error) {
+  bool retry;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    error_message_ = arena_.CopyString(_Cronet_Error_message_get(error));
+    error_code_ = _Cronet_Error_error_code_get(error);
+    internal_error_code_ = _Cronet_Error_internal_error_code_get(error);
+    immediately_retryable_ = _Cronet_Error_immediately_retryable_get(error);
+    quic_error_code_ = _Cronet_Error_quic_detailed_error_code_get(error);
+    retry = ShouldRetry(static_cast<Cronet_Error_ERROR_CODE>(error_code_),
+                        immediately_retryable_);
+    if (retry) {
+      retry_pending_ = true;
+      wheel_->Schedule(&retry_timer_,
+                       immediately_retryable_ ? 0 : Backoff());
+    }
+  }
+  if (retry) {
+    // The total deadline keeps running during the backoff.
+    wheel_->Cancel(&connect_timer_);
+    wheel_->Cancel(&read_timer_);
+    return;
+  }
+  Finished();
+  DispatchFailure();
+}
+
+void RequestContext::OnRetry(Timer *timer) {
+  static_cast<RequestContext *>(timer->data)->Retry();
+}
+
+void RequestContext::Retry() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (!retry_pending_) {
+    return;
+  }
+  retry_pending_ = false;
+  if (cancelled_) {
+    lock.unlock();
+    Finished();
+    TRACE_EVENT(TRACE_COMPLETED, port_, TRACE_OUTCOME_CANCELED);
+    DispatchCallback("OnCanceled", request_,
+                     CallbackArgBuilder(1, timed_out()));
+    return;
+  }
+  Cronet_UrlRequestPtr failed = request_;
+  // Redirects are followed again.
+  redirects_.clear();
+  redirect_count_.store(0);
+  Cronet_RESULT res = StartAttempt();
+  RemoveRequest(failed);
+  // Its OnFailed may still be running on the executor, it is destroyed
+  // along with the context.
+  failed_requests_.push_back(failed);
+  if (res != Cronet_RESULT_SUCCESS) {
+    lock.unlock();
+    Finished();
+    DispatchFailure();
+  }
+}
+
+int64_t RequestContext::sent() const {
+  return upload_provider_ != nullptr ? upload_provider_->sent() : 0;
+}
+
+void RequestContext::QueryStatus(
+    Cronet_UrlRequestStatusListener_OnStatusFunc on_status) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  // The request is registered before its first attempt is created.
+  if (finished_ || request_ == nullptr || status_pending_.exchange(true)) {
+    return;
+  }
+  if (status_listener_ == nullptr) {
+    status_listener_ = _Cronet_UrlRequestStatusListener_CreateWith(on_status);
+    _Cronet_UrlRequestStatusListener_SetClientContext(status_listener_, this);
+  }
+  _Cronet_UrlRequest_GetStatus(request_, status_listener_);
+}
+
+void RequestContext::OnProgressTick(Timer *timer) {
+  static_cast<RequestContext *>(timer->data)->QueryProgress();
+}
+
+void RequestContext::QueryProgress() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (finished_) {
+    return;
+  }
+  // A tick waiting for the load state is reported along with it, the next
+  // one is skipped.
+  if (!progress_pending_.exchange(true)) {
+    if (progress_listener_ == nullptr) {
+      progress_listener_ =
+          _Cronet_UrlRequestStatusListener_CreateWith(OnStatus);
+      _Cronet_UrlRequestStatusListener_SetClientContext(progress_listener_,
+                                                        this);
+    }
+    _Cronet_UrlRequest_GetStatus(request_, progress_listener_);
+  }
+  wheel_->Schedule(&progress_timer_, progress_interval_ms_);
+}
+
+void RequestContext::OnStatus(Cronet_UrlRequestStatusListenerPtr listener,
+                              Cronet_UrlRequestStatusListener_Status status) {
+  RequestContext *context = static_cast<RequestContext *>(
+      _Cronet_UrlRequestStatusListener_GetClientContext(listener));
+  int64_t received = context->received_.load(std::memory_order_relaxed);
+  int64_t expected = context->expected_.load();
+  UploadDataProvider *upload = context->upload_provider_;
+  int64_t sent = upload != nullptr ? upload->sent() : 0;
+  int64_t upload_length = upload != nullptr ? upload->GetLength() : 0;
+  // The status is shifted by one, INVALID is -1.
+  DispatchCallbackToPort(
+      "OnProgress", context->port_,
+      CallbackArgBuilder(9, static_cast<uintptr_t>(status + 1),
+                         Low32(received), High32(received), Low32(expected),
+                         High32(expected), Low32(sent), High32(sent),
+                         Low32(upload_length), High32(upload_length)));
+  context->progress_pending_.store(false);
+}
+
+void RequestContext::DispatchFailure() {
+  // Freed by the Dart side.
+  char *message = CopyStringForDart(error_message_);
+  TRACE_EVENT(TRACE_COMPLETED, port_, TRACE_OUTCOME_FAILED);
+  DispatchCallback(
+      "OnFailed", request_,
+      CallbackArgBuilder(6, message, static_cast<uintptr_t>(error_code_),
+                         static_cast<uintptr_t>(internal_error_code_),
+                         static_cast<uintptr_t>(immediately_retryable_),
+                         static_cast<uintptr_t>(quic_error_code_),
+                         static_cast<uintptr_t>(attempts_)));
+}
+
+RequestContext *
+RequestContext::FromCallback(Cronet_UrlRequestCallbackPtr callback) {
+  return static_cast<RequestContext *>(
+      _Cronet_UrlRequestCallback_GetClientContext(callback));
+}
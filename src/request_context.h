@@ -0,0 +1,256 @@
+// Copyright (c) 2021, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef REQUEST_CONTEXT_H_
+#define REQUEST_CONTEXT_H_
+
+#include "../third_party/cronet/cronet.idl_c.h"
+#include "../third_party/dart-sdk/dart_api_dl.h"
+#include "timer_wheel.h"
+#include "wrapper.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <random>
+#include <vector>
+
+class FileSink;
+class RecordFramer;
+class SampleExecutor;
+class UploadDataProvider;
+
+// Bump allocator for request scoped memory. Everything allocated from it is
+// released at once when the arena is destroyed.
+class Arena {
+public:
+  Arena() = default;
+  ~Arena();
+  Arena(const Arena &) = delete;
+  Arena &operator=(const Arena &) = delete;
+
+  // Allocates |size| bytes, aligned for any fundamental type.
+  void *Allocate(size_t size);
+  // Copies the null terminated |str| into the arena.
+  char *CopyString(const char *str);
+
+private:
+  static const size_t kBlockSize = 4096;
+  std::vector<char *> blocks_;
+  // Free space left in the last block.
+  char *cursor_ = nullptr;
+  size_t remaining_ = 0;
+};
+
+// Owns every native object allocated for a single request: the request
+// itself, its callback, executor and upload data provider, the response
+// buffer and all request scoped strings. Everything is released together
+// when the context is destroyed, after the request is done.
+//
+// A request failing before its response starts may be retried. Every attempt
+// is a new Cronet request, set up natively from the same params.
+class RequestContext {
+public:
+  explicit RequestContext(Dart_Port port);
+  ~RequestContext();
+  RequestContext(const RequestContext &) = delete;
+  RequestContext &operator=(const RequestContext &) = delete;
+
+  // Sets up the request described by |descriptor| and starts it on |engine|.
+  Cronet_RESULT Start(Cronet_EnginePtr engine,
+                      const RequestDescriptor &descriptor);
+
+  // Creates the buffer response data is read into. The buffer is handed to
+  // the Dart side, which passes it back to Cronet via Read().
+  Cronet_BufferPtr CreateResponseBuffer();
+  // Cronet has handed the response buffer back to the application.
+  void OnBufferReturned();
+  // Reads the next chunk of the response into the response buffer.
+  Cronet_RESULT Read();
+  // Whether the response body is accumulated natively.
+  bool aggregate_body() const { return aggregate_body_; }
+  // Whether the response body is split into records natively.
+  bool framing() const { return framer_ != nullptr; }
+  // Prepares the body buffer, presized from the Content-Length of |info|.
+  // Returns false if it can't be allocated, in which case OnBodyError is
+  // posted.
+  bool StartAggregating(Cronet_UrlResponseInfoPtr info);
+  // Appends |bytes_read| bytes of |buffer| to the body. Returns false if the
+  // body can't grow, in which case OnBodyError is posted.
+  bool AppendToBody(Cronet_BufferPtr buffer, uint64_t bytes_read);
+  // Posts OnSucceeded along with the body, handing the body over to the Dart
+  // side.
+  void DispatchBody(int32_t status_code);
+  // Frames |bytes_read| bytes of |buffer| and posts the complete records with
+  // OnRecordsRead. Returns false if the body can't be framed, in which case
+  // OnFramingError is posted.
+  bool FrameRecords(Cronet_BufferPtr buffer, uint64_t bytes_read);
+  // Posts the trailing record, if any, and OnSucceeded.
+  void FinishRecords(int32_t status_code);
+  // Whether the response body is written to a file natively.
+  bool sinks_body() const { return sink_ != nullptr; }
+  // Posts OnSinkStarted with what |info| says about the object. Returns false
+  // if a range request isn't answered with a range, in which case
+  // OnSinkError follows.
+  bool StartSink(Cronet_UrlResponseInfoPtr info, int32_t status_code);
+  // Writes |bytes_read| bytes of |buffer| to the file, posting OnSinkProgress
+  // every kSinkProgressBytes. Returns false if the bytes can't be written, in
+  // which case OnSinkError is posted.
+  bool WriteToSink(Cronet_BufferPtr buffer, uint64_t bytes_read);
+  // Posts the final OnSinkProgress and OnSucceeded.
+  void FinishSink(int32_t status_code);
+
+  // The response headers have been received.
+  void ResponseStarted(Cronet_UrlResponseInfoPtr info);
+  // Counts |bytes_read| bytes of the response body towards the progress.
+  void CountReceived(uint64_t bytes_read) {
+    received_.fetch_add(static_cast<int64_t>(bytes_read),
+                        std::memory_order_relaxed);
+  }
+  // Bytes of the response body and of the request body transferred so far.
+  int64_t received() const {
+    return received_.load(std::memory_order_relaxed);
+  }
+  int64_t sent() const;
+  // Asks Cronet for the load state of the current attempt, unless the
+  // request is done or the last query is still unanswered. |on_status| is
+  // called on a listener owned by this context, its client context, and must
+  // call StatusReported().
+  void QueryStatus(Cronet_UrlRequestStatusListener_OnStatusFunc on_status);
+  void StatusReported() { status_pending_.store(false); }
+  // The request is done, its deadlines don't matter anymore.
+  void Finished();
+  // TIMEOUT_* the request has been cancelled for, or 0.
+  int32_t timed_out() const { return timed_out_.load(); }
+  // Cancels the request, or its retry if it is waiting for one.
+  void Cancel();
+  // Retries the request after a backoff if |error| is transient and the retry
+  // policy allows it. Otherwise posts OnFailed.
+  void OnRequestFailed(Cronet_ErrorPtr error);
+
+  // Applies the redirect policy to a redirect to |location|. The redirect is
+  // either followed, or the request is cancelled.
+  void OnRedirect(Cronet_String location, int32_t status_code);
+
+  // Context of the request |callback| belongs to.
+  static RequestContext *FromCallback(Cronet_UrlRequestCallbackPtr callback);
+
+  Dart_Port port() const { return port_; }
+  Cronet_EnginePtr engine() const { return engine_; }
+  Cronet_UrlRequestPtr request() const { return request_; }
+  const char *url() const { return url_; }
+  std::chrono::steady_clock::time_point started() const { return started_; }
+  // Redirects followed so far.
+  const RedirectEntry *redirects() const { return redirects_.data(); }
+  size_t num_redirects() const { return redirects_.size(); }
+  // Same as num_redirects(), but safe to call from any thread.
+  int32_t redirect_count() const { return redirect_count_.load(); }
+  // Id in the RequestRegistry, 0 until the request is started.
+  uint64_t registry_id() const { return registry_id_; }
+  void set_registry_id(uint64_t id) { registry_id_ = id; }
+
+private:
+  // Reason |location| may not be redirected to, or 0 if it may be.
+  int32_t CheckRedirect(Cronet_String location) const;
+  // Cancels the request once one of its deadlines expires.
+  static void OnTimeout(Timer *timer);
+  void CancelTimers();
+  // Creates and starts a new attempt of the request.
+  Cronet_RESULT StartAttempt();
+  // Whether the failure of the current attempt is to be retried. Spends a
+  // retry of the budget if it is.
+  bool ShouldRetry(Cronet_Error_ERROR_CODE code, bool immediately_retryable);
+  // Random delay before the next attempt.
+  uint32_t Backoff();
+  static void OnRetry(Timer *timer);
+  void Retry();
+  // Snapshots the byte counters and asks Cronet for the load state, which
+  // OnStatus posts along with them.
+  static void OnProgressTick(Timer *timer);
+  void QueryProgress();
+  static void OnStatus(Cronet_UrlRequestStatusListenerPtr listener,
+                       Cronet_UrlRequestStatusListener_Status status);
+  // Posts OnFailed with the error of the last attempt.
+  void DispatchFailure();
+
+  Arena arena_;
+  Dart_Port port_;
+  const char *url_ = nullptr;
+  Cronet_EnginePtr engine_ = nullptr;
+  std::chrono::steady_clock::time_point started_;
+  uint64_t registry_id_ = 0;
+  // Kept for the retries, Cronet copies them into every attempt.
+  Cronet_UrlRequestParamsPtr params_ = nullptr;
+  // Guards the swap of |request_| for a retry against cancellation.
+  std::mutex mutex_;
+  Cronet_UrlRequestPtr request_ = nullptr;
+  Cronet_UrlRequestCallbackPtr callback_ = nullptr;
+  SampleExecutor *executor_ = nullptr;
+  Cronet_UploadDataProviderPtr cronet_upload_provider_ = nullptr;
+  UploadDataProvider *upload_provider_ = nullptr;
+  int64_t upload_length_ = 0;
+  Cronet_BufferPtr buffer_ = nullptr;
+  // Cronet owns the response buffer while a read is pending and releases it
+  // itself if the request ends meanwhile. Otherwise it is ours to destroy.
+  std::atomic<bool> buffer_held_{false};
+  int32_t max_redirects_ = 0;
+  int32_t redirect_flags_ = 0;
+  // Whether the request carries an Authorization or Cookie header.
+  bool has_credentials_ = false;
+  std::vector<RedirectEntry> redirects_;
+  std::atomic<int32_t> redirect_count_{0};
+  bool aggregate_body_ = false;
+  // Response body, allocated with malloc. Owned until DispatchBody.
+  uint8_t *body_ = nullptr;
+  size_t body_size_ = 0;
+  size_t body_capacity_ = 0;
+  RecordFramer *framer_ = nullptr;
+  FileSink *sink_ = nullptr;
+  int64_t sink_length_ = -1;
+  // Bytes written when OnSinkProgress was last posted.
+  int64_t sink_reported_ = 0;
+  // Wheel of the engine, if the request has deadlines.
+  TimerWheel *wheel_ = nullptr;
+  Timer connect_timer_;
+  Timer read_timer_;
+  Timer total_timer_;
+  uint32_t connect_timeout_ms_ = 0;
+  uint32_t read_timeout_ms_ = 0;
+  std::atomic<int32_t> timed_out_{0};
+  // Retry policy.
+  int32_t max_attempts_ = 1;
+  uint32_t retry_backoff_ms_ = 0;
+  uint32_t retry_max_backoff_ms_ = 0;
+  int32_t attempts_ = 0;
+  bool response_started_ = false;
+  bool retry_pending_ = false;
+  bool cancelled_ = false;
+  Timer retry_timer_;
+  // Requests of the failed attempts.
+  std::vector<Cronet_UrlRequestPtr> failed_requests_;
+  std::minstd_rand random_;
+  // Progress reporting, every |progress_interval_ms_| while the request runs.
+  Timer progress_timer_;
+  uint32_t progress_interval_ms_ = 0;
+  // Listener of the load state, reused by every tick and destroyed with the
+  // context. Set while a tick waits for the load state.
+  Cronet_UrlRequestStatusListenerPtr progress_listener_ = nullptr;
+  std::atomic<bool> progress_pending_{false};
+  // Same for the load state the watchdog asks for.
+  Cronet_UrlRequestStatusListenerPtr status_listener_ = nullptr;
+  std::atomic<bool> status_pending_{false};
+  bool finished_ = false;
+  std::atomic<int64_t> received_{0};
+  // Content-Length of the response, or -1 until it is known.
+  std::atomic<int64_t> expected_{-1};
+  // Error of the last attempt.
+  const char *error_message_ = nullptr;
+  int32_t error_code_ = 0;
+  int32_t internal_error_code_ = 0;
+  bool immediately_retryable_ = false;
+  int32_t quic_error_code_ = 0;
+};
+
+#endif // REQUEST_CONTEXT_H_
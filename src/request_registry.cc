@@ -0,0 +1,277 @@
+// Copyright (c) 2021, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "request_registry.h"
+#include "request_context.h"
+#include "timer_wheel.h"
+#include "wrapper_utils.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <stdlib.h>
+#include <string.h>
+#include <unordered_map>
+#include <vector>
+
+// Defined in wrapper.cc.
+extern Cronet_UrlRequestStatusListenerPtr (
+    *_Cronet_UrlRequestStatusListener_CreateWith)(
+    Cronet_UrlRequestStatusListener_OnStatusFunc OnStatusFunc);
+extern Cronet_ClientContext (
+    *_Cronet_UrlRequestStatusListener_GetClientContext)(
+    Cronet_UrlRequestStatusListenerPtr self);
+
+using Clock = std::chrono::steady_clock;
+
+// Bounds of the interval the watchdog checks the requests at, a quarter of
+// its threshold otherwise.
+static const uint32_t kMinWatchdogTickMs = 10;
+static const uint32_t kMaxWatchdogTickMs = 1000;
+
+namespace {
+
+struct Entry {
+  RequestContext *context;
+  // Progress of the request when it was last seen moving, and when that was.
+  int64_t bytes;
+  int32_t redirects;
+  Clock::time_point progressed;
+  // Last load state Cronet reported, or -1 (INVALID) if none yet.
+  int32_t status;
+  bool stuck;
+  // Looked at by a watchdog tick outside of the registry lock. The context
+  // isn't removed, and so not released, until the tick is done with it.
+  bool inspected;
+};
+
+// A request that didn't move for the threshold, as the watchdog saw it.
+struct Stalled {
+  RequestContext *context;
+  int64_t age;
+  int64_t idle;
+  int64_t sent;
+  int64_t received;
+  int32_t redirects;
+  int32_t status;
+};
+
+struct Watchdog {
+  Cronet_EnginePtr engine;
+  TimerWheel *wheel;
+  Timer timer;
+  std::atomic<uint32_t> threshold_ms;
+};
+
+} // namespace
+
+// Live requests by engine, keyed by their id.
+static std::mutex registryLock;
+// Signalled once a watchdog tick is done with the contexts it inspected.
+static std::condition_variable inspectedCondition;
+static std::unordered_map<Cronet_EnginePtr,
+                          std::unordered_map<uint64_t, Entry>>
+    engines;
+static uint64_t nextId = 1;
+
+static std::mutex watchdogsLock;
+static std::unordered_map<Cronet_EnginePtr, Watchdog *> watchdogs;
+
+static int64_t Milliseconds(Clock::duration duration) {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(duration)
+      .count();
+}
+
+static uint32_t WatchdogTick(uint32_t threshold_ms) {
+  uint32_t tick = threshold_ms / 4;
+  if (tick < kMinWatchdogTickMs) {
+    return kMinWatchdogTickMs;
+  }
+  return tick > kMaxWatchdogTickMs ? kMaxWatchdogTickMs : tick;
+}
+
+// Records whether the request of |entry| moved since it was last observed and
+// returns for how long it hasn't.
+static int64_t Observe(Entry &entry, Clock::time_point now) {
+  RequestContext *context = entry.context;
+  int64_t bytes = context->received() + context->sent();
+  int32_t redirects = context->redirect_count();
+  if (bytes != entry.bytes || redirects != entry.redirects) {
+    entry.bytes = bytes;
+    entry.redirects = redirects;
+    entry.progressed = now;
+    entry.stuck = false;
+  }
+  return Milliseconds(now - entry.progressed);
+}
+
+void RequestRegistry::Add(RequestContext *context) {
+  std::lock_guard<std::mutex> lock(registryLock);
+  uint64_t id = nextId++;
+  context->set_registry_id(id);
+  engines[context->engine()][id] = {context, 0, 0, context->started(), -1,
+                                    false, false};
+}
+
+void RequestRegistry::Remove(RequestContext *context) {
+  if (context->registry_id() == 0) {
+    return;
+  }
+  std::unique_lock<std::mutex> lock(registryLock);
+  auto requests = engines.find(context->engine());
+  auto it = requests->second.find(context->registry_id());
+  inspectedCondition.wait(lock, [&it] { return !it->second.inspected; });
+  requests->second.erase(it);
+  if (requests->second.empty()) {
+    engines.erase(requests);
+  }
+}
+
+RequestSnapshot *RequestRegistry::Snapshot(Cronet_EnginePtr engine,
+                                           int32_t *count) {
+  std::lock_guard<std::mutex> lock(registryLock);
+  *count = 0;
+  auto requests = engines.find(engine);
+  if (requests == engines.end()) {
+    return nullptr;
+  }
+  size_t size = requests->second.size() * sizeof(RequestSnapshot);
+  for (const auto &it : requests->second) {
+    size += strlen(it.second.context->url()) + 1;
+  }
+  // Freed by the Dart side.
+  RequestSnapshot *snapshots = static_cast<RequestSnapshot *>(malloc(size));
+  char *urls = reinterpret_cast<char *>(snapshots + requests->second.size());
+  Clock::time_point now = Clock::now();
+  for (auto &it : requests->second) {
+    Entry &entry = it.second;
+    RequestContext *context = entry.context;
+    RequestSnapshot &snapshot = snapshots[(*count)++];
+    size_t length = strlen(context->url()) + 1;
+    memcpy(urls, context->url(), length);
+    snapshot.url = urls;
+    urls += length;
+    snapshot.idle_ms = Observe(entry, now);
+    snapshot.age_ms = Milliseconds(now - context->started());
+    snapshot.bytes_sent = context->sent();
+    snapshot.bytes_received = context->received();
+    snapshot.redirects = context->redirect_count();
+    snapshot.status = entry.status;
+    snapshot.stuck = entry.stuck;
+  }
+  return snapshots;
+}
+
+static void OnStatus(Cronet_UrlRequestStatusListenerPtr listener,
+                     Cronet_UrlRequestStatusListener_Status status) {
+  // The listener is owned by the context, which outlives it.
+  RequestContext *context = static_cast<RequestContext *>(
+      _Cronet_UrlRequestStatusListener_GetClientContext(listener));
+  {
+    std::lock_guard<std::mutex> lock(registryLock);
+    auto requests = engines.find(context->engine());
+    if (requests != engines.end()) {
+      auto it = requests->second.find(context->registry_id());
+      // A change of the load state, say from connecting to sending the
+      // request, is progress too.
+      if (it != requests->second.end() && it->second.status != status) {
+        it->second.status = status;
+        it->second.progressed = Clock::now();
+        it->second.stuck = false;
+      }
+    }
+  }
+  context->StatusReported();
+}
+
+// Flags the requests of the engine that didn't move for the threshold and
+// asks Cronet for their load state, which the next tick looks at. Only the
+// entries are looked at under the registry lock, Cronet and Dart are called
+// once it is released.
+static void OnWatchdogTick(Timer *timer) {
+  Watchdog *watchdog = static_cast<Watchdog *>(timer->data);
+  uint32_t threshold_ms = watchdog->threshold_ms.load();
+  std::vector<RequestContext *> inspected;
+  std::vector<Stalled> stalled;
+  {
+    std::lock_guard<std::mutex> lock(registryLock);
+    auto requests = engines.find(watchdog->engine);
+    if (requests != engines.end()) {
+      Clock::time_point now = Clock::now();
+      inspected.reserve(requests->second.size());
+      for (auto &it : requests->second) {
+        Entry &entry = it.second;
+        RequestContext *context = entry.context;
+        entry.inspected = true;
+        inspected.push_back(context);
+        int64_t idle = Observe(entry, now);
+        if (!entry.stuck && idle >= threshold_ms) {
+          entry.stuck = true;
+          stalled.push_back({context, Milliseconds(now - context->started()),
+                             idle, context->sent(), context->received(),
+                             entry.redirects, entry.status});
+        }
+      }
+    }
+  }
+  for (const Stalled &request : stalled) {
+    // Freed by the Dart side.
+    char *url = CopyStringForDart(request.context->url());
+    // The status is shifted by one, INVALID is -1.
+    DispatchCallbackToPort(
+        "OnStuck", request.context->port(),
+        CallbackArgBuilder(11, url, Low32(request.age), High32(request.age),
+                           Low32(request.idle), High32(request.idle),
+                           Low32(request.sent), High32(request.sent),
+                           Low32(request.received), High32(request.received),
+                           static_cast<uintptr_t>(request.redirects),
+                           static_cast<uintptr_t>(request.status + 1)));
+  }
+  for (RequestContext *context : inspected) {
+    context->QueryStatus(OnStatus);
+  }
+  if (!inspected.empty()) {
+    {
+      std::lock_guard<std::mutex> lock(registryLock);
+      for (RequestContext *context : inspected) {
+        engines.at(context->engine()).at(context->registry_id()).inspected =
+            false;
+      }
+    }
+    inspectedCondition.notify_all();
+  }
+  watchdog->wheel->Schedule(timer, WatchdogTick(threshold_ms));
+}
+
+void RequestRegistry::SetStuckThreshold(Cronet_EnginePtr engine,
+                                        uint32_t threshold_ms) {
+  Watchdog *stopped = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(watchdogsLock);
+    auto it = watchdogs.find(engine);
+    if (threshold_ms > 0) {
+      Watchdog *watchdog;
+      if (it != watchdogs.end()) {
+        watchdog = it->second;
+      } else {
+        watchdog = new Watchdog();
+        watchdog->engine = engine;
+        watchdog->wheel = TimerWheel::ForEngine(engine);
+        watchdog->timer.callback = OnWatchdogTick;
+        watchdog->timer.data = watchdog;
+        watchdogs[engine] = watchdog;
+      }
+      watchdog->threshold_ms.store(threshold_ms);
+      watchdog->wheel->Schedule(&watchdog->timer, WatchdogTick(threshold_ms));
+      return;
+    }
+    if (it == watchdogs.end()) {
+      return;
+    }
+    stopped = it->second;
+    watchdogs.erase(it);
+  }
+  stopped->wheel->Cancel(&stopped->timer);
+  delete stopped;
+}
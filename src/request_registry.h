@@ -0,0 +1,39 @@
+// Copyright (c) 2021, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef REQUEST_REGISTRY_H_
+#define REQUEST_REGISTRY_H_
+
+#include "../third_party/cronet/cronet.idl_c.h"
+#include "wrapper.h"
+
+#include <stdint.h>
+
+class RequestContext;
+
+// Every live request of every engine, from the moment it is started until its
+// context is destroyed. Adding and removing a request are O(1).
+//
+// Besides snapshots of the requests of an engine, the registry runs a
+// watchdog per engine on request. It asks Cronet for the load state of every
+// request of the engine on the engine's timer wheel, and posts OnStuck for a
+// request once neither its byte counts, its redirects nor its load state
+// changed for a threshold.
+class RequestRegistry {
+public:
+  static void Add(RequestContext *context);
+  // Must be called before anything of |context| is released.
+  static void Remove(RequestContext *context);
+
+  // The live requests of |engine| in a single malloc'd block, which holds
+  // their URLs as well. Sets |count| to the number of requests.
+  static RequestSnapshot *Snapshot(Cronet_EnginePtr engine, int32_t *count);
+
+  // Starts, adjusts or, with a |threshold_ms| of 0, stops the watchdog of
+  // |engine|.
+  static void SetStuckThreshold(Cronet_EnginePtr engine,
+                                uint32_t threshold_ms);
+};
+
+#endif // REQUEST_REGISTRY_H_
@@ -0,0 +1,178 @@
+// Copyright (c) 2021, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "timer_wheel.h"
+#include <unordered_map>
+
+// Wheels of the engines, created when their first timer is needed.
+static std::mutex wheelsLock;
+static std::unordered_map<Cronet_EnginePtr, TimerWheel *> wheels;
+
+TimerWheel *TimerWheel::ForEngine(Cronet_EnginePtr engine) {
+  std::lock_guard<std::mutex> lock(wheelsLock);
+  TimerWheel *&wheel = wheels[engine];
+  if (wheel == nullptr) {
+    wheel = new TimerWheel();
+  }
+  return wheel;
+}
+
+void TimerWheel::DestroyForEngine(Cronet_EnginePtr engine) {
+  TimerWheel *wheel = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(wheelsLock);
+    auto it = wheels.find(engine);
+    if (it == wheels.end()) {
+      return;
+    }
+    wheel = it->second;
+    wheels.erase(it);
+  }
+  delete wheel;
+}
+
+TimerWheel::TimerWheel() : start_(std::chrono::steady_clock::now()) {
+  for (int level = 0; level < kLevels; level++) {
+    for (int slot = 0; slot < kSlots; slot++) {
+      slots_[level][slot].prev = &slots_[level][slot];
+      slots_[level][slot].next = &slots_[level][slot];
+    }
+  }
+  thread_ = std::thread(&TimerWheel::Run, this);
+}
+
+TimerWheel::~TimerWheel() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  wakeup_.notify_one();
+  thread_.join();
+}
+
+uint64_t TimerWheel::CurrentTick() const {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+             std::chrono::steady_clock::now() - start_)
+             .count() /
+         kTickMs;
+}
+
+void TimerWheel::Schedule(Timer *timer, uint32_t delay_ms) {
+  bool wake = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (timer->next != nullptr) {
+      Unlink(timer);
+      count_--;
+    }
+    if (count_ == 0) {
+      // The thread doesn't keep track of time while there are no timers.
+      now_ = CurrentTick();
+      wake = true;
+    }
+    // Rounded up, a timer never expires early.
+    timer->deadline = CurrentTick() + (delay_ms + kTickMs - 1) / kTickMs + 1;
+    Link(timer);
+    count_++;
+  }
+  if (wake) {
+    wakeup_.notify_one();
+  }
+}
+
+void TimerWheel::Cancel(Timer *timer) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (timer->next != nullptr) {
+    Unlink(timer);
+    count_--;
+  }
+  if (std::this_thread::get_id() == thread_.get_id()) {
+    return;
+  }
+  while (running_ == timer) {
+    finished_.wait(lock);
+  }
+}
+
+// Puts |timer| into the slot covering its deadline, on the lowest level that
+// reaches that far. Timers beyond the top level wait in its furthest slot and
+// are put back when it comes around.
+void TimerWheel::Link(Timer *timer) {
+  uint64_t deadline = timer->deadline > now_ ? timer->deadline : now_;
+  uint64_t delta = deadline - now_;
+  int level = 0;
+  while (level < kLevels - 1 &&
+         delta >= (uint64_t(1) << (kSlotBits * (level + 1)))) {
+    level++;
+  }
+  uint64_t range = uint64_t(1) << (kSlotBits * (level + 1));
+  if (delta >= range) {
+    deadline = now_ + range - 1;
+  }
+  Timer *head =
+      &slots_[level][(deadline >> (kSlotBits * level)) & (kSlots - 1)];
+  timer->prev = head->prev;
+  timer->next = head;
+  head->prev->next = timer;
+  head->prev = timer;
+}
+
+void TimerWheel::Unlink(Timer *timer) {
+  timer->prev->next = timer->next;
+  timer->next->prev = timer->prev;
+  timer->prev = nullptr;
+  timer->next = nullptr;
+}
+
+// Moves on by one tick: timers of the upper levels whose slot comes around
+// move down, then the timers due are run.
+void TimerWheel::Advance(std::unique_lock<std::mutex> &lock) {
+  now_++;
+  for (int level = 1; level < kLevels; level++) {
+    if ((now_ & ((uint64_t(1) << (kSlotBits * level)) - 1)) != 0) {
+      break;
+    }
+    Timer *head = &slots_[level][(now_ >> (kSlotBits * level)) & (kSlots - 1)];
+    while (head->next != head) {
+      Timer *timer = head->next;
+      Unlink(timer);
+      Link(timer);
+    }
+  }
+  Timer *head = &slots_[0][now_ & (kSlots - 1)];
+  while (head->next != head) {
+    Timer *timer = head->next;
+    Unlink(timer);
+    if (timer->deadline > now_) {
+      // Was parked in the top level.
+      Link(timer);
+      continue;
+    }
+    count_--;
+    // Runs without the lock, so that the callback can schedule timers. Cancel
+    // waits for it to return.
+    running_ = timer;
+    lock.unlock();
+    timer->callback(timer);
+    lock.lock();
+    running_ = nullptr;
+    finished_.notify_all();
+  }
+}
+
+void TimerWheel::Run() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!stopping_) {
+    if (count_ == 0) {
+      wakeup_.wait(lock);
+      continue;
+    }
+    wakeup_.wait_until(lock, start_ + std::chrono::milliseconds(
+                                          (now_ + 1) * kTickMs));
+    uint64_t tick = CurrentTick();
+    while (now_ < tick && count_ > 0) {
+      Advance(lock);
+    }
+  }
+}
@@ -0,0 +1,80 @@
+// Copyright (c) 2021, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef TIMER_WHEEL_H_
+#define TIMER_WHEEL_H_
+
+#include "../third_party/cronet/cronet.idl_c.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <stdint.h>
+#include <thread>
+
+// Timer owned by its user and linked into a TimerWheel while scheduled.
+struct Timer {
+  // Called on the wheel's thread when the timer expires.
+  void (*callback)(Timer *timer) = nullptr;
+  // Free for the user of the timer.
+  void *data = nullptr;
+  int32_t tag = 0;
+
+  // Managed by the wheel.
+  Timer *prev = nullptr;
+  Timer *next = nullptr;
+  uint64_t deadline = 0;
+};
+
+// Hierarchical timing wheel running the timers of an engine on its own
+// thread. Scheduling and cancelling are O(1), so it's fine to keep a lot of
+// timers around. The thread sleeps while no timer is scheduled.
+class TimerWheel {
+public:
+  TimerWheel();
+  ~TimerWheel();
+  TimerWheel(const TimerWheel &) = delete;
+  TimerWheel &operator=(const TimerWheel &) = delete;
+
+  // Schedules |timer| to expire in |delay_ms|, rescheduling it if it is
+  // already scheduled.
+  void Schedule(Timer *timer, uint32_t delay_ms);
+  // Unschedules |timer|. Once this returns, the timer's callback is neither
+  // running nor going to be called, unless called from the callback itself.
+  void Cancel(Timer *timer);
+
+  // Wheel of |engine|, created on first use.
+  static TimerWheel *ForEngine(Cronet_EnginePtr engine);
+  // Destroys the wheel of |engine|, if any. No timer may be scheduled.
+  static void DestroyForEngine(Cronet_EnginePtr engine);
+
+private:
+  static const int kLevels = 4;
+  static const int kSlotBits = 6;
+  static const int kSlots = 1 << kSlotBits;
+  // Resolution of the wheel.
+  static const int kTickMs = 10;
+
+  uint64_t CurrentTick() const;
+  void Link(Timer *timer);
+  static void Unlink(Timer *timer);
+  void Advance(std::unique_lock<std::mutex> &lock);
+  void Run();
+
+  std::mutex mutex_;
+  std::condition_variable wakeup_;
+  // Timer whose callback is running, and notified once it returns.
+  Timer *running_ = nullptr;
+  std::condition_variable finished_;
+  std::chrono::steady_clock::time_point start_;
+  // Last tick the timers have been run for.
+  uint64_t now_ = 0;
+  size_t count_ = 0;
+  bool stopping_ = false;
+  // Sentinels of the circular lists of timers of every slot.
+  Timer slots_[kLevels][kSlots];
+  std::thread thread_;
+};
+
+#endif // TIMER_WHEEL_H_
@@ -0,0 +1,214 @@
+// Copyright (c) 2021, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "trace_buffer.h"
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+std::atomic<bool> TraceBuffer::enabled_{false};
+
+namespace {
+
+// An event, written by the thread owning the ring and read by exports. The
+// sequence number is the index of the event plus one once it is complete,
+// and 0 while it is being written, so that a reader can tell a torn slot.
+struct Slot {
+  std::atomic<uint64_t> sequence{0};
+  std::atomic<int64_t> timestamp{0};
+  std::atomic<int64_t> request{0};
+  std::atomic<uint64_t> arg{0};
+  std::atomic<uint32_t> type{0};
+  std::atomic<uint32_t> thread{0};
+};
+
+struct Ring {
+  // Index of the next event. Only written by the owning thread.
+  std::atomic<uint64_t> head{0};
+  Slot slots[TraceBuffer::kCapacity];
+};
+
+struct Event {
+  int64_t timestamp;
+  int64_t request;
+  uint64_t arg;
+  uint32_t type;
+  uint32_t thread;
+};
+
+// Ring of the current thread, handed back for reuse when the thread exits.
+struct ThreadRing {
+  Ring *ring = nullptr;
+  uint32_t thread = 0;
+  ~ThreadRing();
+};
+
+} // namespace
+
+// Every ring ever created, and those no thread owns at the moment.
+static std::mutex ringsLock;
+static std::vector<Ring *> rings;
+static std::vector<Ring *> freeRings;
+static uint32_t nextThread = 1;
+// Events before this are left out of exports.
+static std::atomic<int64_t> clearedAt{0};
+
+static thread_local ThreadRing currentRing;
+
+ThreadRing::~ThreadRing() {
+  if (ring != nullptr) {
+    std::lock_guard<std::mutex> lock(ringsLock);
+    freeRings.push_back(ring);
+  }
+}
+
+static int64_t Now() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+void TraceBuffer::SetEnabled(bool enabled) { enabled_.store(enabled); }
+
+void TraceBuffer::Record(TraceEventType type, int64_t request, uint64_t arg) {
+  ThreadRing &current = currentRing;
+  if (current.ring == nullptr) {
+    std::lock_guard<std::mutex> lock(ringsLock);
+    if (freeRings.empty()) {
+      rings.push_back(new Ring());
+      current.ring = rings.back();
+    } else {
+      current.ring = freeRings.back();
+      freeRings.pop_back();
+    }
+    current.thread = nextThread++;
+  }
+  Ring *ring = current.ring;
+  uint64_t index = ring->head.load(std::memory_order_relaxed);
+  Slot &slot = ring->slots[index % kCapacity];
+  slot.sequence.store(0, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  slot.timestamp.store(Now(), std::memory_order_relaxed);
+  slot.request.store(request, std::memory_order_relaxed);
+  slot.arg.store(arg, std::memory_order_relaxed);
+  slot.type.store(type, std::memory_order_relaxed);
+  slot.thread.store(current.thread, std::memory_order_relaxed);
+  slot.sequence.store(index + 1, std::memory_order_release);
+  ring->head.store(index + 1, std::memory_order_release);
+}
+
+void TraceBuffer::Clear() { clearedAt.store(Now()); }
+
+// Appends the complete events of |ring| from |since| on to |events|.
+static void Collect(Ring *ring, int64_t since, std::vector<Event> *events) {
+  uint64_t head = ring->head.load(std::memory_order_acquire);
+  uint64_t first = head > TraceBuffer::kCapacity
+                       ? head - TraceBuffer::kCapacity
+                       : 0;
+  for (uint64_t index = first; index < head; index++) {
+    Slot &slot = ring->slots[index % TraceBuffer::kCapacity];
+    uint64_t before = slot.sequence.load(std::memory_order_acquire);
+    Event event = {slot.timestamp.load(std::memory_order_relaxed),
+                   slot.request.load(std::memory_order_relaxed),
+                   slot.arg.load(std::memory_order_relaxed),
+                   slot.type.load(std::memory_order_relaxed),
+                   slot.thread.load(std::memory_order_relaxed)};
+    std::atomic_thread_fence(std::memory_order_acquire);
+    uint64_t after = slot.sequence.load(std::memory_order_relaxed);
+    // Overwritten by a newer event meanwhile.
+    if (before != index + 1 || after != index + 1) {
+      continue;
+    }
+    if (event.timestamp >= since) {
+      events->push_back(event);
+    }
+  }
+}
+
+static const char *const kEventNames[] = {
+    "created",  "started",   "redirect",     "response-started",
+    "read",     "post",      "dart-handled", "completed",
+};
+
+static const char *const kOutcomeNames[] = {"succeeded", "failed",
+                                            "canceled"};
+
+// Appends |event| as a nestable async event of the track of its request.
+static void AppendEvent(const Event &event, std::string *json) {
+  char phase = 'n';
+  const char *name = kEventNames[event.type];
+  if (event.type == TRACE_CREATED) {
+    phase = 'b';
+    name = "request";
+  } else if (event.type == TRACE_COMPLETED) {
+    phase = 'e';
+    name = "request";
+  }
+  char buffer[256];
+  snprintf(buffer, sizeof(buffer),
+           "{\"name\":\"%s\",\"cat\":\"cronet\",\"ph\":\"%c\","
+           "\"id\":\"0x%llx\",\"ts\":%lld.%03lld,\"pid\":1,\"tid\":%u",
+           name, phase, static_cast<unsigned long long>(event.request),
+           static_cast<long long>(event.timestamp / 1000),
+           static_cast<long long>(event.timestamp % 1000), event.thread);
+  json->append(buffer);
+  switch (event.type) {
+  case TRACE_STARTED:
+    snprintf(buffer, sizeof(buffer), ",\"args\":{\"attempt\":%llu}",
+             static_cast<unsigned long long>(event.arg));
+    break;
+  case TRACE_REDIRECT:
+    snprintf(buffer, sizeof(buffer), ",\"args\":{\"status\":%llu}",
+             static_cast<unsigned long long>(event.arg));
+    break;
+  case TRACE_READ:
+    snprintf(buffer, sizeof(buffer), ",\"args\":{\"bytes\":%llu}",
+             static_cast<unsigned long long>(event.arg));
+    break;
+  case TRACE_POST:
+    snprintf(buffer, sizeof(buffer), ",\"args\":{\"callback\":\"%s\"}",
+             reinterpret_cast<const char *>(event.arg));
+    break;
+  case TRACE_COMPLETED:
+    snprintf(buffer, sizeof(buffer), ",\"args\":{\"outcome\":\"%s\"}",
+             kOutcomeNames[event.arg]);
+    break;
+  default:
+    buffer[0] = '\0';
+  }
+  json->append(buffer);
+  json->append("}");
+}
+
+char *TraceBuffer::ExportJson() {
+  std::vector<Event> events;
+  int64_t since = clearedAt.load();
+  {
+    std::lock_guard<std::mutex> lock(ringsLock);
+    for (Ring *ring : rings) {
+      Collect(ring, since, &events);
+    }
+  }
+  std::stable_sort(events.begin(), events.end(),
+                   [](const Event &a, const Event &b) {
+                     return a.timestamp < b.timestamp;
+                   });
+  std::string json = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+  for (size_t i = 0; i < events.size(); i++) {
+    if (i > 0) {
+      json.append(",\n");
+    }
+    AppendEvent(events[i], &json);
+  }
+  json.append("]}\n");
+  // Freed by the Dart side.
+  char *result = static_cast<char *>(malloc(json.size() + 1));
+  memcpy(result, json.c_str(), json.size() + 1);
+  return result;
+}
@@ -0,0 +1,75 @@
+// Copyright (c) 2021, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef TRACE_BUFFER_H_
+#define TRACE_BUFFER_H_
+
+#include <atomic>
+#include <stdint.h>
+
+// Lifecycle events of a request. Requests are identified by the port their
+// callbacks are posted to, which survives retries.
+enum TraceEventType : uint32_t {
+  TRACE_CREATED,
+  // |arg| is the attempt.
+  TRACE_STARTED,
+  // |arg| is the status code of the redirect.
+  TRACE_REDIRECT,
+  TRACE_RESPONSE_STARTED,
+  // |arg| is the number of bytes read.
+  TRACE_READ,
+  // |arg| is the name of the callback, a string literal.
+  TRACE_POST,
+  TRACE_DART_HANDLED,
+  // |arg| is one of TRACE_OUTCOME_*.
+  TRACE_COMPLETED,
+};
+
+enum TraceOutcome : uint32_t {
+  TRACE_OUTCOME_SUCCEEDED,
+  TRACE_OUTCOME_FAILED,
+  TRACE_OUTCOME_CANCELED,
+};
+
+// Records events into a ring buffer per thread, without locks, and exports
+// them as Chrome trace event JSON, which chrome://tracing and Perfetto load.
+//
+// Each ring keeps the last kCapacity events of its thread. Rings of exited
+// threads are reused by new ones, their events stay until overwritten.
+class TraceBuffer {
+public:
+  static bool enabled() { return enabled_.load(std::memory_order_relaxed); }
+  static void SetEnabled(bool enabled);
+
+  static void Record(TraceEventType type, int64_t request, uint64_t arg);
+
+  // The events recorded since the last Clear, oldest first, as a null
+  // terminated JSON document allocated with malloc.
+  static char *ExportJson();
+  // Drops the events recorded so far from later exports.
+  static void Clear();
+
+  static const uint64_t kCapacity = 4096;
+
+private:
+  static std::atomic<bool> enabled_;
+};
+
+// Records an event if tracing is on. Compiles to nothing in builds without
+// CRONET_TRACING, and to a relaxed load and a branch while tracing is off.
+#if defined(CRONET_TRACING)
+#define TRACE_EVENT(type, request, arg)                                        \
+  do {                                                                         \
+    if (TraceBuffer::enabled()) {                                              \
+      TraceBuffer::Record((type), static_cast<int64_t>(request),               \
+                          static_cast<uint64_t>(arg));                         \
+    }                                                                          \
+  } while (0)
+#else
+#define TRACE_EVENT(type, request, arg)                                        \
+  do {                                                                         \
+  } while (0)
+#endif
+
+#endif // TRACE_BUFFER_H_
@@ -1,28 +1,79 @@
 #include "upload_data_provider.h"
+#include "memory_accounting.h"
+#include "upload_source.h"
 #include "wrapper_utils.h"
 #include <algorithm>
 #include <iostream>
 
 extern std::unordered_map<Cronet_UrlRequestPtr, Dart_Port> requestNativePorts;
+// Defined in wrapper.cc.
+extern void *(*_Cronet_Buffer_GetData)(Cronet_BufferPtr self);
+extern uint64_t (*_Cronet_Buffer_GetSize)(Cronet_BufferPtr self);
+extern void (*_Cronet_UploadDataSink_OnReadSucceeded)(
+    Cronet_UploadDataSinkPtr self, uint64_t bytes_read, bool final_chunk);
+extern void (*_Cronet_UploadDataSink_OnReadError)(
+    Cronet_UploadDataSinkPtr self, Cronet_String error_message);
+extern void (*_Cronet_UploadDataSink_OnRewindSucceeded)(
+    Cronet_UploadDataSinkPtr self);
+
+UploadDataProvider::UploadDataProvider() {
+  MemoryAccounting::Allocated(MEMORY_UPLOAD_PROVIDERS,
+                              sizeof(UploadDataProvider));
+}
+
+UploadDataProvider::~UploadDataProvider() {
+  delete source_;
+  MemoryAccounting::Freed(MEMORY_UPLOAD_PROVIDERS, sizeof(UploadDataProvider));
+}
 
 void UploadDataProvider::Init(int64_t length, Cronet_UrlRequestPtr request) {
   length_ = length;
   request_ = request;
 }
 
-int64_t UploadDataProvider::GetLength() { return length_; }
+// -1 tells Cronet the length is unknown, the body is then sent chunked.
+int64_t UploadDataProvider::GetLength() {
+  return source_ != nullptr ? source_->length() : length_;
+}
 
 void UploadDataProvider::ReadFunc(Cronet_UploadDataSinkPtr upload_data_sink,
                                   Cronet_BufferPtr buffer) {
+  if (source_ != nullptr) {
+    bool done = false;
+    int64_t written = source_->Read(
+        static_cast<uint8_t *>(_Cronet_Buffer_GetData(buffer)),
+        static_cast<size_t>(_Cronet_Buffer_GetSize(buffer)), &done);
+    if (written < 0) {
+      _Cronet_UploadDataSink_OnReadError(upload_data_sink, source_->error());
+      return;
+    }
+    sent_.fetch_add(written, std::memory_order_relaxed);
+    // Only chunked uploads have a final chunk.
+    _Cronet_UploadDataSink_OnReadSucceeded(upload_data_sink,
+                                           static_cast<uint64_t>(written),
+                                           done && source_->length() < 0);
+    return;
+  }
+  // The Dart side fills the buffer as much as the rest of the body allows.
+  int64_t size = static_cast<int64_t>(_Cronet_Buffer_GetSize(buffer));
+  int64_t sent = sent_.load(std::memory_order_relaxed);
+  sent_.store(sent + std::min(size, length_ - sent),
+              std::memory_order_relaxed);
   DispatchCallback("ReadFunc", request_,
                    CallbackArgBuilder(2, upload_data_sink, buffer));
 }
 
 void UploadDataProvider::RewindFunc(Cronet_UploadDataSinkPtr upload_data_sink) {
+  sent_.store(0, std::memory_order_relaxed);
+  if (source_ != nullptr) {
+    source_->Rewind();
+    _Cronet_UploadDataSink_OnRewindSucceeded(upload_data_sink);
+    return;
+  }
   DispatchCallback("RewindFunc", request_,
                    CallbackArgBuilder(1, upload_data_sink));
 }
 
-void UploadDataProvider::CloseFunc() {
-  DispatchCallback("CloseFunc", request_, CallbackArgBuilder(1, this));
-}
+// Nothing to do here, |this| is owned by the request's RequestContext and is
+// released along with it.
+void UploadDataProvider::CloseFunc() {}
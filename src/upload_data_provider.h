@@ -9,29 +9,44 @@
 #include "../third_party/dart-sdk/dart_api_dl.h"
 #include "wrapper.h"
 
+#include <atomic>
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 
+class UploadSource;
+
 // This class is implemented as a wrapper as we are yet to fix
 // https://github.com/dart-lang/sdk/issues/37022.
 class UploadDataProvider {
 public:
+  UploadDataProvider();
+  ~UploadDataProvider();
+  UploadDataProvider(const UploadDataProvider &) = delete;
+  UploadDataProvider &operator=(const UploadDataProvider &) = delete;
+
   // Sets the data to be uploaded.
   void Init(int64_t length, Cronet_UrlRequestPtr request_);
+  // Takes ownership of |source|, the body is then produced natively on the
+  // executor thread instead of being read from the Dart side.
+  void SetSource(UploadSource *source) { source_ = source; }
   void ReadFunc(Cronet_UploadDataSinkPtr upload_data_sink,
                 Cronet_BufferPtr buffer);
   void RewindFunc(Cronet_UploadDataSinkPtr upload_data_sink);
   void CloseFunc();
   // Gets the length of the data to be uploaded.
   int64_t GetLength();
+  // Bytes of the body handed to Cronet since the upload last started.
+  int64_t sent() const { return sent_.load(std::memory_order_relaxed); }
 
 private:
   // Length of the data to be uploaded.
   int64_t length_ = 0;
   // Pointer to the request |this| is providing to.
   Cronet_UrlRequestPtr request_;
+  UploadSource *source_ = nullptr;
+  std::atomic<int64_t> sent_{0};
 };
 
 #endif // UPLOAD_DATA_PROVIDER_H_
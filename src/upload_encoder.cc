@@ -0,0 +1,159 @@
+// Copyright (c) 2021, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "upload_encoder.h"
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(CRONET_HAS_ZLIB)
+#include <zlib.h>
+#endif
+#if defined(CRONET_HAS_ZSTD)
+#include <zstd.h>
+#endif
+
+UploadEncoder::UploadEncoder(const uint8_t *data, size_t length)
+    : data_(static_cast<uint8_t *>(malloc(length))), length_(length) {
+  memcpy(data_, data, length);
+}
+
+UploadEncoder::~UploadEncoder() { free(data_); }
+
+#if defined(CRONET_HAS_ZLIB)
+// gzip and zlib wrapped deflate, which is what HTTP calls deflate.
+class ZlibEncoder : public UploadEncoder {
+public:
+  ZlibEncoder(const uint8_t *data, size_t length)
+      : UploadEncoder(data, length) {}
+  ~ZlibEncoder() override {
+    if (initialized_) {
+      deflateEnd(&stream_);
+    }
+  }
+
+  bool Init(bool gzip) {
+    memset(&stream_, 0, sizeof(stream_));
+    // 16 added to the window bits selects the gzip wrapper.
+    initialized_ = deflateInit2(&stream_, Z_DEFAULT_COMPRESSION, Z_DEFLATED,
+                                gzip ? 15 + 16 : 15, 8,
+                                Z_DEFAULT_STRATEGY) == Z_OK;
+    Feed();
+    return initialized_;
+  }
+
+  int64_t Read(uint8_t *out, size_t capacity, bool *done) override {
+    stream_.next_out = out;
+    stream_.avail_out = static_cast<uInt>(capacity);
+    // The whole body is there already, so the stream is finished right away
+    // and deflate fills the buffer as much as it can.
+    int res = deflate(&stream_, Z_FINISH);
+    if (res != Z_OK && res != Z_STREAM_END && res != Z_BUF_ERROR) {
+      return -1;
+    }
+    *done = res == Z_STREAM_END;
+    return static_cast<int64_t>(capacity - stream_.avail_out);
+  }
+
+  void Rewind() override {
+    deflateReset(&stream_);
+    Feed();
+  }
+
+private:
+  // Hands the whole body to deflate.
+  void Feed() {
+    stream_.next_in = data_;
+    stream_.avail_in = static_cast<uInt>(length_);
+  }
+
+  z_stream stream_;
+  bool initialized_ = false;
+};
+#endif
+
+#if defined(CRONET_HAS_ZSTD)
+class ZstdEncoder : public UploadEncoder {
+public:
+  ZstdEncoder(const uint8_t *data, size_t length)
+      : UploadEncoder(data, length), context_(ZSTD_createCCtx()) {}
+  ~ZstdEncoder() override { ZSTD_freeCCtx(context_); }
+
+  bool Init() {
+    if (context_ == nullptr) {
+      return false;
+    }
+    // Recorded in the frame header, the server can size its buffers from it.
+    ZSTD_CCtx_setPledgedSrcSize(context_, length_);
+    return true;
+  }
+
+  int64_t Read(uint8_t *out, size_t capacity, bool *done) override {
+    ZSTD_outBuffer output = {out, capacity, 0};
+    ZSTD_inBuffer input = {data_, length_, position_};
+    size_t remaining =
+        ZSTD_compressStream2(context_, &output, &input, ZSTD_e_end);
+    if (ZSTD_isError(remaining)) {
+      return -1;
+    }
+    position_ = input.pos;
+    *done = remaining == 0;
+    return static_cast<int64_t>(output.pos);
+  }
+
+  void Rewind() override {
+    position_ = 0;
+    ZSTD_CCtx_reset(context_, ZSTD_reset_session_only);
+    ZSTD_CCtx_setPledgedSrcSize(context_, length_);
+  }
+
+private:
+  ZSTD_CCtx *context_;
+  size_t position_ = 0;
+};
+#endif
+
+bool UploadEncoder::IsSupported(int32_t mode) {
+  switch (mode) {
+#if defined(CRONET_HAS_ZLIB)
+  case kGzip:
+  case kDeflate:
+    return true;
+#endif
+#if defined(CRONET_HAS_ZSTD)
+  case kZstd:
+    return true;
+#endif
+  default:
+    return false;
+  }
+}
+
+UploadEncoder *UploadEncoder::Create(int32_t mode, const uint8_t *data,
+                                     size_t length) {
+  switch (mode) {
+#if defined(CRONET_HAS_ZLIB)
+  case kGzip:
+  case kDeflate: {
+    ZlibEncoder *encoder = new ZlibEncoder(data, length);
+    if (!encoder->Init(mode == kGzip)) {
+      delete encoder;
+      return nullptr;
+    }
+    return encoder;
+  }
+#endif
+#if defined(CRONET_HAS_ZSTD)
+  case kZstd: {
+    ZstdEncoder *encoder = new ZstdEncoder(data, length);
+    if (!encoder->Init()) {
+      delete encoder;
+      return nullptr;
+    }
+    return encoder;
+  }
+#endif
+  default:
+    return nullptr;
+  }
+}
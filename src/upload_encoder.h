@@ -0,0 +1,38 @@
+// Copyright (c) 2021, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef UPLOAD_ENCODER_H_
+#define UPLOAD_ENCODER_H_
+
+#include "upload_source.h"
+
+// Compresses a request body as it is uploaded, straight into the buffers
+// Cronet reads the body from. The length of the compressed body isn't known
+// until it has been produced.
+class UploadEncoder : public UploadSource {
+public:
+  // Same values as COMPRESSION_* in wrapper.h.
+  enum Mode { kGzip = 1, kDeflate = 2, kZstd = 3 };
+
+  // Whether |mode| is available in this build.
+  static bool IsSupported(int32_t mode);
+  // Encoder compressing a copy of the |length| bytes of |data| with |mode|.
+  // Null if |mode| isn't supported or the encoder can't be set up.
+  static UploadEncoder *Create(int32_t mode, const uint8_t *data,
+                               size_t length);
+
+  ~UploadEncoder() override;
+
+  int64_t length() const override { return -1; }
+  const char *error() const override { return "Compressing the body failed"; }
+
+protected:
+  UploadEncoder(const uint8_t *data, size_t length);
+
+  // Copy of the body, allocated with malloc.
+  uint8_t *data_;
+  size_t length_;
+};
+
+#endif // UPLOAD_ENCODER_H_
@@ -0,0 +1,32 @@
+// Copyright (c) 2021, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef UPLOAD_SOURCE_H_
+#define UPLOAD_SOURCE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Produces a request body natively, on the executor thread, straight into the
+// buffers Cronet reads the body from.
+class UploadSource {
+public:
+  UploadSource() = default;
+  virtual ~UploadSource() = default;
+  UploadSource(const UploadSource &) = delete;
+  UploadSource &operator=(const UploadSource &) = delete;
+
+  // Length of the body, or -1 if it isn't known until it has been produced.
+  virtual int64_t length() const = 0;
+  // Writes the next part of the body into the |capacity| bytes at |out|. Sets
+  // |done| once the end of the body has been written. Returns the number of
+  // bytes written, or -1 if the body can't be produced.
+  virtual int64_t Read(uint8_t *out, size_t capacity, bool *done) = 0;
+  // Starts the body over again.
+  virtual void Rewind() = 0;
+  // Why the last Read failed.
+  virtual const char *error() const = 0;
+};
+
+#endif // UPLOAD_SOURCE_H_
@@ -4,9 +4,17 @@
 
 #include "wrapper.h"
 #include "../third_party/cronet_impl/sample_executor.h"
+#include "file_sink.h"
+#include "memory_accounting.h"
+#include "request_context.h"
+#include "request_registry.h"
+#include "timer_wheel.h"
+#include "trace_buffer.h"
 #include "upload_data_provider.h"
+#include "upload_encoder.h"
 #include "wrapper_utils.h"
 #include <iostream>
+#include <mutex>
 #include <stdlib.h>
 #include <string.h>
 #include <unordered_map>
@@ -16,7 +24,7 @@
 #define STRINGIFY_(x) #x
 #define STRINGIFY(x) STRINGIFY_(x)
 
-#define WRAPPER_VERSION 2
+#define WRAPPER_VERSION 3
 
 #define WRAPPER_VERSTR STRINGIFY(WRAPPER_VERSION)
 
@@ -28,6 +36,7 @@ const char *VersionString() { return WRAPPER_VERSTR; }
 // Globals
 
 extern std::unordered_map<Cronet_UrlRequestPtr, Dart_Port> requestNativePorts;
+extern std::mutex requestNativePortsLock;
 
 Cronet_RESULT (*_Cronet_Engine_Shutdown)(Cronet_EnginePtr self);
 void (*_Cronet_Engine_Destroy)(Cronet_EnginePtr self);
@@ -40,6 +49,92 @@ Cronet_String (*_Cronet_UrlResponseInfo_http_status_text_get)(
     const Cronet_UrlResponseInfoPtr self);
 Cronet_ClientContext (*_Cronet_UploadDataProvider_GetClientContext)(
     Cronet_UploadDataProviderPtr self);
+
+/* Request setup */
+
+Cronet_UrlRequestPtr (*_Cronet_UrlRequest_Create)(void);
+void (*_Cronet_UrlRequest_Destroy)(Cronet_UrlRequestPtr self);
+Cronet_RESULT (*_Cronet_UrlRequest_InitWithParams)(
+    Cronet_UrlRequestPtr self, Cronet_EnginePtr engine, Cronet_String url,
+    Cronet_UrlRequestParamsPtr params, Cronet_UrlRequestCallbackPtr callback,
+    Cronet_ExecutorPtr executor);
+Cronet_RESULT (*_Cronet_UrlRequest_Start)(Cronet_UrlRequestPtr self);
+void (*_Cronet_UrlRequestParams_http_method_set)(
+    Cronet_UrlRequestParamsPtr self, Cronet_String http_method);
+void (*_Cronet_UrlRequestParams_priority_set)(
+    Cronet_UrlRequestParamsPtr self,
+    Cronet_UrlRequestParams_REQUEST_PRIORITY priority);
+void (*_Cronet_UrlRequestParams_upload_data_provider_set)(
+    Cronet_UrlRequestParamsPtr self,
+    Cronet_UploadDataProviderPtr upload_data_provider);
+Cronet_UrlRequestCallbackPtr (*_Cronet_UrlRequestCallback_CreateWith)(
+    Cronet_UrlRequestCallback_OnRedirectReceivedFunc OnRedirectReceivedFunc,
+    Cronet_UrlRequestCallback_OnResponseStartedFunc OnResponseStartedFunc,
+    Cronet_UrlRequestCallback_OnReadCompletedFunc OnReadCompletedFunc,
+    Cronet_UrlRequestCallback_OnSucceededFunc OnSucceededFunc,
+    Cronet_UrlRequestCallback_OnFailedFunc OnFailedFunc,
+    Cronet_UrlRequestCallback_OnCanceledFunc OnCanceledFunc);
+Cronet_UploadDataProviderPtr (*_Cronet_UploadDataProvider_CreateWith)(
+    Cronet_UploadDataProvider_GetLengthFunc GetLengthFunc,
+    Cronet_UploadDataProvider_ReadFunc ReadFunc,
+    Cronet_UploadDataProvider_RewindFunc RewindFunc,
+    Cronet_UploadDataProvider_CloseFunc CloseFunc);
+void (*_Cronet_UploadDataProvider_SetClientContext)(
+    Cronet_UploadDataProviderPtr self, Cronet_ClientContext client_context);
+Cronet_HttpHeaderPtr (*_Cronet_HttpHeader_Create)(void);
+void (*_Cronet_HttpHeader_Destroy)(Cronet_HttpHeaderPtr self);
+void (*_Cronet_HttpHeader_name_set)(Cronet_HttpHeaderPtr self,
+                                    Cronet_String name);
+void (*_Cronet_HttpHeader_value_set)(Cronet_HttpHeaderPtr self,
+                                     Cronet_String value);
+void (*_Cronet_UrlRequestParams_request_headers_add)(
+    Cronet_UrlRequestParamsPtr self, Cronet_HttpHeaderPtr element);
+Cronet_UrlRequestParamsPtr (*_Cronet_UrlRequestParams_Create)(void);
+void (*_Cronet_UrlRequestParams_Destroy)(Cronet_UrlRequestParamsPtr self);
+void (*_Cronet_UrlRequestCallback_Destroy)(Cronet_UrlRequestCallbackPtr self);
+void (*_Cronet_UrlRequestCallback_SetClientContext)(
+    Cronet_UrlRequestCallbackPtr self, Cronet_ClientContext client_context);
+Cronet_ClientContext (*_Cronet_UrlRequestCallback_GetClientContext)(
+    Cronet_UrlRequestCallbackPtr self);
+void (*_Cronet_UploadDataProvider_Destroy)(Cronet_UploadDataProviderPtr self);
+void (*_Cronet_Buffer_Destroy)(Cronet_BufferPtr self);
+Cronet_RESULT (*_Cronet_UrlRequest_Read)(Cronet_UrlRequestPtr self,
+                                         Cronet_BufferPtr buffer);
+Cronet_RESULT (*_Cronet_UrlRequest_FollowRedirect)(Cronet_UrlRequestPtr self);
+Cronet_Error_ERROR_CODE (*_Cronet_Error_error_code_get)(
+    const Cronet_ErrorPtr self);
+int32_t (*_Cronet_Error_internal_error_code_get)(const Cronet_ErrorPtr self);
+bool (*_Cronet_Error_immediately_retryable_get)(const Cronet_ErrorPtr self);
+int32_t (*_Cronet_Error_quic_detailed_error_code_get)(
+    const Cronet_ErrorPtr self);
+uint64_t (*_Cronet_Buffer_GetSize)(Cronet_BufferPtr self);
+void (*_Cronet_UploadDataSink_OnReadSucceeded)(Cronet_UploadDataSinkPtr self,
+                                               uint64_t bytes_read,
+                                               bool final_chunk);
+void (*_Cronet_UploadDataSink_OnReadError)(Cronet_UploadDataSinkPtr self,
+                                           Cronet_String error_message);
+void (*_Cronet_UploadDataSink_OnRewindSucceeded)(
+    Cronet_UploadDataSinkPtr self);
+void (*_Cronet_UrlRequest_GetStatus)(
+    Cronet_UrlRequestPtr self, Cronet_UrlRequestStatusListenerPtr listener);
+Cronet_UrlRequestStatusListenerPtr (
+    *_Cronet_UrlRequestStatusListener_CreateWith)(
+    Cronet_UrlRequestStatusListener_OnStatusFunc OnStatusFunc);
+void (*_Cronet_UrlRequestStatusListener_SetClientContext)(
+    Cronet_UrlRequestStatusListenerPtr self,
+    Cronet_ClientContext client_context);
+Cronet_ClientContext (*_Cronet_UrlRequestStatusListener_GetClientContext)(
+    Cronet_UrlRequestStatusListenerPtr self);
+void (*_Cronet_UrlRequestStatusListener_Destroy)(
+    Cronet_UrlRequestStatusListenerPtr self);
+void (*_Cronet_UrlRequest_Cancel)(Cronet_UrlRequestPtr self);
+uint32_t (*_Cronet_UrlResponseInfo_all_headers_list_size)(
+    Cronet_UrlResponseInfoPtr self);
+Cronet_HttpHeaderPtr (*_Cronet_UrlResponseInfo_all_headers_list_at)(
+    Cronet_UrlResponseInfoPtr self, uint32_t index);
+Cronet_String (*_Cronet_HttpHeader_name_get)(Cronet_HttpHeaderPtr self);
+Cronet_String (*_Cronet_HttpHeader_value_get)(Cronet_HttpHeaderPtr self);
+void *(*_Cronet_Buffer_GetData)(Cronet_BufferPtr self);
 ////////////////////////////////////////////////////////////////////////////////
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -85,14 +180,203 @@ void InitCronetApi(
 
 ////////////////////////////////////////////////////////////////////////////////
 
+////////////////////////////////////////////////////////////////////////////////
+// Initialize cronet functions required for starting requests
+void InitCronetRequestApi(
+    Cronet_UrlRequestPtr (*Cronet_UrlRequest_Create)(void),
+    void (*Cronet_UrlRequest_Destroy)(Cronet_UrlRequestPtr),
+    Cronet_RESULT (*Cronet_UrlRequest_InitWithParams)(
+        Cronet_UrlRequestPtr, Cronet_EnginePtr, Cronet_String,
+        Cronet_UrlRequestParamsPtr, Cronet_UrlRequestCallbackPtr,
+        Cronet_ExecutorPtr),
+    Cronet_RESULT (*Cronet_UrlRequest_Start)(Cronet_UrlRequestPtr),
+    void (*Cronet_UrlRequestParams_http_method_set)(Cronet_UrlRequestParamsPtr,
+                                                    Cronet_String),
+    void (*Cronet_UrlRequestParams_priority_set)(
+        Cronet_UrlRequestParamsPtr, Cronet_UrlRequestParams_REQUEST_PRIORITY),
+    void (*Cronet_UrlRequestParams_upload_data_provider_set)(
+        Cronet_UrlRequestParamsPtr, Cronet_UploadDataProviderPtr),
+    Cronet_UrlRequestCallbackPtr (*Cronet_UrlRequestCallback_CreateWith)(
+        Cronet_UrlRequestCallback_OnRedirectReceivedFunc,
+        Cronet_UrlRequestCallback_OnResponseStartedFunc,
+        Cronet_UrlRequestCallback_OnReadCompletedFunc,
+        Cronet_UrlRequestCallback_OnSucceededFunc,
+        Cronet_UrlRequestCallback_OnFailedFunc,
+        Cronet_UrlRequestCallback_OnCanceledFunc),
+    Cronet_UploadDataProviderPtr (*Cronet_UploadDataProvider_CreateWith)(
+        Cronet_UploadDataProvider_GetLengthFunc,
+        Cronet_UploadDataProvider_ReadFunc,
+        Cronet_UploadDataProvider_RewindFunc,
+        Cronet_UploadDataProvider_CloseFunc),
+    void (*Cronet_UploadDataProvider_SetClientContext)(
+        Cronet_UploadDataProviderPtr, Cronet_ClientContext),
+    Cronet_HttpHeaderPtr (*Cronet_HttpHeader_Create)(void),
+    void (*Cronet_HttpHeader_Destroy)(Cronet_HttpHeaderPtr),
+    void (*Cronet_HttpHeader_name_set)(Cronet_HttpHeaderPtr, Cronet_String),
+    void (*Cronet_HttpHeader_value_set)(Cronet_HttpHeaderPtr, Cronet_String),
+    void (*Cronet_UrlRequestParams_request_headers_add)(
+        Cronet_UrlRequestParamsPtr, Cronet_HttpHeaderPtr),
+    Cronet_UrlRequestParamsPtr (*Cronet_UrlRequestParams_Create)(void),
+    void (*Cronet_UrlRequestParams_Destroy)(Cronet_UrlRequestParamsPtr),
+    void (*Cronet_UrlRequestCallback_Destroy)(Cronet_UrlRequestCallbackPtr),
+    void (*Cronet_UrlRequestCallback_SetClientContext)(
+        Cronet_UrlRequestCallbackPtr, Cronet_ClientContext),
+    Cronet_ClientContext (*Cronet_UrlRequestCallback_GetClientContext)(
+        Cronet_UrlRequestCallbackPtr),
+    void (*Cronet_UploadDataProvider_Destroy)(Cronet_UploadDataProviderPtr),
+    void (*Cronet_Buffer_Destroy)(Cronet_BufferPtr),
+    Cronet_RESULT (*Cronet_UrlRequest_Read)(Cronet_UrlRequestPtr,
+                                            Cronet_BufferPtr),
+    Cronet_RESULT (*Cronet_UrlRequest_FollowRedirect)(Cronet_UrlRequestPtr),
+    void (*Cronet_UrlRequest_Cancel)(Cronet_UrlRequestPtr),
+    uint32_t (*Cronet_UrlResponseInfo_all_headers_list_size)(
+        Cronet_UrlResponseInfoPtr),
+    Cronet_HttpHeaderPtr (*Cronet_UrlResponseInfo_all_headers_list_at)(
+        Cronet_UrlResponseInfoPtr, uint32_t),
+    Cronet_String (*Cronet_HttpHeader_name_get)(Cronet_HttpHeaderPtr),
+    Cronet_String (*Cronet_HttpHeader_value_get)(Cronet_HttpHeaderPtr),
+    void *(*Cronet_Buffer_GetData)(Cronet_BufferPtr),
+    Cronet_Error_ERROR_CODE (*Cronet_Error_error_code_get)(
+        const Cronet_ErrorPtr),
+    int32_t (*Cronet_Error_internal_error_code_get)(const Cronet_ErrorPtr),
+    bool (*Cronet_Error_immediately_retryable_get)(const Cronet_ErrorPtr),
+    int32_t (*Cronet_Error_quic_detailed_error_code_get)(
+        const Cronet_ErrorPtr),
+    uint64_t (*Cronet_Buffer_GetSize)(Cronet_BufferPtr),
+    void (*Cronet_UploadDataSink_OnReadSucceeded)(Cronet_UploadDataSinkPtr,
+                                                  uint64_t, bool),
+    void (*Cronet_UploadDataSink_OnReadError)(Cronet_UploadDataSinkPtr,
+                                              Cronet_String),
+    void (*Cronet_UploadDataSink_OnRewindSucceeded)(Cronet_UploadDataSinkPtr),
+    void (*Cronet_UrlRequest_GetStatus)(Cronet_UrlRequestPtr,
+                                        Cronet_UrlRequestStatusListenerPtr),
+    Cronet_UrlRequestStatusListenerPtr (
+        *Cronet_UrlRequestStatusListener_CreateWith)(
+        Cronet_UrlRequestStatusListener_OnStatusFunc),
+    void (*Cronet_UrlRequestStatusListener_SetClientContext)(
+        Cronet_UrlRequestStatusListenerPtr, Cronet_ClientContext),
+    Cronet_ClientContext (*Cronet_UrlRequestStatusListener_GetClientContext)(
+        Cronet_UrlRequestStatusListenerPtr),
+    void (*Cronet_UrlRequestStatusListener_Destroy)(
+        Cronet_UrlRequestStatusListenerPtr)) {
+  if (!(Cronet_UrlRequest_Create && Cronet_UrlRequest_Destroy &&
+        Cronet_UrlRequest_InitWithParams && Cronet_UrlRequest_Start &&
+        Cronet_UrlRequestParams_http_method_set &&
+        Cronet_UrlRequestParams_priority_set &&
+        Cronet_UrlRequestParams_upload_data_provider_set &&
+        Cronet_UrlRequestCallback_CreateWith &&
+        Cronet_UploadDataProvider_CreateWith &&
+        Cronet_UploadDataProvider_SetClientContext &&
+        Cronet_HttpHeader_Create && Cronet_HttpHeader_Destroy &&
+        Cronet_HttpHeader_name_set && Cronet_HttpHeader_value_set &&
+        Cronet_UrlRequestParams_request_headers_add &&
+        Cronet_UrlRequestParams_Create && Cronet_UrlRequestParams_Destroy &&
+        Cronet_UrlRequestCallback_Destroy &&
+        Cronet_UrlRequestCallback_SetClientContext &&
+        Cronet_UrlRequestCallback_GetClientContext &&
+        Cronet_UploadDataProvider_Destroy && Cronet_Buffer_Destroy &&
+        Cronet_UrlRequest_Read && Cronet_UrlRequest_FollowRedirect &&
+        Cronet_UrlRequest_Cancel &&
+        Cronet_UrlResponseInfo_all_headers_list_size &&
+        Cronet_UrlResponseInfo_all_headers_list_at &&
+        Cronet_HttpHeader_name_get && Cronet_HttpHeader_value_get &&
+        Cronet_Buffer_GetData && Cronet_Error_error_code_get &&
+        Cronet_Error_internal_error_code_get &&
+        Cronet_Error_immediately_retryable_get &&
+        Cronet_Error_quic_detailed_error_code_get && Cronet_Buffer_GetSize &&
+        Cronet_UploadDataSink_OnReadSucceeded &&
+        Cronet_UploadDataSink_OnReadError &&
+        Cronet_UploadDataSink_OnRewindSucceeded &&
+        Cronet_UrlRequest_GetStatus &&
+        Cronet_UrlRequestStatusListener_CreateWith &&
+        Cronet_UrlRequestStatusListener_SetClientContext &&
+        Cronet_UrlRequestStatusListener_GetClientContext &&
+        Cronet_UrlRequestStatusListener_Destroy)) {
+    std::cerr << "Invalid pointer(s): null" << std::endl;
+    return;
+  }
+  _Cronet_UrlRequest_Create = Cronet_UrlRequest_Create;
+  _Cronet_UrlRequest_Destroy = Cronet_UrlRequest_Destroy;
+  _Cronet_UrlRequest_InitWithParams = Cronet_UrlRequest_InitWithParams;
+  _Cronet_UrlRequest_Start = Cronet_UrlRequest_Start;
+  _Cronet_UrlRequestParams_http_method_set =
+      Cronet_UrlRequestParams_http_method_set;
+  _Cronet_UrlRequestParams_priority_set = Cronet_UrlRequestParams_priority_set;
+  _Cronet_UrlRequestParams_upload_data_provider_set =
+      Cronet_UrlRequestParams_upload_data_provider_set;
+  _Cronet_UrlRequestCallback_CreateWith = Cronet_UrlRequestCallback_CreateWith;
+  _Cronet_UploadDataProvider_CreateWith = Cronet_UploadDataProvider_CreateWith;
+  _Cronet_UploadDataProvider_SetClientContext =
+      Cronet_UploadDataProvider_SetClientContext;
+  _Cronet_HttpHeader_Create = Cronet_HttpHeader_Create;
+  _Cronet_HttpHeader_Destroy = Cronet_HttpHeader_Destroy;
+  _Cronet_HttpHeader_name_set = Cronet_HttpHeader_name_set;
+  _Cronet_HttpHeader_value_set = Cronet_HttpHeader_value_set;
+  _Cronet_UrlRequestParams_request_headers_add =
+      Cronet_UrlRequestParams_request_headers_add;
+  _Cronet_UrlRequestParams_Create = Cronet_UrlRequestParams_Create;
+  _Cronet_UrlRequestParams_Destroy = Cronet_UrlRequestParams_Destroy;
+  _Cronet_UrlRequestCallback_Destroy = Cronet_UrlRequestCallback_Destroy;
+  _Cronet_UrlRequestCallback_SetClientContext =
+      Cronet_UrlRequestCallback_SetClientContext;
+  _Cronet_UrlRequestCallback_GetClientContext =
+      Cronet_UrlRequestCallback_GetClientContext;
+  _Cronet_UploadDataProvider_Destroy = Cronet_UploadDataProvider_Destroy;
+  _Cronet_Buffer_Destroy = Cronet_Buffer_Destroy;
+  _Cronet_UrlRequest_Read = Cronet_UrlRequest_Read;
+  _Cronet_UrlRequest_FollowRedirect = Cronet_UrlRequest_FollowRedirect;
+  _Cronet_UrlRequest_Cancel = Cronet_UrlRequest_Cancel;
+  _Cronet_UrlResponseInfo_all_headers_list_size =
+      Cronet_UrlResponseInfo_all_headers_list_size;
+  _Cronet_UrlResponseInfo_all_headers_list_at =
+      Cronet_UrlResponseInfo_all_headers_list_at;
+  _Cronet_HttpHeader_name_get = Cronet_HttpHeader_name_get;
+  _Cronet_HttpHeader_value_get = Cronet_HttpHeader_value_get;
+  _Cronet_Buffer_GetData = Cronet_Buffer_GetData;
+  _Cronet_Error_error_code_get = Cronet_Error_error_code_get;
+  _Cronet_Error_internal_error_code_get = Cronet_Error_internal_error_code_get;
+  _Cronet_Error_immediately_retryable_get =
+      Cronet_Error_immediately_retryable_get;
+  _Cronet_Error_quic_detailed_error_code_get =
+      Cronet_Error_quic_detailed_error_code_get;
+  _Cronet_Buffer_GetSize = Cronet_Buffer_GetSize;
+  _Cronet_UploadDataSink_OnReadSucceeded =
+      Cronet_UploadDataSink_OnReadSucceeded;
+  _Cronet_UploadDataSink_OnReadError = Cronet_UploadDataSink_OnReadError;
+  _Cronet_UploadDataSink_OnRewindSucceeded =
+      Cronet_UploadDataSink_OnRewindSucceeded;
+  _Cronet_UrlRequest_GetStatus = Cronet_UrlRequest_GetStatus;
+  _Cronet_UrlRequestStatusListener_CreateWith =
+      Cronet_UrlRequestStatusListener_CreateWith;
+  _Cronet_UrlRequestStatusListener_SetClientContext =
+      Cronet_UrlRequestStatusListener_SetClientContext;
+  _Cronet_UrlRequestStatusListener_GetClientContext =
+      Cronet_UrlRequestStatusListener_GetClientContext;
+  _Cronet_UrlRequestStatusListener_Destroy =
+      Cronet_UrlRequestStatusListener_Destroy;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 /* Callback Helpers */
 
+// Estimated size of an entry of requestNativePorts: its node and its bucket.
+static const int64_t kPortEntrySize =
+    sizeof(std::pair<const Cronet_UrlRequestPtr, Dart_Port>) +
+    2 * sizeof(void *);
+
 // Registers the Dart side's
 // ReceievePort's NativePort component
 //
 // This is required to send the data
 void RegisterCallbackHandler(Dart_Port send_port, Cronet_UrlRequestPtr rp) {
-  requestNativePorts[rp] = send_port;
+  std::lock_guard<std::mutex> lock(requestNativePortsLock);
+  auto result = requestNativePorts.emplace(rp, send_port);
+  if (result.second) {
+    MemoryAccounting::Allocated(MEMORY_REQUEST_PORTS, kPortEntrySize);
+  } else {
+    result.first->second = send_port;
+  }
 }
 
 /// Status Text is only returned to throw more meaningful HttpExceptions.
@@ -101,18 +385,26 @@ void RegisterCallbackHandler(Dart_Port send_port, Cronet_UrlRequestPtr rp) {
 char *statusText(Cronet_UrlResponseInfoPtr info, int statusCode, int lBound,
                  int uBound) {
   if (!(statusCode >= lBound && statusCode <= uBound)) {
-    Cronet_String status = _Cronet_UrlResponseInfo_http_status_text_get(info);
-    size_t statusLen = strlen(status);
-    char *statusDup = (char *)malloc(statusLen + 1);
-    memcpy(statusDup, status, statusLen + 1);
-    return statusDup;
+    return CopyStringForDart(
+        _Cronet_UrlResponseInfo_http_status_text_get(info));
   }
   return NULL;
 }
 
 /* Engine Cleanup Tasks */
-static void HttpClientDestroy(void *isolate_callback_data, void *peer) {
-  Cronet_EnginePtr ce = reinterpret_cast<Cronet_EnginePtr>(peer);
+
+// References to each engine: one per client using it, from any isolate, and
+// one per handle shared with ShareEngine and not used yet. Handles are
+// identified by tokens, each mapped to its engine until used once.
+static std::mutex engineRefsLock;
+static std::unordered_map<Cronet_EnginePtr, int> engineRefs;
+static std::unordered_map<int64_t, Cronet_EnginePtr> engineTokens;
+static int64_t nextEngineToken = 1;
+
+static void DestroyEngine(Cronet_EnginePtr ce) {
+  // No request of the engine is alive anymore, so neither are its timers.
+  RequestRegistry::SetStuckThreshold(ce, 0);
+  TimerWheel::DestroyForEngine(ce);
   if (_Cronet_Engine_Shutdown(ce) != Cronet_RESULT_SUCCESS) {
     std::cerr << "Failed to shut down the cronet engine." << std::endl;
     return;
@@ -120,15 +412,172 @@ static void HttpClientDestroy(void *isolate_callback_data, void *peer) {
   _Cronet_Engine_Destroy(ce);
 }
 
-void RemoveRequest(Cronet_UrlRequestPtr rp) { requestNativePorts.erase(rp); }
+static void ReleaseEngine(Cronet_EnginePtr ce) {
+  {
+    std::lock_guard<std::mutex> lock(engineRefsLock);
+    auto it = engineRefs.find(ce);
+    if (it == engineRefs.end()) {
+      return;
+    }
+    if (--it->second > 0) {
+      return;
+    }
+    engineRefs.erase(it);
+  }
+  DestroyEngine(ce);
+}
 
-// Register our HttpClient object from dart side
-void RegisterHttpClient(Dart_Handle h, Cronet_Engine *ce) {
+static void HttpClientDestroy(void *isolate_callback_data, void *peer) {
+  ReleaseEngine(reinterpret_cast<Cronet_EnginePtr>(peer));
+}
+
+// Releases the reference to |ce| once the client |h| is garbage collected.
+static void AttachHttpClient(Dart_Handle h, Cronet_EnginePtr ce) {
   void *peer = ce;
   intptr_t size = 8;
   Dart_NewFinalizableHandle_DL(h, peer, size, HttpClientDestroy);
 }
 
+// The engine of |token|, whose reference passes to the caller, or null if
+// the token was used already.
+static Cronet_EnginePtr TakeSharedEngine(int64_t token) {
+  std::lock_guard<std::mutex> lock(engineRefsLock);
+  auto it = engineTokens.find(token);
+  if (it == engineTokens.end()) {
+    return nullptr;
+  }
+  Cronet_EnginePtr ce = it->second;
+  engineTokens.erase(it);
+  return ce;
+}
+
+int64_t ShareEngine(Cronet_EnginePtr ce) {
+  std::lock_guard<std::mutex> lock(engineRefsLock);
+  engineRefs[ce]++;
+  int64_t token = nextEngineToken++;
+  engineTokens[token] = ce;
+  return token;
+}
+
+Cronet_EnginePtr AttachSharedEngine(Dart_Handle h, int64_t token) {
+  Cronet_EnginePtr ce = TakeSharedEngine(token);
+  if (ce != nullptr) {
+    AttachHttpClient(h, ce);
+  }
+  return ce;
+}
+
+bool ReleaseSharedEngine(int64_t token) {
+  Cronet_EnginePtr ce = TakeSharedEngine(token);
+  if (ce == nullptr) {
+    return false;
+  }
+  ReleaseEngine(ce);
+  return true;
+}
+
+void RemoveRequest(Cronet_UrlRequestPtr rp) {
+  std::lock_guard<std::mutex> lock(requestNativePortsLock);
+  if (requestNativePorts.erase(rp) > 0) {
+    MemoryAccounting::Freed(MEMORY_REQUEST_PORTS, kPortEntrySize);
+  }
+}
+
+// Register our HttpClient object from dart side
+void RegisterHttpClient(Dart_Handle h, Cronet_Engine *ce) {
+  {
+    std::lock_guard<std::mutex> lock(engineRefsLock);
+    engineRefs[ce]++;
+  }
+  AttachHttpClient(h, ce);
+}
+
+/* Bulk Request Submission */
+
+void UrlRequestParamsAddHeaders(Cronet_UrlRequestParamsPtr params,
+                                Cronet_String headers, int32_t count) {
+  // Cronet copies the name and the value, so a single header object can be
+  // reused for all of them.
+  Cronet_HttpHeaderPtr header = _Cronet_HttpHeader_Create();
+  Cronet_String cursor = headers;
+  for (int32_t i = 0; i < count; i++) {
+    Cronet_String name = cursor;
+    Cronet_String value = name + strlen(name) + 1;
+    cursor = value + strlen(value) + 1;
+    _Cronet_HttpHeader_name_set(header, name);
+    _Cronet_HttpHeader_value_set(header, value);
+    _Cronet_UrlRequestParams_request_headers_add(params, header);
+  }
+  _Cronet_HttpHeader_Destroy(header);
+}
+
+void StartRequests(Cronet_EnginePtr engine, RequestDescriptor *descriptors,
+                   int32_t count) {
+  for (int32_t i = 0; i < count; i++) {
+    RequestDescriptor &descriptor = descriptors[i];
+    RequestContext *context = new RequestContext(descriptor.port);
+    descriptor.result = context->Start(engine, descriptor);
+    if (descriptor.result != Cronet_RESULT_SUCCESS) {
+      delete context;
+      context = nullptr;
+    }
+    descriptor.context = context;
+    descriptor.request = context ? context->request() : nullptr;
+  }
+}
+
+RequestSnapshot *SnapshotRequests(Cronet_EnginePtr engine, int32_t *count) {
+  return RequestRegistry::Snapshot(engine, count);
+}
+
+void SetStuckRequestThreshold(Cronet_EnginePtr engine, uint32_t threshold_ms) {
+  RequestRegistry::SetStuckThreshold(engine, threshold_ms);
+}
+
+/* Tracing */
+
+void SetTracingEnabled(bool enabled) { TraceBuffer::SetEnabled(enabled); }
+
+void TraceDartHandled(Dart_Port port) {
+  TRACE_EVENT(TRACE_DART_HANDLED, port, 0);
+}
+
+char *ExportTrace() { return TraceBuffer::ExportJson(); }
+
+void ClearTrace() { TraceBuffer::Clear(); }
+
+/* Memory */
+
+void ReadMemoryStats(int64_t *stats) { MemoryAccounting::Read(stats); }
+
+void SetMemoryAlert(int64_t threshold_bytes, Dart_Port port) {
+  MemoryAccounting::SetAlert(threshold_bytes, port);
+}
+
+void FreeString(char *string) { FreeStringFromDart(string); }
+
+/* Callbacks */
+
+void SetCompactCallbacks(bool compact) { UseCompactCallbacks(compact); }
+
+/* Request Context C APIs */
+
+Cronet_RESULT RequestContextRead(RequestContextPtr self) {
+  return self->Read();
+}
+
+void RequestContextCancel(RequestContextPtr self) { self->Cancel(); }
+
+void RequestContextDestroy(RequestContextPtr self) { delete self; }
+
+bool UploadCompressionSupported(int32_t compression) {
+  return UploadEncoder::IsSupported(compression);
+}
+
+int32_t FileSinkPreallocate(Cronet_String path, int64_t length) {
+  return FileSink::Preallocate(path, length);
+}
+
 /* URL Callbacks Implementations
 ISSUE: https://github.com/dart-lang/sdk/issues/37022
 */
@@ -137,34 +586,76 @@ void OnRedirectReceived(Cronet_UrlRequestCallbackPtr self,
                         Cronet_UrlRequestPtr request,
                         Cronet_UrlResponseInfoPtr info,
                         Cronet_String newLocationUrl) {
-  size_t len = strlen(newLocationUrl);
-  char *newLoc = (char *)malloc(len + 1);
-  memcpy(newLoc, newLocationUrl, len + 1);
-  int statusCode = _Cronet_UrlResponseInfo_http_status_code_get(info);
-  // If NOT a 3XX status code.
-  DispatchCallback("OnRedirectReceived", request,
-                   CallbackArgBuilder(3, newLoc, statusCode,
-                                      statusText(info, statusCode, 300, 399)));
+  // Redirects are followed or refused natively, the Dart side only gets the
+  // summary of the chain once the response starts.
+  RequestContext::FromCallback(self)->OnRedirect(
+      newLocationUrl, _Cronet_UrlResponseInfo_http_status_code_get(info));
 }
 
 void OnResponseStarted(Cronet_UrlRequestCallbackPtr self,
                        Cronet_UrlRequestPtr request,
                        Cronet_UrlResponseInfoPtr info) {
-
-  // Create and allocate 32kb buffer.
-  Cronet_BufferPtr buffer = _Cronet_Buffer_Create();
-  _Cronet_Buffer_InitWithAlloc(buffer, 32 * 1024);
+  RequestContext *context = RequestContext::FromCallback(self);
+  context->ResponseStarted(info);
+  Cronet_BufferPtr buffer = context->CreateResponseBuffer();
   int statusCode = _Cronet_UrlResponseInfo_http_status_code_get(info);
+  if ((context->aggregate_body() || context->framing() ||
+       context->sinks_body()) &&
+      statusCode >= 100 && statusCode <= 299) {
+    // The body is read natively and delivered either as a whole with
+    // OnSucceeded, as records with OnRecordsRead, or written to a file.
+    if (context->aggregate_body()) {
+      if (!context->StartAggregating(info)) {
+        _Cronet_UrlRequest_Cancel(request);
+        return;
+      }
+    } else if (context->sinks_body() &&
+               !context->StartSink(info, statusCode)) {
+      _Cronet_UrlRequest_Cancel(request);
+      return;
+    }
+    if (context->Read() != Cronet_RESULT_SUCCESS) {
+      _Cronet_UrlRequest_Cancel(request);
+    }
+    return;
+  }
   // If NOT a 1XX or 2XX status code.
   DispatchCallback("OnResponseStarted", request,
-                   CallbackArgBuilder(3, statusCode, buffer,
-                                      statusText(info, statusCode, 100, 299)));
+                   CallbackArgBuilder(5, statusCode, buffer,
+                                      statusText(info, statusCode, 100, 299),
+                                      context->num_redirects(),
+                                      context->redirects()));
 }
 
 void OnReadCompleted(Cronet_UrlRequestCallbackPtr self,
                      Cronet_UrlRequestPtr request,
                      Cronet_UrlResponseInfoPtr info, Cronet_BufferPtr buffer,
                      uint64_t bytes_read) {
+  RequestContext *context = RequestContext::FromCallback(self);
+  TRACE_EVENT(TRACE_READ, context->port(), bytes_read);
+  context->OnBufferReturned();
+  context->CountReceived(bytes_read);
+  if (context->aggregate_body() || context->framing() ||
+      context->sinks_body()) {
+    if (context->aggregate_body()) {
+      if (!context->AppendToBody(buffer, bytes_read)) {
+        _Cronet_UrlRequest_Cancel(request);
+        return;
+      }
+    } else if (context->sinks_body()) {
+      if (!context->WriteToSink(buffer, bytes_read)) {
+        _Cronet_UrlRequest_Cancel(request);
+        return;
+      }
+    } else if (!context->FrameRecords(buffer, bytes_read)) {
+      _Cronet_UrlRequest_Cancel(request);
+      return;
+    }
+    if (context->Read() != Cronet_RESULT_SUCCESS) {
+      _Cronet_UrlRequest_Cancel(request);
+    }
+    return;
+  }
   int statusCode = _Cronet_UrlResponseInfo_http_status_code_get(info);
   // If NOT a 1XX or 2XX status code.
   DispatchCallback("OnReadCompleted", request,
@@ -176,25 +667,44 @@ void OnReadCompleted(Cronet_UrlRequestCallbackPtr self,
 void OnSucceeded(Cronet_UrlRequestCallbackPtr self,
                  Cronet_UrlRequestPtr request, Cronet_UrlResponseInfoPtr info) {
   int statusCode = _Cronet_UrlResponseInfo_http_status_code_get(info);
+  RequestContext *context = RequestContext::FromCallback(self);
+  context->Finished();
+  TRACE_EVENT(TRACE_COMPLETED, context->port(), TRACE_OUTCOME_SUCCEEDED);
+  if (context->aggregate_body()) {
+    context->DispatchBody(statusCode);
+    return;
+  }
+  if (context->framing()) {
+    context->FinishRecords(statusCode);
+    return;
+  }
+  if (context->sinks_body()) {
+    context->FinishSink(statusCode);
+    return;
+  }
   DispatchCallback("OnSucceeded", request, CallbackArgBuilder(1, statusCode));
 }
 
 void OnFailed(Cronet_UrlRequestCallbackPtr self, Cronet_UrlRequestPtr request,
               Cronet_UrlResponseInfoPtr info, Cronet_ErrorPtr error) {
-  Cronet_String errStr = _Cronet_Error_message_get(error);
-  size_t len = strlen(errStr);
-  char *dupStr = (char *)malloc(len + 1);
-  memcpy(dupStr, errStr, len + 1);
-  DispatchCallback("OnFailed", request, CallbackArgBuilder(1, dupStr));
+  // Either retried or reported to the Dart side.
+  RequestContext::FromCallback(self)->OnRequestFailed(error);
 }
 
 void OnCanceled(Cronet_UrlRequestCallbackPtr self, Cronet_UrlRequestPtr request,
                 Cronet_UrlResponseInfoPtr info) {
-  DispatchCallback("OnCanceled", request, CallbackArgBuilder(0));
+  RequestContext *context = RequestContext::FromCallback(self);
+  context->Finished();
+  TRACE_EVENT(TRACE_COMPLETED, context->port(), TRACE_OUTCOME_CANCELED);
+  DispatchCallback("OnCanceled", request,
+                   CallbackArgBuilder(1, context->timed_out()));
 }
 
 // Creates a SampleExecutor Object.
-SampleExecutorPtr SampleExecutorCreate() { return new SampleExecutor(); }
+SampleExecutorPtr SampleExecutorCreate() {
+  MemoryAccounting::Allocated(MEMORY_EXECUTORS, sizeof(SampleExecutor));
+  return new SampleExecutor();
+}
 
 // Destroys a SampleExecutor Object.
 void SampleExecutorDestroy(SampleExecutorPtr executor) {
@@ -203,6 +713,7 @@ void SampleExecutorDestroy(SampleExecutorPtr executor) {
     return;
   }
   delete executor;
+  MemoryAccounting::Freed(MEMORY_EXECUTORS, sizeof(SampleExecutor));
 }
 
 // Initializes a SampleExecutor.
@@ -21,6 +21,144 @@ extern "C" {
 
 typedef struct SampleExecutor *SampleExecutorPtr;
 typedef struct UploadDataProvider *UploadDataProviderPtr;
+typedef struct RequestContext *RequestContextPtr;
+
+/* Redirect policy flags. See RequestDescriptor.redirect_flags. */
+#define REDIRECT_SAME_ORIGIN_ONLY 1
+#define REDIRECT_ALLOW_HTTP 2
+#define REDIRECT_ALLOW_HTTPS 4
+#define REDIRECT_STRIP_AUTH_CROSS_ORIGIN 8
+
+/* Reasons a redirect is denied. Sent along with OnRedirectDenied. */
+#define REDIRECT_DENIED_CROSS_ORIGIN 1
+#define REDIRECT_DENIED_SCHEME 2
+#define REDIRECT_DENIED_CREDENTIALS 3
+
+/* Record framing modes. See RequestDescriptor.framing. */
+#define FRAMING_NONE 0
+#define FRAMING_NDJSON 1
+#define FRAMING_SSE 2
+
+/* Reasons framing fails. Sent along with OnFramingError. */
+#define FRAMING_ERROR_INVALID_UTF8 1
+#define FRAMING_ERROR_RECORD_TOO_LONG 2
+
+/* Deadlines of a request. The one that expired is sent along with
+   OnCanceled. */
+#define TIMEOUT_CONNECT 1
+#define TIMEOUT_READ 2
+#define TIMEOUT_TOTAL 3
+
+/* Content encodings of the request body. See
+   RequestDescriptor.upload_compression. */
+#define COMPRESSION_NONE 0
+#define COMPRESSION_GZIP 1
+#define COMPRESSION_DEFLATE 2
+#define COMPRESSION_ZSTD 3
+
+/* Reasons writing the response body to a file fails. Sent along with
+   OnSinkError. */
+#define SINK_ERROR_IO 1
+#define SINK_ERROR_NOT_PARTIAL 2
+#define SINK_ERROR_TOO_LONG 3
+
+/* A redirect followed by a request. */
+typedef struct RedirectEntry {
+  Cronet_String location;
+  int32_t status_code;
+} RedirectEntry;
+
+/* A part of a multipart/form-data request body. See
+   RequestDescriptor.multipart_parts. */
+typedef struct MultipartPart {
+  Cronet_String name;
+  // File name the part is sent with, or null.
+  Cronet_String filename;
+  // Content-Type of the part, or null.
+  Cronet_String content_type;
+  // Content of the part: the |length| bytes at |data| if |path| is null,
+  // copied when the request is started. Otherwise |length| bytes of the file
+  // at |path| from |offset|, or the rest of it if |length| is -1, read while
+  // the part is being uploaded.
+  const uint8_t *data;
+  Cronet_String path;
+  int64_t offset;
+  int64_t length;
+} MultipartPart;
+
+/* Describes a single request to be started by StartRequests.
+
+   Fields above |result| are filled by the Dart side, the rest are written
+   back by the wrapper. */
+typedef struct RequestDescriptor {
+  // Port to which the callbacks of this request are dispatched.
+  Dart_Port port;
+  Cronet_String url;
+  Cronet_String method;
+  // Packed request headers. See UrlRequestParamsAddHeaders.
+  Cronet_String headers;
+  int32_t num_headers;
+  // Length of the request body. An upload data provider is attached to the
+  // request if it is greater than 0.
+  int64_t upload_length;
+  // One of COMPRESSION_*. Unless COMPRESSION_NONE, the |upload_length| bytes
+  // at |upload_data| are copied and compressed natively while being uploaded,
+  // instead of being read from the Dart side.
+  int32_t upload_compression;
+  const uint8_t *upload_data;
+  // Parts of a multipart/form-data body separated by |multipart_boundary|,
+  // produced natively while being uploaded. Takes the place of the body of
+  // |upload_length| bytes if |num_multipart_parts| is greater than 0.
+  const MultipartPart *multipart_parts;
+  int32_t num_multipart_parts;
+  Cronet_String multipart_boundary;
+  // One of Cronet_UrlRequestParams_REQUEST_PRIORITY.
+  int32_t priority;
+  // Number of redirects to follow. 0 cancels the request on a redirect.
+  int32_t max_redirects;
+  // REDIRECT_* flags the redirects are checked against.
+  int32_t redirect_flags;
+  // Non zero to accumulate the whole response body natively and deliver it
+  // with OnSucceeded instead of a message per read.
+  int32_t aggregate_body;
+  // One of FRAMING_*. Unless FRAMING_NONE, the response body is split into
+  // records natively and delivered with OnRecordsRead.
+  int32_t framing;
+  // Milliseconds to wait for the response headers, for a read to complete and
+  // for the whole request. 0 waits forever. The request is cancelled once one
+  // of them expires.
+  int32_t connect_timeout_ms;
+  int32_t read_timeout_ms;
+  int32_t total_timeout_ms;
+  // Milliseconds between two OnProgress callbacks while the request runs. 0
+  // reports no progress.
+  int32_t progress_interval_ms;
+  // Attempts made before a transient failure is reported. Only requests
+  // without a body are retried, and only until their response starts.
+  int32_t max_attempts;
+  // Backoff before the first retry, doubled for every retry up to
+  // |retry_max_backoff_ms|. The actual delay is picked at random below it.
+  int32_t retry_backoff_ms;
+  int32_t retry_max_backoff_ms;
+  // Percentage of a retry the request earns towards the retry budget shared
+  // by every request.
+  int32_t retry_budget_percent;
+  // File the response body is written to, at |sink_offset|, instead of being
+  // delivered to the Dart side. Null delivers it.
+  Cronet_String sink_path;
+  int64_t sink_offset;
+  // Length of the byte range the request asks for, or -1 if it doesn't ask
+  // for one. A range request fails unless answered with 206 Partial Content
+  // and no more than |sink_length| bytes.
+  int64_t sink_length;
+  // Result of initializing and starting the request.
+  Cronet_RESULT result;
+  // Started request. Null if |result| isn't Cronet_RESULT_SUCCESS.
+  Cronet_UrlRequestPtr request;
+  // Context owning the request and everything allocated for it. Null if
+  // |result| isn't Cronet_RESULT_SUCCESS.
+  RequestContextPtr context;
+} RequestDescriptor;
 
 WRAPPER_EXPORT const char *VersionString();
 
@@ -50,11 +188,203 @@ WRAPPER_EXPORT void InitCronetExecutorApi(
     void (*Cronet_Runnable_Run)(Cronet_RunnablePtr),
     void (*Cronet_Runnable_Destroy)(Cronet_RunnablePtr));
 
+/* Forward declaration. Required by StartRequests */
+WRAPPER_EXPORT void InitCronetRequestApi(
+    Cronet_UrlRequestPtr (*Cronet_UrlRequest_Create)(void),
+    void (*Cronet_UrlRequest_Destroy)(Cronet_UrlRequestPtr),
+    Cronet_RESULT (*Cronet_UrlRequest_InitWithParams)(
+        Cronet_UrlRequestPtr, Cronet_EnginePtr, Cronet_String,
+        Cronet_UrlRequestParamsPtr, Cronet_UrlRequestCallbackPtr,
+        Cronet_ExecutorPtr),
+    Cronet_RESULT (*Cronet_UrlRequest_Start)(Cronet_UrlRequestPtr),
+    void (*Cronet_UrlRequestParams_http_method_set)(Cronet_UrlRequestParamsPtr,
+                                                    Cronet_String),
+    void (*Cronet_UrlRequestParams_priority_set)(
+        Cronet_UrlRequestParamsPtr, Cronet_UrlRequestParams_REQUEST_PRIORITY),
+    void (*Cronet_UrlRequestParams_upload_data_provider_set)(
+        Cronet_UrlRequestParamsPtr, Cronet_UploadDataProviderPtr),
+    Cronet_UrlRequestCallbackPtr (*Cronet_UrlRequestCallback_CreateWith)(
+        Cronet_UrlRequestCallback_OnRedirectReceivedFunc,
+        Cronet_UrlRequestCallback_OnResponseStartedFunc,
+        Cronet_UrlRequestCallback_OnReadCompletedFunc,
+        Cronet_UrlRequestCallback_OnSucceededFunc,
+        Cronet_UrlRequestCallback_OnFailedFunc,
+        Cronet_UrlRequestCallback_OnCanceledFunc),
+    Cronet_UploadDataProviderPtr (*Cronet_UploadDataProvider_CreateWith)(
+        Cronet_UploadDataProvider_GetLengthFunc,
+        Cronet_UploadDataProvider_ReadFunc,
+        Cronet_UploadDataProvider_RewindFunc,
+        Cronet_UploadDataProvider_CloseFunc),
+    void (*Cronet_UploadDataProvider_SetClientContext)(
+        Cronet_UploadDataProviderPtr, Cronet_ClientContext),
+    Cronet_HttpHeaderPtr (*Cronet_HttpHeader_Create)(void),
+    void (*Cronet_HttpHeader_Destroy)(Cronet_HttpHeaderPtr),
+    void (*Cronet_HttpHeader_name_set)(Cronet_HttpHeaderPtr, Cronet_String),
+    void (*Cronet_HttpHeader_value_set)(Cronet_HttpHeaderPtr, Cronet_String),
+    void (*Cronet_UrlRequestParams_request_headers_add)(
+        Cronet_UrlRequestParamsPtr, Cronet_HttpHeaderPtr),
+    Cronet_UrlRequestParamsPtr (*Cronet_UrlRequestParams_Create)(void),
+    void (*Cronet_UrlRequestParams_Destroy)(Cronet_UrlRequestParamsPtr),
+    void (*Cronet_UrlRequestCallback_Destroy)(Cronet_UrlRequestCallbackPtr),
+    void (*Cronet_UrlRequestCallback_SetClientContext)(
+        Cronet_UrlRequestCallbackPtr, Cronet_ClientContext),
+    Cronet_ClientContext (*Cronet_UrlRequestCallback_GetClientContext)(
+        Cronet_UrlRequestCallbackPtr),
+    void (*Cronet_UploadDataProvider_Destroy)(Cronet_UploadDataProviderPtr),
+    void (*Cronet_Buffer_Destroy)(Cronet_BufferPtr),
+    Cronet_RESULT (*Cronet_UrlRequest_Read)(Cronet_UrlRequestPtr,
+                                            Cronet_BufferPtr),
+    Cronet_RESULT (*Cronet_UrlRequest_FollowRedirect)(Cronet_UrlRequestPtr),
+    void (*Cronet_UrlRequest_Cancel)(Cronet_UrlRequestPtr),
+    uint32_t (*Cronet_UrlResponseInfo_all_headers_list_size)(
+        Cronet_UrlResponseInfoPtr),
+    Cronet_HttpHeaderPtr (*Cronet_UrlResponseInfo_all_headers_list_at)(
+        Cronet_UrlResponseInfoPtr, uint32_t),
+    Cronet_String (*Cronet_HttpHeader_name_get)(Cronet_HttpHeaderPtr),
+    Cronet_String (*Cronet_HttpHeader_value_get)(Cronet_HttpHeaderPtr),
+    void *(*Cronet_Buffer_GetData)(Cronet_BufferPtr),
+    Cronet_Error_ERROR_CODE (*Cronet_Error_error_code_get)(
+        const Cronet_ErrorPtr),
+    int32_t (*Cronet_Error_internal_error_code_get)(const Cronet_ErrorPtr),
+    bool (*Cronet_Error_immediately_retryable_get)(const Cronet_ErrorPtr),
+    int32_t (*Cronet_Error_quic_detailed_error_code_get)(
+        const Cronet_ErrorPtr),
+    uint64_t (*Cronet_Buffer_GetSize)(Cronet_BufferPtr),
+    void (*Cronet_UploadDataSink_OnReadSucceeded)(Cronet_UploadDataSinkPtr,
+                                                  uint64_t, bool),
+    void (*Cronet_UploadDataSink_OnReadError)(Cronet_UploadDataSinkPtr,
+                                              Cronet_String),
+    void (*Cronet_UploadDataSink_OnRewindSucceeded)(Cronet_UploadDataSinkPtr),
+    void (*Cronet_UrlRequest_GetStatus)(Cronet_UrlRequestPtr,
+                                        Cronet_UrlRequestStatusListenerPtr),
+    Cronet_UrlRequestStatusListenerPtr (
+        *Cronet_UrlRequestStatusListener_CreateWith)(
+        Cronet_UrlRequestStatusListener_OnStatusFunc),
+    void (*Cronet_UrlRequestStatusListener_SetClientContext)(
+        Cronet_UrlRequestStatusListenerPtr, Cronet_ClientContext),
+    Cronet_ClientContext (*Cronet_UrlRequestStatusListener_GetClientContext)(
+        Cronet_UrlRequestStatusListenerPtr),
+    void (*Cronet_UrlRequestStatusListener_Destroy)(
+        Cronet_UrlRequestStatusListenerPtr));
+
 WRAPPER_EXPORT void RegisterHttpClient(Dart_Handle h, Cronet_Engine *ce);
+
+/* Engines are reference counted, so that clients of several isolates can
+   share one. An engine is shut down and destroyed once its last reference is
+   released. */
+
+/* Adds a reference to |ce|, for a client of another isolate to take over
+   with AttachSharedEngine. Returns the token of the reference, which can be
+   used once. */
+WRAPPER_EXPORT int64_t ShareEngine(Cronet_Engine *ce);
+/* Has the client |h| take over the reference of |token|, released once |h|
+   is garbage collected. Returns its engine, or null if |token| was used
+   already. */
+WRAPPER_EXPORT Cronet_Engine *AttachSharedEngine(Dart_Handle h,
+                                                 int64_t token);
+/* Releases the reference of |token|. Returns false if it was used already. */
+WRAPPER_EXPORT bool ReleaseSharedEngine(int64_t token);
 WRAPPER_EXPORT void RegisterCallbackHandler(Dart_Port nativePort,
                                             Cronet_UrlRequest *rp);
 WRAPPER_EXPORT void RemoveRequest(Cronet_UrlRequest *rp);
 
+/* Adds |count| headers packed in |headers| to |params|. Every header is
+   packed as its name followed by its value, both null terminated. */
+WRAPPER_EXPORT void UrlRequestParamsAddHeaders(Cronet_UrlRequestParamsPtr params,
+                                               Cronet_String headers,
+                                               int32_t count);
+
+/* A live request of an engine, see SnapshotRequests. */
+typedef struct RequestSnapshot {
+  Cronet_String url;
+  /* Milliseconds since the request was started. */
+  int64_t age_ms;
+  /* Milliseconds since the request last moved: transferred bytes, followed a
+     redirect or changed its load state. */
+  int64_t idle_ms;
+  int64_t bytes_sent;
+  int64_t bytes_received;
+  int32_t redirects;
+  /* Last Cronet_UrlRequestStatusListener_Status seen by the watchdog, INVALID
+     if the watchdog isn't running. */
+  int32_t status;
+  /* Non zero if the watchdog flagged the request as stuck. */
+  int32_t stuck;
+} RequestSnapshot;
+
+/* Sets up and starts |count| requests described by |descriptors| on |engine|
+   in a single call. */
+WRAPPER_EXPORT void StartRequests(Cronet_EnginePtr engine,
+                                  RequestDescriptor *descriptors,
+                                  int32_t count);
+
+/* The requests of |engine| started and not destroyed yet, in a single block
+   allocated with malloc, URLs included. Sets |count| to their number. Returns
+   NULL if there is none. */
+WRAPPER_EXPORT RequestSnapshot *SnapshotRequests(Cronet_EnginePtr engine,
+                                                 int32_t *count);
+/* Has the requests of |engine| checked every now and then, and OnStuck
+   posted for those that didn't move for |threshold_ms|. 0 stops the
+   checks. */
+WRAPPER_EXPORT void SetStuckRequestThreshold(Cronet_EnginePtr engine,
+                                             uint32_t threshold_ms);
+
+/* Tracing */
+
+/* Starts or stops recording the lifecycle events of every request. Nothing
+   is recorded by builds without CRONET_TRACING. */
+WRAPPER_EXPORT void SetTracingEnabled(bool enabled);
+/* Records that the Dart side handled a callback posted to |port|. */
+WRAPPER_EXPORT void TraceDartHandled(Dart_Port port);
+/* The events recorded since the last ClearTrace, as Chrome trace event JSON
+   allocated with malloc. */
+WRAPPER_EXPORT char *ExportTrace();
+/* Leaves the events recorded so far out of later exports. */
+WRAPPER_EXPORT void ClearTrace();
+
+/* Memory */
+
+/* Writes the live bytes, peak bytes, live objects and peak objects of each
+   category of native memory held by the wrapper to |stats|, followed by the
+   live and peak bytes of all of them: Cronet buffers, callback arguments,
+   strings copied for the Dart side, upload data providers, executors and
+   request ports. That's 26 values. */
+WRAPPER_EXPORT void ReadMemoryStats(int64_t *stats);
+/* Posts the live bytes to |port| once they reach |threshold_bytes|, and again
+   after they went back below three quarters of it. 0 turns the alert off. */
+WRAPPER_EXPORT void SetMemoryAlert(int64_t threshold_bytes, Dart_Port port);
+/* Frees a string the wrapper handed to the Dart side. */
+WRAPPER_EXPORT void FreeString(char *string);
+
+/* Callbacks */
+
+/* Whether callbacks are posted as compact messages, a single Uint8List with
+   the id of the callback followed by its arguments, or as arrays holding the
+   name of the callback and its arguments. Compact by default. */
+WRAPPER_EXPORT void SetCompactCallbacks(bool compact);
+
+/* Request Context C APIs */
+
+/* Reads the next chunk of the response into the buffer handed to the Dart
+   side with OnResponseStarted. */
+WRAPPER_EXPORT Cronet_RESULT RequestContextRead(RequestContextPtr self);
+/* Cancels the request, or its retry if it waits for one. Must be used instead
+   of Cronet_UrlRequest_Cancel, as a retry replaces the request. */
+WRAPPER_EXPORT void RequestContextCancel(RequestContextPtr self);
+/* Destroys the request and everything allocated for it. Must only be called
+   once the request is done. */
+WRAPPER_EXPORT void RequestContextDestroy(RequestContextPtr self);
+
+/* Whether the request body can be compressed with |compression|, one of
+   COMPRESSION_*, in this build. */
+WRAPPER_EXPORT bool UploadCompressionSupported(int32_t compression);
+
+/* Sets the size of the file at |path| to |length| and reserves its disk space
+   where supported, creating the file if needed. Returns 0 or an errno
+   value. */
+WRAPPER_EXPORT int32_t FileSinkPreallocate(Cronet_String path,
+                                           int64_t length);
+
 /* Callbacks. ISSUE: https://github.com/dart-lang/sdk/issues/37022 */
 
 WRAPPER_EXPORT void OnRedirectReceived(Cronet_UrlRequestCallbackPtr self,
@@ -3,11 +3,97 @@
 // BSD-style license that can be found in the LICENSE file.
 
 #include "wrapper_utils.h"
+#include "memory_accounting.h"
+#include "trace_buffer.h"
+
+#include <atomic>
+#include <stdio.h>
+#include <string.h>
 
 std::unordered_map<Cronet_UrlRequestPtr, Dart_Port> requestNativePorts;
+// Requests are registered and dispatched from several threads.
+std::mutex requestNativePortsLock;
+
+static Dart_Port PortOf(Cronet_UrlRequestPtr request) {
+  std::lock_guard<std::mutex> lock(requestNativePortsLock);
+  auto it = requestNativePorts.find(request);
+  return it == requestNativePorts.end() ? ILLEGAL_PORT : it->second;
+}
 
 static void FreeFinalizer(void *, void *value) { free(value); }
 
+// Whether CallbackArgBuilder builds compact messages, see
+// UseCompactCallbacks.
+static std::atomic<bool> compactCallbacks{true};
+
+// Callbacks by their id in compact messages. Must match _callbackMethods on
+// the Dart side.
+static const char *const kCallbackMethods[] = {
+    "OnRedirectDenied", "OnResponseStarted", "OnReadCompleted",
+    "OnSucceeded",      "OnFailed",          "OnCanceled",
+    "OnRecordsRead",    "OnFramingError",    "OnSinkStarted",
+    "OnSinkProgress",   "OnSinkError",       "OnProgress",
+    "OnStuck",          "ReadFunc",          "RewindFunc",
+    "OnBodyError",
+};
+
+// Arguments of a compact message, at most kMaxCompactArgs of them after the
+// id of the callback. Built and posted right away by the same thread, and
+// copied by Dart_PostCObject.
+static const int kMaxCompactArgs = 15;
+static thread_local uint64_t compactArgs[kMaxCompactArgs + 1];
+
+static uint64_t MethodId(const char *methodname) {
+  const size_t count = sizeof(kCallbackMethods) / sizeof(kCallbackMethods[0]);
+  for (size_t i = 0; i < count; i++) {
+    if (strcmp(kCallbackMethods[i], methodname) == 0) {
+      return i;
+    }
+  }
+  fprintf(stderr, "No id for callback %s.\n", methodname);
+  abort();
+}
+
+// Compact messages are a single Uint8List, built by CallbackArgBuilder.
+static bool IsCompact(const Dart_CObject &args) {
+  return args.type == Dart_CObject_kTypedData;
+}
+
+void UseCompactCallbacks(bool compact) { compactCallbacks.store(compact); }
+
+// Arguments are preceded by their size in bytes, for the accounting.
+static void FreeArgsFinalizer(void *, void *value) {
+  uint64_t *block = static_cast<uint64_t *>(value);
+  MemoryAccounting::Freed(MEMORY_CALLBACK_ARGS,
+                          static_cast<int64_t>(sizeof(uint64_t) + block[0]));
+  free(block);
+}
+
+// Releases |args| if the message carrying them couldn't be posted.
+static void ReleaseArgs(Dart_CObject *args) {
+  if (args->type == Dart_CObject_kExternalTypedData) {
+    args->value.as_external_typed_data.callback(
+        nullptr, args->value.as_external_typed_data.peer);
+  }
+}
+
+char *CopyStringForDart(const char *string) {
+  size_t size = strlen(string) + 1;
+  char *copy = static_cast<char *>(malloc(size));
+  memcpy(copy, string, size);
+  MemoryAccounting::Allocated(MEMORY_STRINGS, static_cast<int64_t>(size));
+  return copy;
+}
+
+void FreeStringFromDart(char *string) {
+  if (string == nullptr) {
+    return;
+  }
+  MemoryAccounting::Freed(MEMORY_STRINGS,
+                          static_cast<int64_t>(strlen(string) + 1));
+  free(string);
+}
+
 // This sends the callback name and the associated data with it to the Dart
 // side via NativePort.
 //
@@ -15,10 +101,28 @@ static void FreeFinalizer(void *, void *value) { free(value); }
 // message[0] is the method name, which is a string.
 // message[1] contains all the data to pass to that method.
 //
+// Compact messages are a single Uint8List instead, the id of the callback in
+// kCallbackMethods followed by its arguments, 64 bits each. They are copied
+// into the Dart heap, without a string, an array nor a finalizer.
+//
 // Using this due to the lack of support for asynchronous callbacks in dart:ffi.
 // See Issue: https://github.com/dart-lang/sdk/issues/37022.
 void DispatchCallback(const char *methodname, Cronet_UrlRequestPtr request,
                       Dart_CObject args) {
+  DispatchCallbackToPort(methodname, PortOf(request), args);
+}
+
+// Same as DispatchCallback, for callbacks that may arrive once the request is
+// gone.
+void DispatchCallbackToPort(const char *methodname, Dart_Port port,
+                            Dart_CObject args) {
+  TRACE_EVENT(TRACE_POST, port, reinterpret_cast<uintptr_t>(methodname));
+  if (IsCompact(args)) {
+    reinterpret_cast<uint64_t *>(args.value.as_typed_data.values)[0] =
+        MethodId(methodname);
+    Dart_PostCObject_DL(port, &args);
+    return;
+  }
   Dart_CObject c_method_name;
   c_method_name.type = Dart_CObject_kString;
   c_method_name.value.as_string = const_cast<char *>(methodname);
@@ -31,18 +135,93 @@ void DispatchCallback(const char *methodname, Cronet_UrlRequestPtr request,
   c_request.value.as_array.length =
       sizeof(c_request_arr) / sizeof(c_request_arr[0]);
 
-  Dart_PostCObject_DL(requestNativePorts[request], &c_request);
+  if (!Dart_PostCObject_DL(port, &c_request)) {
+    ReleaseArgs(&args);
+  }
+}
+
+// Same as DispatchCallback, with |length| bytes of |data| as message[2], or
+// as message[1] after a compact message.
+//
+// Ownership of |data|, which must be allocated with malloc, is passed to the
+// Dart side. It is freed right away if the message can't be posted.
+bool DispatchCallbackWithData(const char *methodname,
+                              Cronet_UrlRequestPtr request, Dart_CObject args,
+                              uint8_t *data, int64_t length) {
+  Dart_Port port = PortOf(request);
+  TRACE_EVENT(TRACE_POST, port, reinterpret_cast<uintptr_t>(methodname));
+  Dart_CObject c_method_name;
+  c_method_name.type = Dart_CObject_kString;
+  c_method_name.value.as_string = const_cast<char *>(methodname);
+
+  Dart_CObject c_data;
+  if (data == nullptr) {
+    c_data.type = Dart_CObject_kTypedData;
+    c_data.value.as_typed_data.type = Dart_TypedData_kUint8;
+    c_data.value.as_typed_data.length = 0;
+    c_data.value.as_typed_data.values = nullptr;
+  } else {
+    c_data.type = Dart_CObject_kExternalTypedData;
+    c_data.value.as_external_typed_data.type = Dart_TypedData_kUint8;
+    c_data.value.as_external_typed_data.length = length;
+    c_data.value.as_external_typed_data.data = data;
+    c_data.value.as_external_typed_data.peer = data;
+    c_data.value.as_external_typed_data.callback = FreeFinalizer;
+  }
+
+  Dart_CObject *c_request_arr[] = {&c_method_name, &args, &c_data};
+  Dart_CObject c_request;
+
+  c_request.type = Dart_CObject_kArray;
+  c_request.value.as_array.values = c_request_arr;
+  c_request.value.as_array.length =
+      sizeof(c_request_arr) / sizeof(c_request_arr[0]);
+  if (IsCompact(args)) {
+    reinterpret_cast<uint64_t *>(args.value.as_typed_data.values)[0] =
+        MethodId(methodname);
+    c_request_arr[0] = &args;
+    c_request_arr[1] = &c_data;
+    c_request.value.as_array.length = 2;
+  }
+
+  if (!Dart_PostCObject_DL(port, &c_request)) {
+    ReleaseArgs(&args);
+    free(data);
+    return false;
+  }
+  return true;
 }
 
 // Builds the arguments to pass to the Dart side as a parameter to the
 // callbacks. [num] is the number of arguments to be passed and rest are the
 // arguments.
+//
+// Compact arguments live in a buffer of the calling thread until the next
+// call, they must be dispatched right away.
 Dart_CObject CallbackArgBuilder(int num, ...) {
   Dart_CObject c_request_data;
   va_list valist;
   va_start(valist, num);
-  void *request_buffer = malloc(sizeof(uint64_t) * num);
-  uint64_t *buf = reinterpret_cast<uint64_t *>(request_buffer);
+  if (num <= kMaxCompactArgs &&
+      compactCallbacks.load(std::memory_order_relaxed)) {
+    uint64_t *words = compactArgs;
+    for (int i = 0; i < num; i++) {
+      words[i + 1] = va_arg(valist, uintptr_t);
+    }
+    va_end(valist);
+    c_request_data.type = Dart_CObject_kTypedData;
+    c_request_data.value.as_typed_data.type = Dart_TypedData_kUint8;
+    c_request_data.value.as_typed_data.length = sizeof(uint64_t) * (num + 1);
+    c_request_data.value.as_typed_data.values =
+        reinterpret_cast<uint8_t *>(words);
+    return c_request_data;
+  }
+  uint64_t size = sizeof(uint64_t) * num;
+  uint64_t *block = static_cast<uint64_t *>(malloc(sizeof(uint64_t) + size));
+  block[0] = size;
+  MemoryAccounting::Allocated(MEMORY_CALLBACK_ARGS,
+                              static_cast<int64_t>(sizeof(uint64_t) + size));
+  uint64_t *buf = block + 1;
 
   // uintptr_r will get implicitly casted to uint64_t. So, when the code is
   // executed in 32 bit mode, the upper 32 bit of buf[i] will be 0 extended
@@ -54,11 +233,11 @@ Dart_CObject CallbackArgBuilder(int num, ...) {
 
   c_request_data.type = Dart_CObject_kExternalTypedData;
   c_request_data.value.as_external_typed_data.type = Dart_TypedData_kUint8;
-  c_request_data.value.as_external_typed_data.length = sizeof(uint64_t) * num;
+  c_request_data.value.as_external_typed_data.length = size;
   c_request_data.value.as_external_typed_data.data =
-      static_cast<uint8_t *>(request_buffer);
-  c_request_data.value.as_external_typed_data.peer = request_buffer;
-  c_request_data.value.as_external_typed_data.callback = FreeFinalizer;
+      reinterpret_cast<uint8_t *>(buf);
+  c_request_data.value.as_external_typed_data.peer = block;
+  c_request_data.value.as_external_typed_data.callback = FreeArgsFinalizer;
 
   va_end(valist);
 
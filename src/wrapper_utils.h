@@ -10,11 +10,35 @@
 #include "../third_party/dart-sdk/dart_native_api.h"
 #include "../third_party/dart-sdk/dart_tools_api.h"
 #include <stdarg.h>
+#include <mutex>
 #include <stdlib.h>
 #include <unordered_map>
 
+// |methodname| must be a string literal, traces keep a pointer to it.
 void DispatchCallback(const char *methodname, Cronet_UrlRequestPtr request,
                       Dart_CObject args);
+void DispatchCallbackToPort(const char *methodname, Dart_Port port,
+                            Dart_CObject args);
+bool DispatchCallbackWithData(const char *methodname,
+                              Cronet_UrlRequestPtr request, Dart_CObject args,
+                              uint8_t *data, int64_t length);
 Dart_CObject CallbackArgBuilder(int num, ...);
+// Whether callbacks are posted as compact messages, which they are by
+// default, or as arrays holding their name and arguments.
+void UseCompactCallbacks(bool compact);
+
+// Copies |string| for the Dart side, which hands it back to
+// FreeStringFromDart once done with it.
+char *CopyStringForDart(const char *string);
+void FreeStringFromDart(char *string);
+
+// Lengths are sent as two arguments, as arguments are pointer sized.
+inline uintptr_t Low32(int64_t value) {
+  return static_cast<uintptr_t>(static_cast<uint64_t>(value) & 0xffffffff);
+}
+
+inline uintptr_t High32(int64_t value) {
+  return static_cast<uintptr_t>(static_cast<uint64_t>(value) >> 32);
+}
 
 #endif // WRAPPER_UTILS_H_
@@ -0,0 +1,104 @@
+// Copyright (c) 2021, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+import 'dart:convert';
+import 'dart:io' as io;
+import 'dart:typed_data';
+
+import 'package:cronet/cronet.dart';
+import 'package:test/test.dart';
+
+const host = 'localhost';
+const objectLength = 3 * 1024 * 1024 + 17;
+
+void main() {
+  group('Download', () {
+    late HttpClient client;
+    late io.HttpServer server;
+    late int port;
+    late io.Directory directory;
+    final object = Uint8List.fromList(
+        List.generate(objectLength, (i) => (i * 31 + (i >> 12)) & 0xff));
+    var served = 0;
+    setUp(() async {
+      client = HttpClient();
+      directory = await io.Directory.systemTemp.createTemp('download_test');
+      served = 0;
+      server = await io.HttpServer.bind(io.InternetAddress.anyIPv6, 0);
+      port = server.port;
+      server.listen((io.HttpRequest request) {
+        final response = request.response;
+        response.headers
+          ..set('Accept-Ranges', 'bytes')
+          ..set('ETag', '"v1"');
+        final range = RegExp(r'bytes=(\d+)-(\d+)')
+            .firstMatch(request.headers.value('Range') ?? '');
+        if (request.uri.path == '/ranged' && range != null) {
+          final start = int.parse(range.group(1)!);
+          final end = int.parse(range.group(2)!) + 1;
+          response
+            ..statusCode = 206
+            ..headers
+                .set('Content-Range', 'bytes $start-${end - 1}/$objectLength')
+            ..contentLength = end - start
+            ..add(Uint8List.sublistView(object, start, end));
+          served += end - start;
+        } else {
+          response
+            ..contentLength = objectLength
+            ..add(object);
+          served += objectLength;
+        }
+        response.close();
+      });
+    });
+
+    test('Downloads an object in parallel ranges', () async {
+      final path = '${directory.path}/object';
+      final result = await client.download(
+          Uri.parse('http://$host:$port/ranged'), path,
+          minRangeSize: 256 * 1024);
+      expect(result.length, equals(objectLength));
+      expect(result.ranges, equals(4));
+      expect(await io.File(path).readAsBytes(), equals(object));
+      expect(io.File('$path.download').existsSync(), isFalse);
+    });
+
+    test('Resumes a download from its checkpoint', () async {
+      final path = '${directory.path}/object';
+      const half = objectLength ~/ 2;
+      final url = 'http://$host:$port/ranged';
+      // The first range is complete, the second one hasn't started.
+      await io.File(path).writeAsBytes(
+          [...object.sublist(0, half), ...List.filled(objectLength - half, 0)]);
+      await io.File('$path.download').writeAsString(jsonEncode({
+        'url': url,
+        'length': objectLength,
+        'validator': '"v1"',
+        'ranges': [
+          [0, half, half],
+          [half, objectLength, 0]
+        ],
+      }));
+      final result = await client.download(Uri.parse(url), path);
+      expect(result.resumed, equals(half));
+      expect(served, equals(objectLength - half));
+      expect(await io.File(path).readAsBytes(), equals(object));
+    });
+
+    test('Downloads in a single response without ranges', () async {
+      final path = '${directory.path}/object';
+      final result =
+          await client.download(Uri.parse('http://$host:$port/plain'), path);
+      expect(result.ranges, equals(0));
+      expect(await io.File(path).readAsBytes(), equals(object));
+    });
+
+    tearDown(() {
+      client.close();
+      server.close();
+      directory.deleteSync(recursive: true);
+    });
+  });
+}
@@ -21,6 +21,15 @@ void main() {
       server = await io.HttpServer.bind(io.InternetAddress.anyIPv6, 0);
       port = server.port;
       server.listen((io.HttpRequest request) async {
+        if (request.headers.value('Content-Encoding') == 'gzip') {
+          // Echoes the decompressed body.
+          await request.cast<List<int>>().transform(io.gzip.decoder).forEach(
+              (data) => request.response.add(data));
+          request.response.close();
+          return;
+        }
+        request.response.headers.set(
+            'Echo-Content-Type', request.headers.value('Content-Type') ?? '');
         await request.forEach((data) {
           request.response.add(data);
         });
@@ -37,6 +46,68 @@ void main() {
       expect(dataStream, emitsInOrder(<Matcher>[equals(sentData), emitsDone]));
     });
 
+    test('Sends a body several upload buffers long', () async {
+      // Cronet reads the body 32 KiB at a time.
+      final body =
+          List.generate(100 * 1024 + 7, (i) => (i * 31 + i ~/ 251) % 256);
+      final request = await client.postUrl(Uri.parse('http://$host:$port/'));
+      request.add(body);
+      final resp = await request.close();
+      final echoed = await resp.fold<List<int>>(
+          <int>[], (previous, element) => previous..addAll(element));
+      expect(echoed, equals(body));
+    });
+
+    test('Compresses the request body with gzip', () async {
+      final body = List.filled(1000, '{"event":"tap"}').join('\n');
+      final request = await client.postUrl(Uri.parse('http://$host:$port/'))
+        ..uploadCompression = UploadCompression.gzip;
+      request.write(body);
+      final resp = await request.close();
+      expect(await resp.transform(utf8.decoder).join(), equals(body));
+    });
+
+    test('Sends a multipart body with a file part', () async {
+      final dir = io.Directory.systemTemp.createTempSync('cronet_multipart');
+      final file = io.File('${dir.path}/notes.txt')
+        ..writeAsStringSync('0123456789' * 10000);
+      final request = await client.postUrl(Uri.parse('http://$host:$port/'))
+        ..multipart = [
+          MultipartPart.field('title', 'Notes'),
+          MultipartPart.file('file', file.path,
+              contentType: 'text/plain', offset: 5),
+        ];
+      final resp = await request.close();
+      final body = await resp.transform(utf8.decoder).join();
+      final boundary = resp.headers
+          .value('Echo-Content-Type')!
+          .split('boundary=')
+          .last;
+      expect(
+          body,
+          equals('--$boundary\r\n'
+              'Content-Disposition: form-data; name="title"\r\n\r\n'
+              'Notes\r\n'
+              '--$boundary\r\n'
+              'Content-Disposition: form-data; name="file"; '
+              'filename="notes.txt"\r\n'
+              'Content-Type: text/plain\r\n\r\n'
+              '${('0123456789' * 10000).substring(5)}\r\n'
+              '--$boundary--\r\n'));
+      dir.deleteSync(recursive: true);
+    });
+
+    test('Refuses a multipart content type with a line break', () {
+      expect(
+          () => MultipartPart.bytes('file', [1],
+              contentType: 'text/plain\r\nX-Injected: 1'),
+          throwsArgumentError);
+      expect(
+          () => MultipartPart.file('file', 'notes.txt',
+              contentType: 'text/plain\n--boundary'),
+          throwsArgumentError);
+    });
+
     test('Mutating request body after request.close throws error', () async {
       final request = await client.getUrl(Uri.parse('http://$host:$port/'));
       await request.close();
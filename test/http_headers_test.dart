@@ -34,6 +34,25 @@ void main() {
       expect(dataStream, emitsInOrder(<Matcher>[equals(sentData), emitsDone]));
     });
 
+    test('Setting a header again replaces its value', () async {
+      final request = await client.getUrl(Uri.parse('http://$host:$port/'));
+      request.headers.set('test-header', 'stale');
+      request.headers.set('Test-Header', sentData);
+      final resp = await request.close();
+      final dataStream = resp.transform(utf8.decoder);
+      expect(dataStream, emitsInOrder(<Matcher>[equals(sentData), emitsDone]));
+    });
+
+    test('Refuses headers containing NUL', () async {
+      final request = await client.getUrl(Uri.parse('http://$host:$port/'));
+      expect(() => request.headers.set('test\u0000header', sentData),
+          throwsArgumentError);
+      expect(() => request.headers.set('test-header', 'a\u0000b'),
+          throwsArgumentError);
+      final resp = await request.close();
+      await resp.drain<void>();
+    });
+
     test('Mutating headers after request.close throws error', () async {
       final request = await client.getUrl(Uri.parse('http://$host:$port/'));
       await request.close();
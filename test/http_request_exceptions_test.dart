@@ -38,6 +38,22 @@ void main() {
           emitsInOrder(<Matcher>[emitsError(isA<HttpException>()), emitsDone]));
     });
 
+    test('Retries a refused connection and reports the last error', () async {
+      final request =
+          await client.openUrl('GET', Uri.parse('http://$host:$port'));
+      request.retryPolicy =
+          const RetryPolicy(initialBackoff: Duration(milliseconds: 10));
+      final resp = await request.close();
+      expect(
+          resp,
+          emitsInOrder(<Matcher>[
+            emitsError(isA<NetworkException>()
+                .having((e) => e.error, 'error', NetworkError.connectionRefused)
+                .having((e) => e.attempts, 'attempts', 3)),
+            emitsDone
+          ]));
+    });
+
     test('The scheme is wrong', () async {
       final request =
           await client.openUrl('GET', Uri.parse('nonExistent://$host:$port'));
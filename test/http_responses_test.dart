@@ -2,8 +2,10 @@
 // for details. All rights reserved. Use of this source code is governed by a
 // BSD-style license that can be found in the LICENSE file.
 
+import 'dart:async';
 import 'dart:convert';
 import 'dart:io' as io;
+import 'dart:isolate';
 
 import 'package:cronet/cronet.dart';
 import 'package:test/test.dart';
@@ -11,11 +13,22 @@ import 'package:test/test.dart';
 const host = 'localhost';
 const sentData = 'Hello, world!';
 
+/// Fetches a URL with a client sharing the engine of another isolate.
+Future<void> _fetchWithSharedEngine(List<Object> message) async {
+  final reply = message[0] as SendPort;
+  final client = HttpClient.shared(message[1] as SharedEngine);
+  final request = await client.getUrl(message[2] as Uri);
+  final response = await request.close();
+  reply.send(await response.transform(utf8.decoder).join());
+  client.close();
+}
+
 void main() {
   group('Server Responses', () {
     late HttpClient client;
     late io.HttpServer server;
     late int port;
+    var hedgedHits = 0;
     setUp(() async {
       client = HttpClient();
       server = await io.HttpServer.bind(io.InternetAddress.anyIPv6, 0);
@@ -26,6 +39,33 @@ void main() {
         } else if (request.uri.path == '/301') {
           request.response.headers.add('Location', '/');
           request.response.statusCode = 301;
+        } else if (request.uri.path == '/ndjson') {
+          request.response.write('{"a":1}\r\n\n{"b":2}\n{"c":3}');
+        } else if (request.uri.path == '/events') {
+          request.response.write('data: one\n\nevent: x\ndata: two\n\n');
+        } else if (request.uri.path == '/cross-origin') {
+          request.response.headers.add('Location', 'http://127.0.0.1:$port/');
+          request.response.statusCode = 302;
+        } else if (request.uri.path == '/hedged') {
+          // Only the first request is slow.
+          if (hedgedHits++ == 0) {
+            Future.delayed(const Duration(seconds: 2), () {
+              request.response.write(sentData);
+              request.response.close();
+            });
+            return;
+          }
+          request.response.write(sentData);
+        } else if (request.uri.path == '/stall') {
+          Future.delayed(
+              const Duration(seconds: 2), () => request.response.close());
+          return;
+        } else if (request.uri.path == '/stall-body') {
+          request.response.write(sentData);
+          request.response.flush();
+          Future.delayed(
+              const Duration(seconds: 2), () => request.response.close());
+          return;
         } else {
           request.response.write(sentData);
         }
@@ -116,6 +156,315 @@ void main() {
       expect(dataStream, emitsInOrder(<Matcher>[emitsDone]));
     });
 
+    test('Lists the followed redirects on the response', () async {
+      final request = await client.getUrl(Uri.parse('http://$host:$port/301'));
+      final resp = await request.close();
+      await resp.drain<void>();
+      expect(resp.redirects.length, equals(1));
+      expect(resp.redirects.single.statusCode, equals(301));
+      expect(resp.redirects.single.location.path, equals('/'));
+    });
+
+    test('Cross origin redirect is denied if same origin only', () async {
+      final request =
+          await client.getUrl(Uri.parse('http://$host:$port/cross-origin'));
+      request.redirectPolicy = const RedirectPolicy(sameOriginOnly: true);
+      final resp = await request.close();
+      expect(
+          resp,
+          emitsInOrder(
+              <Matcher>[emitsError(isA<RedirectException>()), emitsDone]));
+    });
+
+    test('Credentials are not redirected to another origin', () async {
+      final request =
+          await client.getUrl(Uri.parse('http://$host:$port/cross-origin'));
+      request.headers.set('Authorization', 'Basic dXNlcjpwYXNz');
+      final resp = await request.close();
+      expect(
+          resp,
+          emitsInOrder(
+              <Matcher>[emitsError(isA<RedirectException>()), emitsDone]));
+    });
+
+    test('Reads the whole response body with readAsBytes', () async {
+      final request = await client.getUrl(Uri.parse('http://$host:$port/301'));
+      final body = await request.readAsBytes();
+      expect(utf8.decode(body), equals(sentData));
+    });
+
+    test('Frames a NDJSON response into lines', () async {
+      final request =
+          await client.getUrl(Uri.parse('http://$host:$port/ndjson'));
+      request.framing = RecordFraming.ndjson;
+      final resp = await request.close();
+      expect(
+          resp.transform(utf8.decoder),
+          emitsInOrder(<Matcher>[
+            equals('{"a":1}'),
+            equals('{"b":2}'),
+            equals('{"c":3}'),
+            emitsDone
+          ]));
+    });
+
+    test('Frames a Server-Sent Events response into events', () async {
+      final request =
+          await client.getUrl(Uri.parse('http://$host:$port/events'));
+      request.framing = RecordFraming.serverSentEvents;
+      final resp = await request.close();
+      expect(
+          resp.transform(utf8.decoder),
+          emitsInOrder(<Matcher>[
+            equals('data: one'),
+            equals('event: x\ndata: two'),
+            emitsDone
+          ]));
+    });
+
+    test('Fails with a TimeoutException once the headers are late', () async {
+      final request = await client.getUrl(Uri.parse('http://$host:$port/stall'))
+        ..connectTimeout = const Duration(milliseconds: 200);
+      final resp = await request.close();
+      expect(resp, emitsError(isA<TimeoutException>()));
+    });
+
+    test('Fails with a TimeoutException once the body stalls', () async {
+      final request =
+          await client.getUrl(Uri.parse('http://$host:$port/stall-body'))
+            ..readTimeout = const Duration(milliseconds: 200);
+      final resp = await request.close();
+      expect(
+          resp.transform(utf8.decoder),
+          emitsInOrder(<Matcher>[
+            equals(sentData),
+            emitsError(isA<TimeoutException>())
+          ]));
+    });
+
+    test('Deadlines that do not expire have no effect', () async {
+      final request = await client.getUrl(Uri.parse('http://$host:$port'))
+        ..connectTimeout = const Duration(seconds: 10)
+        ..readTimeout = const Duration(seconds: 10)
+        ..totalTimeout = const Duration(seconds: 10);
+      final resp = await request.close();
+      expect(resp.transform(utf8.decoder),
+          emitsInOrder(<Matcher>[equals(sentData), emitsDone]));
+    });
+
+    test('Reports the progress of a slow response natively', () async {
+      final progress = <TransferProgress>[];
+      final request =
+          await client.getUrl(Uri.parse('http://$host:$port/stall-body'))
+            ..onProgress = progress.add
+            ..progressInterval = const Duration(milliseconds: 50);
+      final body = await request.readAsBytes();
+      expect(utf8.decode(body), equals(sentData));
+      expect(progress, isNotEmpty);
+      expect(
+          progress.any((p) =>
+              p.state == LoadState.readingResponse &&
+              p.bytesReceived == sentData.length),
+          isTrue);
+    });
+
+    test('Tracks live requests and flags a stuck one natively', () async {
+      final stuck = Completer<LiveRequest>();
+      final watched = HttpClient(
+          stuckRequestThreshold: const Duration(milliseconds: 300),
+          onStuckRequest: stuck.complete);
+      final url = Uri.parse('http://$host:$port/stall-body');
+      final request = await watched.getUrl(url);
+      final resp = await request.close();
+      final body = resp.transform(utf8.decoder).join();
+      final flagged = await stuck.future;
+      expect(flagged.url, equals(url));
+      expect(flagged.stuck, isTrue);
+      expect(flagged.bytesReceived, equals(sentData.length));
+      expect(flagged.idle,
+          greaterThanOrEqualTo(const Duration(milliseconds: 300)));
+      final live = watched.liveRequests;
+      expect(live, hasLength(1));
+      expect(live.single.url, equals(url));
+      expect(live.single.stuck, isTrue);
+      expect(await body, equals(sentData));
+      expect(watched.liveRequests, isEmpty);
+      watched.close();
+    });
+
+    test('Traces the lifecycle of a request', () async {
+      RequestTrace.clear();
+      RequestTrace.enabled = true;
+      final request = await client.getUrl(Uri.parse('http://$host:$port'));
+      final resp = await request.close();
+      await resp.drain<void>();
+      RequestTrace.enabled = false;
+      final trace = jsonDecode(RequestTrace.export()) as Map<String, dynamic>;
+      final events = (trace['traceEvents'] as List).cast<Map>();
+      final names = events.map((event) => event['name']).toList();
+      expect(names.first, equals('request'));
+      expect(events.first['ph'], equals('b'));
+      expect(
+          names,
+          containsAllInOrder(<String>[
+            'started',
+            'response-started',
+            'post',
+            'dart-handled',
+            'read',
+          ]));
+      final end = events.singleWhere((event) => event['ph'] == 'e');
+      expect(end['args']['outcome'], equals('succeeded'));
+      expect(events.map((event) => event['id']).toSet(), hasLength(1));
+      RequestTrace.clear();
+      expect(
+          (jsonDecode(RequestTrace.export())['traceEvents'] as List), isEmpty);
+    });
+
+    test('Shares an engine with another isolate', () async {
+      final reply = ReceivePort();
+      final engine = client.shareEngine();
+      await Isolate.spawn(_fetchWithSharedEngine,
+          [reply.sendPort, engine, Uri.parse('http://$host:$port')]);
+      // The engine outlives the client that created it.
+      client.close();
+      expect(await reply.first, equals(sentData));
+      expect(engine.protocol, equals(client.protocol));
+    });
+
+    test('Can only use a shared engine once', () {
+      final engine = client.shareEngine();
+      engine.release();
+      expect(engine.release, throwsStateError);
+      expect(() => HttpClient.shared(engine), throwsStateError);
+    });
+
+    test('Can only use a shared engine sent to another isolate once',
+        () async {
+      final reply = ReceivePort();
+      final engine = client.shareEngine();
+      await Isolate.spawn(_fetchWithSharedEngine,
+          [reply.sendPort, engine, Uri.parse('http://$host:$port')]);
+      expect(await reply.first, equals(sentData));
+      // The copy kept by this isolate was used by the other one.
+      expect(engine.release, throwsStateError);
+      expect(() => HttpClient.shared(engine), throwsStateError);
+    });
+
+    test('Delivers callbacks with either backend', () async {
+      for (final backend in CallbackBackend.values) {
+        callbackBackend = backend;
+        final request = await client.getUrl(Uri.parse('http://$host:$port'));
+        final resp = await request.close();
+        expect(await resp.transform(utf8.decoder).join(), equals(sentData));
+      }
+      callbackBackend = CallbackBackend.compact;
+    });
+
+    test('Accounts for the native memory of a request', () async {
+      final before = NativeMemoryStats.read();
+      final alerts = <int>[];
+      NativeMemoryStats.setAlert(before.liveBytes + 1, alerts.add);
+      final request = await client.getUrl(Uri.parse('http://$host:$port'));
+      final resp = await request.close();
+      final during = NativeMemoryStats.read();
+      expect(during.liveBytes, greaterThan(before.liveBytes));
+      expect(during.executorThreads, greaterThan(before.executorThreads));
+      await resp.drain<void>();
+      await Future<void>.delayed(Duration.zero);
+      NativeMemoryStats.setAlert(0, null);
+      expect(alerts, isNotEmpty);
+      final after = NativeMemoryStats.read();
+      final buffers = after.categories[NativeMemoryCategory.cronetBuffers]!;
+      expect(buffers.peakBytes, greaterThanOrEqualTo(32 * 1024));
+      expect(after.peakBytes, greaterThanOrEqualTo(during.liveBytes));
+    });
+
+    test('Hedges a request whose response is slow to start', () async {
+      hedgedHits = 0;
+      final request =
+          await client.getUrl(Uri.parse('http://$host:$port/hedged'))
+            ..hedging = const HedgingPolicy(delay: Duration(milliseconds: 100));
+      final stopwatch = Stopwatch()..start();
+      final body = await request.readAsBytes();
+      expect(utf8.decode(body), equals(sentData));
+      expect(stopwatch.elapsed, lessThan(const Duration(seconds: 2)));
+      expect(hedgedHits, equals(2));
+    });
+
+    test('Queues requests beyond the per host limit', () async {
+      final limited = HttpClient(maxConcurrentRequestsPerHost: 1);
+      final requests = [
+        for (var i = 0; i < 3; i++)
+          await limited.getUrl(Uri.parse('http://$host:$port'))
+      ];
+      final responses = await limited.closeAll(requests);
+      expect(limited.admissionStats.running, equals(1));
+      expect(limited.admissionStats.queued, equals(2));
+      for (final response in responses) {
+        expect(await response.transform(utf8.decoder).join(), equals(sentData));
+      }
+      final stats = limited.admissionStats;
+      expect(stats.admitted, equals(3));
+      expect(stats.waited, equals(2));
+      expect(stats.running, equals(0));
+      limited.close();
+    });
+
+    test('Only hedges a request if the per host limit allows', () async {
+      const policy = HedgingPolicy(delay: Duration(milliseconds: 100));
+      final limited = HttpClient(maxConcurrentRequestsPerHost: 1);
+      hedgedHits = 0;
+      final request =
+          await limited.getUrl(Uri.parse('http://$host:$port/hedged'))
+            ..hedging = policy;
+      final body = await request.readAsBytes();
+      expect(utf8.decode(body), equals(sentData));
+      expect(hedgedHits, equals(1));
+      expect(limited.admissionStats.admitted, equals(1));
+      expect(limited.admissionStats.running, equals(0));
+      limited.close();
+
+      final roomy = HttpClient(maxConcurrentRequestsPerHost: 2);
+      hedgedHits = 0;
+      final hedged = await roomy.getUrl(Uri.parse('http://$host:$port/hedged'))
+        ..hedging = policy;
+      await hedged.readAsBytes();
+      expect(hedgedHits, equals(2));
+      // The duplicate is admitted as well.
+      expect(roomy.admissionStats.admitted, equals(2));
+      // Once the cancelled request is done as well.
+      await Future<void>.delayed(const Duration(milliseconds: 500));
+      expect(roomy.admissionStats.running, equals(0));
+      roomy.close();
+    });
+
+    test('Only starts a request once', () async {
+      final request = await client.getUrl(Uri.parse('http://$host:$port'));
+      final response = request.close();
+      expect(identical(request.close(), response), isTrue);
+      expect(identical(request.done, response), isTrue);
+      expect(client.closeAll([request]), throwsStateError);
+      expect(await (await response).transform(utf8.decoder).join(),
+          equals(sentData));
+      final batched = await client.getUrl(Uri.parse('http://$host:$port'));
+      final responses = await client.closeAll([batched]);
+      expect(await batched.done, same(responses.single));
+    });
+
+    test('Starts many requests at once using closeAll', () async {
+      final requests = await Future.wait(List.generate(
+          10, (i) => client.getUrl(Uri.parse('http://$host:$port/$i'))));
+      requests.first.priority = RequestPriority.highest;
+      final responses = await client.closeAll(requests);
+      expect(responses.length, equals(requests.length));
+      for (final resp in responses) {
+        final dataStream = resp.transform(utf8.decoder);
+        expect(
+            dataStream, emitsInOrder(<Matcher>[equals(sentData), emitsDone]));
+      }
+    });
+
     tearDown(() {
       client.close();
       server.close();